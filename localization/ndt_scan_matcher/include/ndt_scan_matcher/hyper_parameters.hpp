@@ -49,6 +49,7 @@ struct HyperParameters
   {
     int64_t particles_num;
     int64_t n_startup_trials;
+    int64_t particles_batch_size;
   } initial_pose_estimation;
 
   struct Validation
@@ -87,6 +88,8 @@ struct HyperParameters
     double update_distance;
     double map_radius;
     double lidar_radius;
+    int64_t cell_cache_size;
+    double prefetch_time_horizon;
   } dynamic_map_loading;
 
 public:
@@ -113,6 +116,10 @@ public:
       node->declare_parameter<int64_t>("initial_pose_estimation.particles_num");
     initial_pose_estimation.n_startup_trials =
       node->declare_parameter<int64_t>("initial_pose_estimation.n_startup_trials");
+    initial_pose_estimation.particles_batch_size =
+      node->declare_parameter<int64_t>("initial_pose_estimation.particles_batch_size");
+    initial_pose_estimation.particles_batch_size =
+      std::max(initial_pose_estimation.particles_batch_size, static_cast<int64_t>(1));
 
     validation.lidar_topic_timeout_sec =
       node->declare_parameter<double>("validation.lidar_topic_timeout_sec");
@@ -175,6 +182,17 @@ public:
       node->declare_parameter<double>("dynamic_map_loading.map_radius");
     dynamic_map_loading.lidar_radius =
       node->declare_parameter<double>("dynamic_map_loading.lidar_radius");
+    dynamic_map_loading.cell_cache_size =
+      node->declare_parameter<int64_t>("dynamic_map_loading.cell_cache_size");
+    dynamic_map_loading.prefetch_time_horizon =
+      node->declare_parameter<double>("dynamic_map_loading.prefetch_time_horizon");
+    if (
+      dynamic_map_loading.prefetch_time_horizon > 0.0 && dynamic_map_loading.cell_cache_size <= 0) {
+      RCLCPP_WARN(
+        node->get_logger(),
+        "Map prefetching needs the cell cache. Set dynamic_map_loading.cell_cache_size to enable "
+        "it.");
+    }
   }
 };
 
@@ -0,0 +1,88 @@
+// Copyright 2024 Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NDT_SCAN_MATCHER__MAP_CELL_CACHE_HPP_
+#define NDT_SCAN_MATCHER__MAP_CELL_CACHE_HPP_
+
+#include <pcl/point_cloud.h>
+#include <pcl/point_types.h>
+
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Bounded LRU of decoded point cloud map cells, keyed by cell ID.
+// It is filled both by the map updates and by the prefetch requests, which run on different
+// threads, so every method takes the internal lock.
+class MapCellCache
+{
+public:
+  using CellConstPtr = pcl::PointCloud<pcl::PointXYZ>::ConstPtr;
+
+  explicit MapCellCache(const size_t capacity) : capacity_(capacity) {}
+
+  // Insert the cell, or mark it as the most recently used one if it is already cached.
+  // The least recently used cells are dropped when the capacity is exceeded.
+  void put(const std::string & id, const CellConstPtr & cell)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = index_.find(id);
+    if (it != index_.end()) {
+      it->second->second = cell;
+      cells_.splice(cells_.begin(), cells_, it->second);
+      return;
+    }
+    cells_.emplace_front(id, cell);
+    index_.emplace(id, cells_.begin());
+    while (cells_.size() > capacity_) {
+      index_.erase(cells_.back().first);
+      cells_.pop_back();
+    }
+  }
+
+  [[nodiscard]] bool contains(const std::string & id) const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return index_.count(id) > 0;
+  }
+
+  // The returned cells stay valid even if they are evicted afterwards
+  [[nodiscard]] std::vector<std::pair<std::string, CellConstPtr>> snapshot() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return {cells_.begin(), cells_.end()};
+  }
+
+  [[nodiscard]] size_t size() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return cells_.size();
+  }
+
+  [[nodiscard]] size_t capacity() const { return capacity_; }
+
+private:
+  using CellList = std::list<std::pair<std::string, CellConstPtr>>;
+
+  const size_t capacity_;
+  mutable std::mutex mutex_;
+  // Ordered from the most recently used cell to the least recently used one
+  CellList cells_;
+  std::unordered_map<std::string, CellList::iterator> index_;
+};
+
+#endif  // NDT_SCAN_MATCHER__MAP_CELL_CACHE_HPP_
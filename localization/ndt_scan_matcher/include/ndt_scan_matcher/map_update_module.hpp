@@ -17,6 +17,7 @@
 
 #include "localization_util/util_func.hpp"
 #include "ndt_scan_matcher/hyper_parameters.hpp"
+#include "ndt_scan_matcher/map_cell_cache.hpp"
 #include "ndt_scan_matcher/particle.hpp"
 
 #include <rclcpp/rclcpp.hpp>
@@ -26,12 +27,16 @@
 #include <autoware_map_msgs/srv/get_differential_point_cloud_map.hpp>
 #include <geometry_msgs/msg/pose_with_covariance_stamped.hpp>
 #include <nav_msgs/msg/odometry.hpp>
+#include <tier4_debug_msgs/msg/float32_stamped.hpp>
+#include <tier4_debug_msgs/msg/int32_stamped.hpp>
 #include <visualization_msgs/msg/marker_array.hpp>
 
 #include <fmt/format.h>
 #include <multigrid_pclomp/multigrid_ndt_omp.h>
 #include <pcl_conversions/pcl_conversions.h>
 
+#include <atomic>
+#include <chrono>
 #include <map>
 #include <memory>
 #include <optional>
@@ -51,16 +56,40 @@ public:
     rclcpp::Node * node, std::mutex * ndt_ptr_mutex, NdtPtrType & ndt_ptr,
     HyperParameters::DynamicMapLoading param);
 
+  void update_map(const geometry_msgs::msg::Point & position);
+  [[nodiscard]] bool should_update_map(const geometry_msgs::msg::Point & position);
+  // Request the cells around the position expected after prefetch_time_horizon in the background
+  // and keep them in the cell cache. Meant to be called periodically with the latest position.
+  void prefetch_map(const geometry_msgs::msg::Point & position, const rclcpp::Time & stamp);
+  [[nodiscard]] bool is_prefetching() const { return prefetch_in_flight_; }
+
 private:
   friend class NDTScanMatcher;
 
+  struct UpdateStats
+  {
+    double update_time_ms{0.0};
+    double lock_time_ms{0.0};
+    size_t loaded_bytes{0};
+    // Cells added to the NDT from the cell cache / from the map loader response
+    size_t cache_hit_num{0};
+    size_t cache_miss_num{0};
+  };
+
   // Update the specified NDT
-  bool update_ndt(const geometry_msgs::msg::Point & position, NdtType & ndt);
-  void update_map(const geometry_msgs::msg::Point & position);
-  [[nodiscard]] bool should_update_map(const geometry_msgs::msg::Point & position);
+  bool update_ndt(const geometry_msgs::msg::Point & position, NdtType & ndt, UpdateStats & stats);
+  void on_prefetch_response(
+    const autoware_map_msgs::srv::GetDifferentialPointCloudMap::Response & response);
   void publish_partial_pcd_map();
+  void publish_update_stats(const UpdateStats & stats);
+  static bool has_same_map_ids(NdtType & ndt, std::vector<std::string> map_ids);
+  static double elapsed_ms(const std::chrono::system_clock::time_point & start_time);
 
   rclcpp::Publisher<sensor_msgs::msg::PointCloud2>::SharedPtr loaded_pcd_pub_;
+  rclcpp::Publisher<tier4_debug_msgs::msg::Float32Stamped>::SharedPtr update_time_pub_;
+  rclcpp::Publisher<tier4_debug_msgs::msg::Float32Stamped>::SharedPtr lock_time_pub_;
+  rclcpp::Publisher<tier4_debug_msgs::msg::Int32Stamped>::SharedPtr loaded_bytes_pub_;
+  rclcpp::Publisher<tier4_debug_msgs::msg::Int32Stamped>::SharedPtr cache_miss_num_pub_;
 
   rclcpp::Client<autoware_map_msgs::srv::GetDifferentialPointCloudMap>::SharedPtr
     pcd_loader_client_;
@@ -74,9 +103,17 @@ private:
 
   HyperParameters::DynamicMapLoading param_;
 
-  // Indicate if there is a prefetch thread waiting for being collected
+  // Double buffer of ndt_ptr_. It is updated without the lock and then swapped with ndt_ptr_.
   NdtPtrType secondary_ndt_ptr_;
   bool need_rebuild_;
+
+  // Decoded cells shared by both NDTs and filled ahead of time by prefetch_map (null if disabled)
+  std::unique_ptr<MapCellCache> cell_cache_;
+  std::atomic<bool> prefetch_in_flight_{false};
+  // The velocity used for the prediction is estimated from the positions of successive calls
+  std::optional<geometry_msgs::msg::Point> last_prefetch_call_position_ = std::nullopt;
+  rclcpp::Time last_prefetch_call_stamp_;
+  std::optional<geometry_msgs::msg::Point> last_prefetch_position_ = std::nullopt;
 };
 
 #endif  // NDT_SCAN_MATCHER__MAP_UPDATE_MODULE_HPP_
@@ -94,11 +94,13 @@ private:
 
   geometry_msgs::msg::PoseWithCovarianceStamped align_pose(
     const geometry_msgs::msg::PoseWithCovarianceStamped & initial_pose_with_cov);
+  void update_align_pose_ndt_ptrs(const int64_t pool_size);
 
-  void transform_sensor_measurement(
-    const std::string & source_frame, const std::string & target_frame,
-    const pcl::shared_ptr<pcl::PointCloud<PointSource>> & sensor_points_input_ptr,
-    pcl::shared_ptr<pcl::PointCloud<PointSource>> & sensor_points_output_ptr);
+  Eigen::Matrix4f get_transform_matrix(
+    const std::string & source_frame, const std::string & target_frame);
+  static void convert_sensor_points(
+    const sensor_msgs::msg::PointCloud2 & sensor_points_msg, const Eigen::Matrix4f & transform,
+    pcl::PointCloud<PointSource> & sensor_points_output);
 
   void publish_tf(
     const rclcpp::Time & sensor_ros_time, const geometry_msgs::msg::Pose & result_pose_msg);
@@ -180,10 +182,21 @@ private:
   rclcpp::CallbackGroup::SharedPtr timer_callback_group_;
 
   std::shared_ptr<NormalDistributionsTransform> ndt_ptr_;
+  // Copies of ndt_ptr_ used by align_pose(), copied again only when the map cells change
+  std::vector<std::shared_ptr<NormalDistributionsTransform>> align_pose_ndt_ptrs_;
+  std::vector<std::string> align_pose_ndt_map_ids_;
   std::shared_ptr<std::map<std::string, std::string>> state_ptr_;
 
   Eigen::Matrix4f base_to_sensor_matrix_;
 
+  // Point cloud buffers reused across sensor callbacks so that the steady state does not allocate.
+  // Two source buffers are kept because the one set to ndt_ptr_ must stay untouched until a new
+  // input source is accepted.
+  std::array<pcl::shared_ptr<pcl::PointCloud<PointSource>>, 2> sensor_points_in_baselink_buffers_;
+  pcl::shared_ptr<pcl::PointCloud<PointSource>> aligned_points_;
+  pcl::shared_ptr<pcl::PointCloud<PointSource>> sensor_points_in_map_;
+  pcl::shared_ptr<pcl::PointCloud<PointSource>> no_ground_points_in_map_;
+
   std::mutex ndt_ptr_mtx_;
   std::unique_ptr<SmartPoseBuffer> initial_pose_buffer_;
 
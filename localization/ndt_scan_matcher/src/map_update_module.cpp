@@ -14,6 +14,12 @@
 
 #include "ndt_scan_matcher/map_update_module.hpp"
 
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
 MapUpdateModule::MapUpdateModule(
   rclcpp::Node * node, std::mutex * ndt_ptr_mutex, NdtPtrType & ndt_ptr,
   HyperParameters::DynamicMapLoading param)
@@ -25,6 +31,14 @@ MapUpdateModule::MapUpdateModule(
 {
   loaded_pcd_pub_ = node->create_publisher<sensor_msgs::msg::PointCloud2>(
     "debug/loaded_pointcloud_map", rclcpp::QoS{1}.transient_local());
+  update_time_pub_ = node->create_publisher<tier4_debug_msgs::msg::Float32Stamped>(
+    "debug/map_update_time_ms", 10);
+  lock_time_pub_ = node->create_publisher<tier4_debug_msgs::msg::Float32Stamped>(
+    "debug/map_update_lock_time_ms", 10);
+  loaded_bytes_pub_ = node->create_publisher<tier4_debug_msgs::msg::Int32Stamped>(
+    "debug/map_update_loaded_bytes", 10);
+  cache_miss_num_pub_ = node->create_publisher<tier4_debug_msgs::msg::Int32Stamped>(
+    "debug/map_update_cache_miss_num", 10);
 
   pcd_loader_client_ =
     node->create_client<autoware_map_msgs::srv::GetDifferentialPointCloudMap>("pcd_loader_service");
@@ -42,7 +56,13 @@ MapUpdateModule::MapUpdateModule(
   // From the second update, the update is done on secondary_ndt_ptr_,
   // and ndt_ptr_ is only locked when swapping its pointer with
   // secondary_ndt_ptr_.
+  // The two NDTs are never copied into each other after that. Each one requests the map cells
+  // relative to its own cached cell IDs, so an update only touches the added and removed cells.
   need_rebuild_ = true;
+
+  if (param_.cell_cache_size > 0) {
+    cell_cache_ = std::make_unique<MapCellCache>(static_cast<size_t>(param_.cell_cache_size));
+  }
 }
 
 bool MapUpdateModule::should_update_map(const geometry_msgs::msg::Point & position)
@@ -67,22 +87,16 @@ bool MapUpdateModule::should_update_map(const geometry_msgs::msg::Point & positi
 
 void MapUpdateModule::update_map(const geometry_msgs::msg::Point & position)
 {
+  UpdateStats stats;
+
   // If the current position is super far from the previous loading position,
-  // lock and rebuild ndt_ptr_
+  // lock ndt_ptr_ and update it in place
   if (need_rebuild_) {
+    const auto lock_start_time = std::chrono::system_clock::now();
     ndt_ptr_mutex_->lock();
 
-    auto param = ndt_ptr_->getParams();
-    auto input_source = ndt_ptr_->getInputSource();
-
-    ndt_ptr_.reset(new NdtType);
-
-    ndt_ptr_->setParams(param);
-    if (input_source != nullptr) {
-      ndt_ptr_->setInputSource(input_source);
-    }
-
-    const bool updated = update_ndt(position, *ndt_ptr_);
+    const bool updated = update_ndt(position, *ndt_ptr_, stats);
+    stats.lock_time_ms = elapsed_ms(lock_start_time);
     if (!updated) {
       RCLCPP_ERROR_STREAM_THROTTLE(
         logger_, *clock_, 1000,
@@ -100,35 +114,46 @@ void MapUpdateModule::update_map(const geometry_msgs::msg::Point & position)
     // the main ndt_ptr_) overlap, the latency of updating/alignment reduces partly.
     // If the updating is done the main ndt_ptr_, either the update or the NDT
     // align will be blocked by the other.
-    const bool updated = update_ndt(position, *secondary_ndt_ptr_);
+    const bool updated = update_ndt(position, *secondary_ndt_ptr_, stats);
+    // secondary_ndt_ptr_ is one update behind ndt_ptr_, so even without any change it may hold a
+    // different set of cells than ndt_ptr_
     if (!updated) {
-      last_update_position_ = position;
-      return;
+      // ndt_ptr_ is shared with the alignment, so only its ids are taken under the lock
+      std::vector<std::string> current_map_ids;
+      {
+        std::lock_guard<std::mutex> lock(*ndt_ptr_mutex_);
+        current_map_ids = ndt_ptr_->getCurrentMapIDs();
+      }
+      if (has_same_map_ids(*secondary_ndt_ptr_, std::move(current_map_ids))) {
+        last_update_position_ = position;
+        return;
+      }
     }
 
+    // Only the pointers are exchanged. The previous ndt_ptr_ becomes the secondary one and catches
+    // up with its own differential update next time.
+    const auto lock_start_time = std::chrono::system_clock::now();
     ndt_ptr_mutex_->lock();
-    auto dummy_ptr = ndt_ptr_;
     auto input_source = ndt_ptr_->getInputSource();
-    ndt_ptr_ = secondary_ndt_ptr_;
+    std::swap(ndt_ptr_, secondary_ndt_ptr_);
     if (input_source != nullptr) {
       ndt_ptr_->setInputSource(input_source);
     }
     ndt_ptr_mutex_->unlock();
-
-    dummy_ptr.reset();
+    stats.lock_time_ms = elapsed_ms(lock_start_time);
   }
 
-  secondary_ndt_ptr_.reset(new NdtType);
-  *secondary_ndt_ptr_ = *ndt_ptr_;
-
   // Memorize the position of the last update
   last_update_position_ = position;
 
+  publish_update_stats(stats);
+
   // Publish the new ndt maps
   publish_partial_pcd_map();
 }
 
-bool MapUpdateModule::update_ndt(const geometry_msgs::msg::Point & position, NdtType & ndt)
+bool MapUpdateModule::update_ndt(
+  const geometry_msgs::msg::Point & position, NdtType & ndt, UpdateStats & stats)
 {
   auto request = std::make_shared<autoware_map_msgs::srv::GetDifferentialPointCloudMap::Request>();
 
@@ -137,6 +162,20 @@ bool MapUpdateModule::update_ndt(const geometry_msgs::msg::Point & position, Ndt
   request->area.radius = static_cast<float>(param_.map_radius);
   request->cached_ids = ndt.getCurrentMapIDs();
 
+  // The cached cells are reported to the map loader as well. The ones inside the area come back
+  // in neither list of the response and are taken from the cache instead.
+  const std::unordered_set<std::string> ndt_ids(
+    request->cached_ids.begin(), request->cached_ids.end());
+  std::unordered_map<std::string, MapCellCache::CellConstPtr> cached_cells;
+  if (cell_cache_) {
+    for (auto & [id, cell] : cell_cache_->snapshot()) {
+      if (ndt_ids.count(id) == 0) {
+        request->cached_ids.push_back(id);
+      }
+      cached_cells.emplace(id, std::move(cell));
+    }
+  }
+
   while (!pcd_loader_client_->wait_for_service(std::chrono::seconds(1)) && rclcpp::ok()) {
     RCLCPP_INFO(logger_, "Waiting for pcd loader service. Check the pointcloud_map_loader.");
   }
@@ -156,11 +195,31 @@ bool MapUpdateModule::update_ndt(const geometry_msgs::msg::Point & position, Ndt
   }
 
   auto & maps_to_add = result.get()->new_pointcloud_with_ids;
-  auto & map_ids_to_remove = result.get()->ids_to_remove;
+  const std::unordered_set<std::string> ids_outside_area(
+    result.get()->ids_to_remove.begin(), result.get()->ids_to_remove.end());
+
+  std::vector<std::string> map_ids_to_remove;
+  for (const std::string & id : ids_outside_area) {
+    if (ndt_ids.count(id) > 0) {
+      map_ids_to_remove.push_back(id);
+    }
+  }
+  std::vector<std::pair<std::string, MapCellCache::CellConstPtr>> cells_from_cache;
+  for (const auto & [id, cell] : cached_cells) {
+    if (ids_outside_area.count(id) > 0) {
+      continue;
+    }
+    if (ndt_ids.count(id) == 0) {
+      cells_from_cache.emplace_back(id, cell);
+    }
+    // Keep the cells that are still in use at the head of the LRU
+    cell_cache_->put(id, cell);
+  }
 
   RCLCPP_INFO(
-    logger_, "Update map (Add: %lu, Remove: %lu)", maps_to_add.size(), map_ids_to_remove.size());
-  if (maps_to_add.empty() && map_ids_to_remove.empty()) {
+    logger_, "Update map (Add: %lu, Add from cache: %lu, Remove: %lu)", maps_to_add.size(),
+    cells_from_cache.size(), map_ids_to_remove.size());
+  if (maps_to_add.empty() && cells_from_cache.empty() && map_ids_to_remove.empty()) {
     RCLCPP_INFO(logger_, "Skip map update");
     return false;  // No update
   }
@@ -170,11 +229,20 @@ bool MapUpdateModule::update_ndt(const geometry_msgs::msg::Point & position, Ndt
 
   // Add pcd
   for (auto & map : maps_to_add) {
+    stats.loaded_bytes += map.pointcloud.data.size();
     auto cloud = pcl::make_shared<pcl::PointCloud<PointTarget>>();
 
     pcl::fromROSMsg(map.pointcloud, *cloud);
     ndt.addTarget(cloud, map.cell_id);
+    if (cell_cache_) {
+      cell_cache_->put(map.cell_id, cloud);
+    }
+  }
+  for (const auto & [id, cell] : cells_from_cache) {
+    ndt.addTarget(cell, id);
   }
+  stats.cache_miss_num += maps_to_add.size();
+  stats.cache_hit_num += cells_from_cache.size();
 
   // Remove pcd
   for (const std::string & map_id_to_remove : map_ids_to_remove) {
@@ -183,11 +251,10 @@ bool MapUpdateModule::update_ndt(const geometry_msgs::msg::Point & position, Ndt
 
   ndt.createVoxelKdtree();
 
-  const auto exe_end_time = std::chrono::system_clock::now();
-  const auto duration_micro_sec =
-    std::chrono::duration_cast<std::chrono::microseconds>(exe_end_time - exe_start_time).count();
-  const auto exe_time = static_cast<double>(duration_micro_sec) / 1000.0;
-  RCLCPP_DEBUG(logger_, "Time duration for creating new ndt_ptr: %lf [ms]", exe_time);
+  stats.update_time_ms = elapsed_ms(exe_start_time);
+  RCLCPP_DEBUG(
+    logger_, "Time duration for updating ndt_ptr: %lf [ms] (loaded %zu bytes)",
+    stats.update_time_ms, stats.loaded_bytes);
   return true;  // Updated
 }
 
@@ -200,3 +267,115 @@ void MapUpdateModule::publish_partial_pcd_map()
 
   loaded_pcd_pub_->publish(map_msg);
 }
+
+void MapUpdateModule::prefetch_map(
+  const geometry_msgs::msg::Point & position, const rclcpp::Time & stamp)
+{
+  if (!cell_cache_ || param_.prefetch_time_horizon <= 0.0) {
+    return;
+  }
+
+  geometry_msgs::msg::Point predicted_position = position;
+  if (last_prefetch_call_position_ != std::nullopt) {
+    const double dt = (stamp - last_prefetch_call_stamp_).seconds();
+    if (dt > 0.0) {
+      const double scale = param_.prefetch_time_horizon / dt;
+      predicted_position.x += (position.x - last_prefetch_call_position_.value().x) * scale;
+      predicted_position.y += (position.y - last_prefetch_call_position_.value().y) * scale;
+    }
+  }
+  last_prefetch_call_position_ = position;
+  last_prefetch_call_stamp_ = stamp;
+
+  // Nothing to prefetch until the first map is loaded, or while the previous request is pending
+  if (last_update_position_ == std::nullopt || prefetch_in_flight_) {
+    return;
+  }
+  // Like the map update itself, only request again once the predicted area has moved enough
+  if (
+    last_prefetch_position_ != std::nullopt &&
+    std::hypot(
+      predicted_position.x - last_prefetch_position_.value().x,
+      predicted_position.y - last_prefetch_position_.value().y) < param_.update_distance) {
+    return;
+  }
+
+  auto request = std::make_shared<autoware_map_msgs::srv::GetDifferentialPointCloudMap::Request>();
+  request->area.center_x = static_cast<float>(predicted_position.x);
+  request->area.center_y = static_cast<float>(predicted_position.y);
+  request->area.radius = static_cast<float>(param_.map_radius);
+  {
+    std::lock_guard<std::mutex> lock(*ndt_ptr_mutex_);
+    request->cached_ids = ndt_ptr_->getCurrentMapIDs();
+  }
+  const std::unordered_set<std::string> ndt_ids(
+    request->cached_ids.begin(), request->cached_ids.end());
+  for (const auto & cell : cell_cache_->snapshot()) {
+    if (ndt_ids.count(cell.first) == 0) {
+      request->cached_ids.push_back(cell.first);
+    }
+  }
+
+  if (!pcd_loader_client_->service_is_ready()) {
+    return;
+  }
+  prefetch_in_flight_ = true;
+  last_prefetch_position_ = predicted_position;
+  pcd_loader_client_->async_send_request(
+    request,
+    [this](rclcpp::Client<autoware_map_msgs::srv::GetDifferentialPointCloudMap>::SharedFuture
+             future) {
+      on_prefetch_response(*future.get());
+      prefetch_in_flight_ = false;
+    });
+}
+
+void MapUpdateModule::on_prefetch_response(
+  const autoware_map_msgs::srv::GetDifferentialPointCloudMap::Response & response)
+{
+  // The cells outside of the predicted area (ids_to_remove) are left to the LRU eviction, since
+  // they may still be in use by the NDTs
+  for (const auto & map : response.new_pointcloud_with_ids) {
+    auto cloud = pcl::make_shared<pcl::PointCloud<PointTarget>>();
+    pcl::fromROSMsg(map.pointcloud, *cloud);
+    cell_cache_->put(map.cell_id, cloud);
+  }
+  RCLCPP_DEBUG(
+    logger_, "Prefetched %lu map cells (cached: %lu)", response.new_pointcloud_with_ids.size(),
+    cell_cache_->size());
+}
+
+bool MapUpdateModule::has_same_map_ids(NdtType & ndt, std::vector<std::string> map_ids)
+{
+  std::vector<std::string> ndt_ids = ndt.getCurrentMapIDs();
+  std::sort(ndt_ids.begin(), ndt_ids.end());
+  std::sort(map_ids.begin(), map_ids.end());
+  return ndt_ids == map_ids;
+}
+
+double MapUpdateModule::elapsed_ms(const std::chrono::system_clock::time_point & start_time)
+{
+  const auto duration_micro_sec = std::chrono::duration_cast<std::chrono::microseconds>(
+                                    std::chrono::system_clock::now() - start_time)
+                                    .count();
+  return static_cast<double>(duration_micro_sec) / 1000.0;
+}
+
+void MapUpdateModule::publish_update_stats(const UpdateStats & stats)
+{
+  using Float32Stamped = tier4_debug_msgs::msg::Float32Stamped;
+  using Int32Stamped = tier4_debug_msgs::msg::Int32Stamped;
+  const auto stamp = clock_->now();
+  const auto update_time = static_cast<float>(stats.update_time_ms);
+  const auto lock_time = static_cast<float>(stats.lock_time_ms);
+  const auto loaded_bytes = static_cast<int32_t>(
+    std::min<size_t>(stats.loaded_bytes, std::numeric_limits<int32_t>::max()));
+  const auto cache_miss_num = static_cast<int32_t>(stats.cache_miss_num);
+  update_time_pub_->publish(
+    tier4_debug_msgs::build<Float32Stamped>().stamp(stamp).data(update_time));
+  lock_time_pub_->publish(tier4_debug_msgs::build<Float32Stamped>().stamp(stamp).data(lock_time));
+  loaded_bytes_pub_->publish(
+    tier4_debug_msgs::build<Int32Stamped>().stamp(stamp).data(loaded_bytes));
+  cache_miss_num_pub_->publish(
+    tier4_debug_msgs::build<Int32Stamped>().stamp(stamp).data(cache_miss_num));
+}
@@ -34,9 +34,9 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <functional>
 #include <iomanip>
-#include <thread>
 
 tier4_debug_msgs::msg::Float32Stamped make_float32_stamped(
   const builtin_interfaces::msg::Time & stamp, const float data)
@@ -177,6 +177,13 @@ NDTScanMatcher::NDTScanMatcher(const rclcpp::NodeOptions & options)
 
   ndt_ptr_->setParams(param_.ndt);
 
+  for (auto & buffer : sensor_points_in_baselink_buffers_) {
+    buffer = pcl::make_shared<pcl::PointCloud<PointSource>>();
+  }
+  aligned_points_ = pcl::make_shared<pcl::PointCloud<PointSource>>();
+  sensor_points_in_map_ = pcl::make_shared<pcl::PointCloud<PointSource>>();
+  no_ground_points_in_map_ = pcl::make_shared<pcl::PointCloud<PointSource>>();
+
   initial_pose_buffer_ = std::make_unique<SmartPoseBuffer>(
     this->get_logger(), param_.validation.initial_pose_timeout_sec,
     param_.validation.initial_pose_distance_tolerance_m);
@@ -273,6 +280,7 @@ void NDTScanMatcher::callback_timer()
     RCLCPP_INFO(this->get_logger(), "Start updating NDT map (timer_callback)");
     map_update_module_->update_map(latest_ekf_position_.value());
   }
+  map_update_module_->prefetch_map(latest_ekf_position_.value(), this->now());
 }
 
 void NDTScanMatcher::callback_initial_pose(
@@ -335,17 +343,27 @@ void NDTScanMatcher::callback_sensor_points(
 
   const auto exe_start_time = std::chrono::system_clock::now();
 
+  // The buffer currently set as the input source is kept as is, so that a rejected scan does not
+  // overwrite the one used by service_ndt_align
+  const auto & sensor_points_in_baselink_frame =
+    (ndt_ptr_->getInputSource() == sensor_points_in_baselink_buffers_[0])
+      ? sensor_points_in_baselink_buffers_[1]
+      : sensor_points_in_baselink_buffers_[0];
+
+  // Count how many reused buffers had to grow in this cycle, which should be zero in steady state
+  const auto capacity_of = [](const pcl::shared_ptr<pcl::PointCloud<PointSource>> & cloud) {
+    return cloud->points.capacity();
+  };
+  const std::array<size_t, 4> buffer_capacities{
+    capacity_of(sensor_points_in_baselink_frame), capacity_of(aligned_points_),
+    capacity_of(sensor_points_in_map_), capacity_of(no_ground_points_in_map_)};
+
   // preprocess input pointcloud
-  pcl::shared_ptr<pcl::PointCloud<PointSource>> sensor_points_in_sensor_frame(
-    new pcl::PointCloud<PointSource>);
-  pcl::shared_ptr<pcl::PointCloud<PointSource>> sensor_points_in_baselink_frame(
-    new pcl::PointCloud<PointSource>);
+  // The conversion from the message and the transform to the base frame are done in one pass
   const std::string & sensor_frame = sensor_points_msg_in_sensor_frame->header.frame_id;
-
-  pcl::fromROSMsg(*sensor_points_msg_in_sensor_frame, *sensor_points_in_sensor_frame);
-  transform_sensor_measurement(
-    sensor_frame, param_.frame.base_frame, sensor_points_in_sensor_frame,
-    sensor_points_in_baselink_frame);
+  convert_sensor_points(
+    *sensor_points_msg_in_sensor_frame,
+    get_transform_matrix(sensor_frame, param_.frame.base_frame), *sensor_points_in_baselink_frame);
 
   // check max distance of sensor points
   double max_distance = 0.0;
@@ -388,9 +406,16 @@ void NDTScanMatcher::callback_sensor_points(
   // perform ndt scan matching
   const Eigen::Matrix4f initial_pose_matrix =
     pose_to_matrix4f(interpolation_result.interpolated_pose.pose.pose);
-  auto output_cloud = std::make_shared<pcl::PointCloud<PointSource>>();
-  ndt_ptr_->align(*output_cloud, initial_pose_matrix);
+  const auto align_start_time = std::chrono::system_clock::now();
+  ndt_ptr_->align(*aligned_points_, initial_pose_matrix);
   const pclomp::NdtResult ndt_result = ndt_ptr_->getResult();
+  const auto align_end_time = std::chrono::system_clock::now();
+  const auto align_duration_micro_sec =
+    std::chrono::duration_cast<std::chrono::microseconds>(align_end_time - align_start_time)
+      .count();
+  const auto align_time = static_cast<float>(align_duration_micro_sec) / 1000.0f;
+  const auto time_per_iteration =
+    align_time / static_cast<float>(std::max(ndt_result.iteration_num, 1));
 
   const geometry_msgs::msg::Pose result_pose_msg = matrix4f_to_pose(ndt_result.pose);
   std::vector<geometry_msgs::msg::Pose> transformation_msg_array;
@@ -455,8 +480,7 @@ void NDTScanMatcher::callback_sensor_points(
     sensor_ros_time, result_pose_msg, interpolation_result.interpolated_pose,
     interpolation_result.old_pose, interpolation_result.new_pose);
 
-  pcl::shared_ptr<pcl::PointCloud<PointSource>> sensor_points_in_map_ptr(
-    new pcl::PointCloud<PointSource>);
+  const auto & sensor_points_in_map_ptr = sensor_points_in_map_;
   tier4_autoware_utils::transformPointCloud(
     *sensor_points_in_baselink_frame, *sensor_points_in_map_ptr, ndt_result.pose);
   publish_point_cloud(sensor_ros_time, param_.frame.map_frame, sensor_points_in_map_ptr);
@@ -464,16 +488,19 @@ void NDTScanMatcher::callback_sensor_points(
   // whether use no ground points to calculate score
   if (param_.score_estimation.no_ground_points.enable) {
     // remove ground
-    pcl::shared_ptr<pcl::PointCloud<PointSource>> no_ground_points_in_map_ptr(
-      new pcl::PointCloud<PointSource>);
+    const auto & no_ground_points_in_map_ptr = no_ground_points_in_map_;
+    no_ground_points_in_map_ptr->clear();
+    const double result_position_z = matrix4f_to_pose(ndt_result.pose).position.z;
     for (std::size_t i = 0; i < sensor_points_in_map_ptr->size(); i++) {
       const float point_z = sensor_points_in_map_ptr->points[i].z;  // NOLINT
       if (
-        point_z - matrix4f_to_pose(ndt_result.pose).position.z >
+        point_z - result_position_z >
         param_.score_estimation.no_ground_points.z_margin_for_ground_removal) {
         no_ground_points_in_map_ptr->points.push_back(sensor_points_in_map_ptr->points[i]);
       }
     }
+    no_ground_points_in_map_ptr->width = no_ground_points_in_map_ptr->points.size();
+    no_ground_points_in_map_ptr->height = 1;
     // pub remove-ground points
     sensor_msgs::msg::PointCloud2 no_ground_points_msg_in_map;
     pcl::toROSMsg(*no_ground_points_in_map_ptr, no_ground_points_msg_in_map);
@@ -502,18 +529,25 @@ void NDTScanMatcher::callback_sensor_points(
   (*state_ptr_)["is_local_optimal_solution_oscillation"] =
     std::to_string(is_local_optimal_solution_oscillation);
   (*state_ptr_)["execution_time"] = std::to_string(exe_time);
+  (*state_ptr_)["align_time"] = std::to_string(align_time);
+  (*state_ptr_)["time_per_iteration"] = std::to_string(time_per_iteration);
+  const std::array<size_t, 4> new_buffer_capacities{
+    capacity_of(sensor_points_in_baselink_frame), capacity_of(aligned_points_),
+    capacity_of(sensor_points_in_map_), capacity_of(no_ground_points_in_map_)};
+  size_t buffer_reallocation_num = 0;
+  for (size_t i = 0; i < buffer_capacities.size(); ++i) {
+    buffer_reallocation_num += (new_buffer_capacities[i] != buffer_capacities[i]) ? 1 : 0;
+  }
+  (*state_ptr_)["buffer_reallocation_num"] = std::to_string(buffer_reallocation_num);
 
   publish_diagnostic();
 }
 
-void NDTScanMatcher::transform_sensor_measurement(
-  const std::string & source_frame, const std::string & target_frame,
-  const pcl::shared_ptr<pcl::PointCloud<PointSource>> & sensor_points_input_ptr,
-  pcl::shared_ptr<pcl::PointCloud<PointSource>> & sensor_points_output_ptr)
+Eigen::Matrix4f NDTScanMatcher::get_transform_matrix(
+  const std::string & source_frame, const std::string & target_frame)
 {
   if (source_frame == target_frame) {
-    sensor_points_output_ptr = sensor_points_input_ptr;
-    return;
+    return Eigen::Matrix4f::Identity();
   }
 
   geometry_msgs::msg::TransformStamped transform;
@@ -524,16 +558,58 @@ void NDTScanMatcher::transform_sensor_measurement(
     RCLCPP_WARN(
       this->get_logger(), "Please publish TF %s to %s", target_frame.c_str(), source_frame.c_str());
     // Since there is no clear error handling policy, temporarily return as is.
-    sensor_points_output_ptr = sensor_points_input_ptr;
-    return;
+    return Eigen::Matrix4f::Identity();
   }
 
   const geometry_msgs::msg::PoseStamped target_to_source_pose_stamped =
     tier4_autoware_utils::transform2pose(transform);
-  const Eigen::Matrix4f base_to_sensor_matrix =
-    pose_to_matrix4f(target_to_source_pose_stamped.pose);
-  tier4_autoware_utils::transformPointCloud(
-    *sensor_points_input_ptr, *sensor_points_output_ptr, base_to_sensor_matrix);
+  return pose_to_matrix4f(target_to_source_pose_stamped.pose);
+}
+
+void NDTScanMatcher::convert_sensor_points(
+  const sensor_msgs::msg::PointCloud2 & sensor_points_msg, const Eigen::Matrix4f & transform,
+  pcl::PointCloud<PointSource> & sensor_points_output)
+{
+  // Equivalent to pcl::fromROSMsg followed by tier4_autoware_utils::transformPointCloud, but reads
+  // the message directly into the (reused) output buffer without intermediate clouds
+  const int x_index = pcl::getFieldIndex(sensor_points_msg, "x");
+  const int y_index = pcl::getFieldIndex(sensor_points_msg, "y");
+  const int z_index = pcl::getFieldIndex(sensor_points_msg, "z");
+  const size_t num_points =
+    static_cast<size_t>(sensor_points_msg.width) * static_cast<size_t>(sensor_points_msg.height);
+  sensor_points_output.header = pcl_conversions::toPCL(sensor_points_msg.header);
+  sensor_points_output.width = sensor_points_msg.width;
+  sensor_points_output.height = sensor_points_msg.height;
+  sensor_points_output.is_dense = sensor_points_msg.is_dense;
+  sensor_points_output.points.resize(num_points);
+  if (x_index == -1 || y_index == -1 || z_index == -1) {
+    return;
+  }
+
+  const size_t x_offset = sensor_points_msg.fields[x_index].offset;
+  const size_t y_offset = sensor_points_msg.fields[y_index].offset;
+  const size_t z_offset = sensor_points_msg.fields[z_index].offset;
+  const bool is_identity = transform.isIdentity();
+  for (size_t i = 0; i < num_points; ++i) {
+    const size_t row = i / sensor_points_msg.width;
+    const size_t col = i % sensor_points_msg.width;
+    const uint8_t * point_data = &sensor_points_msg.data[row * sensor_points_msg.row_step] +
+                                 col * sensor_points_msg.point_step;
+    Eigen::Vector4f point;
+    std::memcpy(&point[0], point_data + x_offset, sizeof(float));
+    std::memcpy(&point[1], point_data + y_offset, sizeof(float));
+    std::memcpy(&point[2], point_data + z_offset, sizeof(float));
+    point[3] = 1.0f;
+    if (
+      !is_identity && std::isfinite(point[0]) && std::isfinite(point[1]) &&
+      std::isfinite(point[2])) {
+      point = transform * point;
+    }
+    auto & output_point = sensor_points_output.points[i];
+    output_point.x = point[0];
+    output_point.y = point[1];
+    output_point.z = point[2];
+  }
 }
 
 void NDTScanMatcher::publish_tf(
@@ -929,72 +1005,105 @@ geometry_msgs::msg::PoseWithCovarianceStamped NDTScanMatcher::align_pose(
     param_.initial_pose_estimation.n_startup_trials, is_loop_variable);
 
   std::vector<Particle> particle_array;
-  auto output_cloud = std::make_shared<pcl::PointCloud<PointSource>>();
+
+  // align() modifies the NDT, so the particles of a batch are spread over a pool of copies of
+  // ndt_ptr_, each aligning its particles one by one. The NDT threads are shared among the copies.
+  const int64_t particles_num = param_.initial_pose_estimation.particles_num;
+  const int64_t batch_size =
+    std::min(param_.initial_pose_estimation.particles_batch_size, particles_num);
+  const int64_t pool_size = std::min(batch_size, static_cast<int64_t>(param_.ndt.num_threads));
+  std::vector<std::shared_ptr<NormalDistributionsTransform>> pool_ndt_ptrs{ndt_ptr_};
+  if (pool_size > 1) {
+    update_align_pose_ndt_ptrs(pool_size);
+    pool_ndt_ptrs = align_pose_ndt_ptrs_;
+  }
+  std::vector<pcl::PointCloud<PointSource>> pool_output_clouds(pool_ndt_ptrs.size());
+  std::vector<pclomp::NdtResult> batch_ndt_results(batch_size);
 
   // publish the estimated poses in 20 times to see the progress and to avoid dropping data
   visualization_msgs::msg::MarkerArray marker_array;
   constexpr int64_t publish_num = 20;
-  const int64_t publish_interval = param_.initial_pose_estimation.particles_num / publish_num;
-
-  for (int64_t i = 0; i < param_.initial_pose_estimation.particles_num; i++) {
-    const TreeStructuredParzenEstimator::Input input = tpe.get_next_input();
-
-    geometry_msgs::msg::Pose initial_pose;
-    initial_pose.position.x =
-      initial_pose_with_cov.pose.pose.position.x + uniform_to_normal(input[0]) * stddev_x;
-    initial_pose.position.y =
-      initial_pose_with_cov.pose.pose.position.y + uniform_to_normal(input[1]) * stddev_y;
-    initial_pose.position.z =
-      initial_pose_with_cov.pose.pose.position.z + uniform_to_normal(input[2]) * stddev_z;
-    geometry_msgs::msg::Vector3 init_rpy;
-    init_rpy.x = base_rpy.x + uniform_to_normal(input[3]) * stddev_roll;
-    init_rpy.y = base_rpy.y + uniform_to_normal(input[4]) * stddev_pitch;
-    init_rpy.z = base_rpy.z + input[5] * M_PI;
-    tf2::Quaternion tf_quaternion;
-    tf_quaternion.setRPY(init_rpy.x, init_rpy.y, init_rpy.z);
-    initial_pose.orientation = tf2::toMsg(tf_quaternion);
-
-    const Eigen::Matrix4f initial_pose_matrix = pose_to_matrix4f(initial_pose);
-    ndt_ptr_->align(*output_cloud, initial_pose_matrix);
-    const pclomp::NdtResult ndt_result = ndt_ptr_->getResult();
-
-    Particle particle(
-      initial_pose, matrix4f_to_pose(ndt_result.pose), ndt_result.transform_probability,
-      ndt_result.iteration_num);
-    particle_array.push_back(particle);
-    push_debug_markers(marker_array, get_clock()->now(), param_.frame.map_frame, particle, i);
-    if (
-      (i + 1) % publish_interval == 0 || (i + 1) == param_.initial_pose_estimation.particles_num) {
-      ndt_monte_carlo_initial_pose_marker_pub_->publish(marker_array);
-      marker_array.markers.clear();
+  const int64_t publish_interval = std::max(particles_num / publish_num, static_cast<int64_t>(1));
+
+  for (int64_t batch_begin = 0; batch_begin < particles_num; batch_begin += batch_size) {
+    const int64_t current_batch_size = std::min(batch_size, particles_num - batch_begin);
+    const std::vector<TreeStructuredParzenEstimator::Input> inputs =
+      tpe.get_next_inputs(current_batch_size);
+
+    std::vector<geometry_msgs::msg::Pose> initial_poses(current_batch_size);
+    for (int64_t j = 0; j < current_batch_size; j++) {
+      const TreeStructuredParzenEstimator::Input & input = inputs[j];
+      geometry_msgs::msg::Pose & initial_pose = initial_poses[j];
+      initial_pose.position.x =
+        initial_pose_with_cov.pose.pose.position.x + uniform_to_normal(input[0]) * stddev_x;
+      initial_pose.position.y =
+        initial_pose_with_cov.pose.pose.position.y + uniform_to_normal(input[1]) * stddev_y;
+      initial_pose.position.z =
+        initial_pose_with_cov.pose.pose.position.z + uniform_to_normal(input[2]) * stddev_z;
+      geometry_msgs::msg::Vector3 init_rpy;
+      init_rpy.x = base_rpy.x + uniform_to_normal(input[3]) * stddev_roll;
+      init_rpy.y = base_rpy.y + uniform_to_normal(input[4]) * stddev_pitch;
+      init_rpy.z = base_rpy.z + input[5] * M_PI;
+      tf2::Quaternion tf_quaternion;
+      tf_quaternion.setRPY(init_rpy.x, init_rpy.y, init_rpy.z);
+      initial_pose.orientation = tf2::toMsg(tf_quaternion);
+    }
+
+    // Each copy is used by a single thread, whatever the number of threads OpenMP provides
+    const int64_t current_pool_size =
+      std::min(static_cast<int64_t>(pool_ndt_ptrs.size()), current_batch_size);
+#pragma omp parallel for num_threads(current_pool_size) schedule(static, 1)
+    for (int64_t k = 0; k < current_pool_size; k++) {
+      for (int64_t j = k; j < current_batch_size; j += current_pool_size) {
+        const Eigen::Matrix4f initial_pose_matrix = pose_to_matrix4f(initial_poses[j]);
+        pool_ndt_ptrs[k]->align(pool_output_clouds[k], initial_pose_matrix);
+        batch_ndt_results[j] = pool_ndt_ptrs[k]->getResult();
+      }
     }
 
-    const geometry_msgs::msg::Pose pose = matrix4f_to_pose(ndt_result.pose);
-    const geometry_msgs::msg::Vector3 rpy = get_rpy(pose);
-
-    const double diff_x = pose.position.x - initial_pose_with_cov.pose.pose.position.x;
-    const double diff_y = pose.position.y - initial_pose_with_cov.pose.pose.position.y;
-    const double diff_z = pose.position.z - initial_pose_with_cov.pose.pose.position.z;
-    const double diff_roll = rpy.x - base_rpy.x;
-    const double diff_pitch = rpy.y - base_rpy.y;
-    const double diff_yaw = rpy.z - base_rpy.z;
-
-    // Only yaw is a loop_variable, so only simple normalization is performed.
-    // All other variables are converted from normal distribution to uniform distribution.
-    TreeStructuredParzenEstimator::Input result(is_loop_variable.size());
-    result[0] = normal_to_uniform(diff_x / stddev_x);
-    result[1] = normal_to_uniform(diff_y / stddev_y);
-    result[2] = normal_to_uniform(diff_z / stddev_z);
-    result[3] = normal_to_uniform(diff_roll / stddev_roll);
-    result[4] = normal_to_uniform(diff_pitch / stddev_pitch);
-    result[5] = diff_yaw / M_PI;
-    tpe.add_trial(TreeStructuredParzenEstimator::Trial{result, ndt_result.transform_probability});
-
-    auto sensor_points_in_map_ptr = std::make_shared<pcl::PointCloud<PointSource>>();
-    tier4_autoware_utils::transformPointCloud(
-      *ndt_ptr_->getInputSource(), *sensor_points_in_map_ptr, ndt_result.pose);
-    publish_point_cloud(
-      initial_pose_with_cov.header.stamp, param_.frame.map_frame, sensor_points_in_map_ptr);
+    // The results are handled in the particle order, as when the particles are aligned one by one
+    for (int64_t j = 0; j < current_batch_size; j++) {
+      const int64_t i = batch_begin + j;
+      const pclomp::NdtResult & ndt_result = batch_ndt_results[j];
+
+      Particle particle(
+        initial_poses[j], matrix4f_to_pose(ndt_result.pose), ndt_result.transform_probability,
+        ndt_result.iteration_num);
+      particle_array.push_back(particle);
+      push_debug_markers(marker_array, get_clock()->now(), param_.frame.map_frame, particle, i);
+      if ((i + 1) % publish_interval == 0 || (i + 1) == particles_num) {
+        ndt_monte_carlo_initial_pose_marker_pub_->publish(marker_array);
+        marker_array.markers.clear();
+      }
+
+      const geometry_msgs::msg::Pose pose = matrix4f_to_pose(ndt_result.pose);
+      const geometry_msgs::msg::Vector3 rpy = get_rpy(pose);
+
+      const double diff_x = pose.position.x - initial_pose_with_cov.pose.pose.position.x;
+      const double diff_y = pose.position.y - initial_pose_with_cov.pose.pose.position.y;
+      const double diff_z = pose.position.z - initial_pose_with_cov.pose.pose.position.z;
+      const double diff_roll = rpy.x - base_rpy.x;
+      const double diff_pitch = rpy.y - base_rpy.y;
+      const double diff_yaw = rpy.z - base_rpy.z;
+
+      // Only yaw is a loop_variable, so only simple normalization is performed.
+      // All other variables are converted from normal distribution to uniform distribution.
+      TreeStructuredParzenEstimator::Input result(is_loop_variable.size());
+      result[0] = normal_to_uniform(diff_x / stddev_x);
+      result[1] = normal_to_uniform(diff_y / stddev_y);
+      result[2] = normal_to_uniform(diff_z / stddev_z);
+      result[3] = normal_to_uniform(diff_roll / stddev_roll);
+      result[4] = normal_to_uniform(diff_pitch / stddev_pitch);
+      result[5] = diff_yaw / M_PI;
+      tpe.add_trial(
+        TreeStructuredParzenEstimator::Trial{result, ndt_result.transform_probability});
+
+      auto sensor_points_in_map_ptr = std::make_shared<pcl::PointCloud<PointSource>>();
+      tier4_autoware_utils::transformPointCloud(
+        *ndt_ptr_->getInputSource(), *sensor_points_in_map_ptr, ndt_result.pose);
+      publish_point_cloud(
+        initial_pose_with_cov.header.stamp, param_.frame.map_frame, sensor_points_in_map_ptr);
+    }
   }
 
   auto best_particle_ptr = std::max_element(
@@ -1011,3 +1120,31 @@ geometry_msgs::msg::PoseWithCovarianceStamped NDTScanMatcher::align_pose(
 
   return result_pose_with_cov_msg;
 }
+
+void NDTScanMatcher::update_align_pose_ndt_ptrs(const int64_t pool_size)
+{
+  std::vector<std::string> map_ids = ndt_ptr_->getCurrentMapIDs();
+  std::sort(map_ids.begin(), map_ids.end());
+
+  // The copies only need the current input source, unless the map cells have changed
+  if (
+    static_cast<int64_t>(align_pose_ndt_ptrs_.size()) == pool_size &&
+    map_ids == align_pose_ndt_map_ids_) {
+    for (auto & pool_ndt_ptr : align_pose_ndt_ptrs_) {
+      pool_ndt_ptr->setInputSource(ndt_ptr_->getInputSource());
+    }
+    return;
+  }
+
+  pclomp::NdtParams pool_ndt_params = ndt_ptr_->getParams();
+  pool_ndt_params.num_threads =
+    std::max(pool_ndt_params.num_threads / static_cast<int>(pool_size), 1);
+  align_pose_ndt_ptrs_.clear();
+  for (int64_t k = 0; k < pool_size; k++) {
+    auto pool_ndt_ptr = std::make_shared<NormalDistributionsTransform>();
+    *pool_ndt_ptr = *ndt_ptr_;
+    pool_ndt_ptr->setParams(pool_ndt_params);
+    align_pose_ndt_ptrs_.push_back(pool_ndt_ptr);
+  }
+  align_pose_ndt_map_ids_ = map_ids;
+}
@@ -0,0 +1,139 @@
+// Copyright 2024 Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures the wall time of the initial pose estimation (ndt_align_srv) for several particle
+// counts, batch sizes and NDT thread counts, on the same sample map and scan as the tests.
+
+#include "../include/ndt_scan_matcher/ndt_scan_matcher_core.hpp"
+#include "stub_initialpose_client.hpp"
+#include "stub_pcd_loader.hpp"
+#include "stub_sensor_pcd_publisher.hpp"
+#include "stub_trigger_node_client.hpp"
+
+#include <ament_index_cpp/get_package_share_directory.hpp>
+#include <rclcpp/rclcpp.hpp>
+
+#include <rcl_yaml_param_parser/parser.h>
+#include <tf2_ros/static_transform_broadcaster.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+rclcpp::NodeOptions make_node_options(
+  const int64_t particles_num, const int64_t particles_batch_size, const int64_t ndt_num_threads)
+{
+  const std::string yaml_path = ament_index_cpp::get_package_share_directory("ndt_scan_matcher") +
+                                "/config/ndt_scan_matcher.param.yaml";
+
+  rcl_params_t * params_st = rcl_yaml_node_struct_init(rcl_get_default_allocator());
+  if (!rcl_parse_yaml_file(yaml_path.c_str(), params_st)) {
+    throw std::runtime_error("Failed to parse yaml file");
+  }
+
+  const rclcpp::ParameterMap param_map = rclcpp::parameter_map_from(params_st, "");
+  rclcpp::NodeOptions node_options;
+  for (const auto & param_pair : param_map) {
+    for (const auto & param : param_pair.second) {
+      node_options.parameter_overrides().push_back(param);
+    }
+  }
+  rcl_yaml_node_struct_fini(params_st);
+
+  // Later overrides take precedence over the ones from the yaml file
+  node_options.parameter_overrides().emplace_back(
+    "initial_pose_estimation.particles_num", particles_num);
+  node_options.parameter_overrides().emplace_back(
+    "initial_pose_estimation.particles_batch_size", particles_batch_size);
+  node_options.parameter_overrides().emplace_back("ndt.num_threads", ndt_num_threads);
+  return node_options;
+}
+
+double measure_align_time(
+  const rclcpp::NodeOptions & node_options, StubTriggerNodeClient & trigger_node_client,
+  StubSensorPcdPublisher & sensor_pcd_publisher, StubInitialposeClient & initialpose_client,
+  geometry_msgs::msg::Pose & result_pose)
+{
+  auto node = std::make_shared<NDTScanMatcher>(node_options);
+
+  // prepare tf_static "base_link -> sensor_frame"
+  tf2_ros::StaticTransformBroadcaster tf_broadcaster(node);
+  geometry_msgs::msg::TransformStamped tf_static;
+  tf_static.header.frame_id = "base_link";
+  tf_static.child_frame_id = "sensor_frame";
+  tf_static.transform.rotation.w = 1.0;
+  tf_broadcaster.sendTransform(tf_static);
+
+  rclcpp::executors::MultiThreadedExecutor exec;
+  exec.add_node(node);
+  std::thread spin_thread([&]() { exec.spin(); });
+
+  trigger_node_client.send_trigger_node(true);
+  sensor_pcd_publisher.publish_pcd(make_default_sensor_pcd());
+  // wait for the scan to be set as the input source
+  std::this_thread::sleep_for(std::chrono::seconds(1));
+
+  const auto start = std::chrono::steady_clock::now();
+  result_pose =
+    initialpose_client.send_initialpose(make_pose(/* x = */ 100.0, /* y = */ 100.0)).pose.pose;
+  const auto end = std::chrono::steady_clock::now();
+
+  exec.cancel();
+  spin_thread.join();
+  return std::chrono::duration<double>(end - start).count();
+}
+
+int main(int argc, char ** argv)
+{
+  rclcpp::init(argc, argv);
+  rclcpp::get_logger("ndt_scan_matcher").set_level(rclcpp::Logger::Level::Warn);
+
+  auto pcd_loader = std::make_shared<StubPcdLoader>();
+  rclcpp::executors::SingleThreadedExecutor pcd_loader_exec;
+  pcd_loader_exec.add_node(pcd_loader);
+  std::thread pcd_loader_thread([&]() { pcd_loader_exec.spin(); });
+
+  StubTriggerNodeClient trigger_node_client;
+  StubSensorPcdPublisher sensor_pcd_publisher;
+  StubInitialposeClient initialpose_client;
+
+  const int64_t hardware_threads = std::max(std::thread::hardware_concurrency(), 1u);
+  std::printf("#ParticlesNum BatchSize NdtNumThreads WallTimeSec ResultX ResultY\n");
+  for (const int64_t particles_num : {50, 100, 200}) {
+    for (const int64_t ndt_num_threads : {static_cast<int64_t>(1), hardware_threads}) {
+      for (const int64_t batch_size : {1, 2, 4, 8}) {
+        if (batch_size > hardware_threads) {
+          continue;
+        }
+        geometry_msgs::msg::Pose result_pose;
+        const double wall_time = measure_align_time(
+          make_node_options(particles_num, batch_size, ndt_num_threads), trigger_node_client,
+          sensor_pcd_publisher, initialpose_client, result_pose);
+        std::printf(
+          "%ld %ld %ld %.3f %.3f %.3f\n", particles_num, batch_size, ndt_num_threads, wall_time,
+          result_pose.position.x, result_pose.position.y);
+        std::fflush(stdout);
+      }
+    }
+  }
+
+  pcd_loader_exec.cancel();
+  pcd_loader_thread.join();
+  rclcpp::shutdown();
+  return 0;
+}
@@ -0,0 +1,138 @@
+// Copyright 2024 Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef STUB_GRID_PCD_LOADER_HPP_
+#define STUB_GRID_PCD_LOADER_HPP_
+
+#include <rclcpp/rclcpp.hpp>
+
+#include "autoware_map_msgs/srv/get_differential_point_cloud_map.hpp"
+
+#include <pcl/point_cloud.h>
+#include <pcl/point_types.h>
+#include <pcl_conversions/pcl_conversions.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <string>
+#include <vector>
+
+// Serves a map split into square cells with the same differential semantics as the
+// pointcloud_map_loader: the response holds the cells overlapping the area that are not in
+// cached_ids, and the cached_ids whose cell does not overlap the area.
+class StubGridPcdLoader : public rclcpp::Node
+{
+  using GetDifferentialPointCloudMap = autoware_map_msgs::srv::GetDifferentialPointCloudMap;
+
+public:
+  StubGridPcdLoader(
+    const float min_x, const float min_y, const int cells_x, const int cells_y,
+    const float cell_size)
+  : Node("stub_grid_pcd_loader"),
+    min_x_(min_x),
+    min_y_(min_y),
+    cells_x_(cells_x),
+    cells_y_(cells_y),
+    cell_size_(cell_size)
+  {
+    get_differential_pcd_maps_service_ = create_service<GetDifferentialPointCloudMap>(
+      "pcd_loader_service", std::bind(
+                              &StubGridPcdLoader::on_service_get_differential_point_cloud_map,
+                              this, std::placeholders::_1, std::placeholders::_2));
+  }
+
+  [[nodiscard]] size_t sent_cell_num() const { return sent_cell_num_; }
+
+private:
+  rclcpp::Service<GetDifferentialPointCloudMap>::SharedPtr get_differential_pcd_maps_service_;
+  const float min_x_;
+  const float min_y_;
+  const int cells_x_;
+  const int cells_y_;
+  const float cell_size_;
+  std::atomic<size_t> sent_cell_num_{0};
+
+  static std::string cell_id(const int ix, const int iy)
+  {
+    return std::to_string(ix) + "_" + std::to_string(iy);
+  }
+
+  [[nodiscard]] bool overlaps(
+    const autoware_map_msgs::msg::AreaInfo & area, const int ix, const int iy) const
+  {
+    const float cell_min_x = min_x_ + cell_size_ * static_cast<float>(ix);
+    const float cell_min_y = min_y_ + cell_size_ * static_cast<float>(iy);
+    const float nearest_x = std::clamp(area.center_x, cell_min_x, cell_min_x + cell_size_);
+    const float nearest_y = std::clamp(area.center_y, cell_min_y, cell_min_y + cell_size_);
+    return std::hypot(nearest_x - area.center_x, nearest_y - area.center_y) <= area.radius;
+  }
+
+  // A ground plane with a wall on two sides, so that every cell gives valid NDT voxels
+  [[nodiscard]] pcl::PointCloud<pcl::PointXYZ> make_cell_cloud(const int ix, const int iy) const
+  {
+    constexpr float interval = 0.5f;
+    const int num_points_per_line = static_cast<int>(cell_size_ / interval);
+    const float origin_x = min_x_ + cell_size_ * static_cast<float>(ix);
+    const float origin_y = min_y_ + cell_size_ * static_cast<float>(iy);
+    pcl::PointCloud<pcl::PointXYZ> cloud;
+    for (int i = 0; i < num_points_per_line; ++i) {
+      for (int j = 0; j < num_points_per_line; ++j) {
+        const float u = interval * static_cast<float>(i);
+        const float v = interval * static_cast<float>(j);
+        cloud.push_back(pcl::PointXYZ(origin_x + u, origin_y + v, 0.0f));
+        if (v < 5.0f) {
+          cloud.push_back(pcl::PointXYZ(origin_x + u, origin_y, v));
+          cloud.push_back(pcl::PointXYZ(origin_x, origin_y + u, v));
+        }
+      }
+    }
+    return cloud;
+  }
+
+  // NOLINTNEXTLINE
+  bool on_service_get_differential_point_cloud_map(
+    GetDifferentialPointCloudMap::Request::SharedPtr req,
+    GetDifferentialPointCloudMap::Response::SharedPtr res)
+  {
+    std::vector<bool> should_remove(req->cached_ids.size(), true);
+    for (int ix = 0; ix < cells_x_; ++ix) {
+      for (int iy = 0; iy < cells_y_; ++iy) {
+        if (!overlaps(req->area, ix, iy)) {
+          continue;
+        }
+        const std::string id = cell_id(ix, iy);
+        const auto it = std::find(req->cached_ids.begin(), req->cached_ids.end(), id);
+        if (it != req->cached_ids.end()) {
+          should_remove[it - req->cached_ids.begin()] = false;
+          continue;
+        }
+        autoware_map_msgs::msg::PointCloudMapCellWithID pcd_map_cell_with_id;
+        pcd_map_cell_with_id.cell_id = id;
+        pcl::toROSMsg(make_cell_cloud(ix, iy), pcd_map_cell_with_id.pointcloud);
+        res->new_pointcloud_with_ids.push_back(pcd_map_cell_with_id);
+      }
+    }
+    for (size_t i = 0; i < req->cached_ids.size(); ++i) {
+      if (should_remove[i]) {
+        res->ids_to_remove.push_back(req->cached_ids[i]);
+      }
+    }
+    sent_cell_num_ += res->new_pointcloud_with_ids.size();
+    res->header.frame_id = "map";
+    return true;
+  }
+};
+
+#endif  // STUB_GRID_PCD_LOADER_HPP_
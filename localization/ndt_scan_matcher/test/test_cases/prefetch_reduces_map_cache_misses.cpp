@@ -0,0 +1,139 @@
+// Copyright 2024 Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TEST_CASES__PREFETCH_REDUCES_MAP_CACHE_MISSES_HPP_
+#define TEST_CASES__PREFETCH_REDUCES_MAP_CACHE_MISSES_HPP_
+
+#include "../../include/ndt_scan_matcher/map_update_module.hpp"
+#include "../stub_grid_pcd_loader.hpp"
+
+#include <rclcpp/rclcpp.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using NdtType = pclomp::MultiGridNormalDistributionsTransform<pcl::PointXYZ, pcl::PointXYZ>;
+
+// Positions of a drive sampled at the period of the map update timer (1 [s]): 30 [s] east, then
+// 20 [s] north, at 15 [m/s]
+std::vector<geometry_msgs::msg::Point> make_drive()
+{
+  constexpr double speed = 15.0;
+  std::vector<geometry_msgs::msg::Point> drive;
+  geometry_msgs::msg::Point position;
+  for (int t = 0; t < 50; ++t) {
+    drive.push_back(position);
+    if (t < 30) {
+      position.x += speed;
+    } else {
+      position.y += speed;
+    }
+  }
+  return drive;
+}
+
+// Replays the drive the way NDTScanMatcher::callback_timer drives the module and returns the
+// number of map cells that had to be loaded by the map updates, excluding the initial load.
+size_t count_cache_misses(
+  const std::vector<geometry_msgs::msg::Point> & drive, const int64_t cell_cache_size,
+  const double prefetch_time_horizon)
+{
+  auto node = std::make_shared<rclcpp::Node>("map_update_module_replay");
+  auto pcd_loader = std::make_shared<StubGridPcdLoader>(
+    /* min_x = */ -300.0f, /* min_y = */ -300.0f, /* cells_x = */ 60, /* cells_y = */ 60,
+    /* cell_size = */ 20.0f);
+
+  std::mutex cache_miss_mutex;
+  std::vector<int32_t> cache_miss_nums;
+  auto cache_miss_sub = node->create_subscription<tier4_debug_msgs::msg::Int32Stamped>(
+    "debug/map_update_cache_miss_num", 100,
+    [&](const tier4_debug_msgs::msg::Int32Stamped::ConstSharedPtr msg) {
+      std::lock_guard<std::mutex> lock(cache_miss_mutex);
+      cache_miss_nums.push_back(msg->data);
+    });
+
+  std::mutex ndt_ptr_mutex;
+  auto ndt_ptr = std::make_shared<NdtType>();
+  pclomp::NdtParams ndt_params = ndt_ptr->getParams();
+  ndt_params.resolution = 2.0;
+  ndt_params.num_threads = 1;
+  ndt_ptr->setParams(ndt_params);
+
+  HyperParameters::DynamicMapLoading param{};
+  param.update_distance = 20.0;
+  param.map_radius = 150.0;
+  param.lidar_radius = 100.0;
+  param.cell_cache_size = cell_cache_size;
+  param.prefetch_time_horizon = prefetch_time_horizon;
+  MapUpdateModule map_update_module(node.get(), &ndt_ptr_mutex, ndt_ptr, param);
+
+  rclcpp::executors::MultiThreadedExecutor exec;
+  exec.add_node(node);
+  exec.add_node(pcd_loader);
+  std::thread spin_thread([&]() { exec.spin(); });
+
+  for (size_t i = 0; i < drive.size(); ++i) {
+    const rclcpp::Time stamp(static_cast<int64_t>(i) * 1000000000LL, RCL_ROS_TIME);
+    if (map_update_module.should_update_map(drive[i])) {
+      map_update_module.update_map(drive[i]);
+    }
+    map_update_module.prefetch_map(drive[i], stamp);
+    // The replay runs faster than the drive, so give the prefetch the time the timer period would
+    while (map_update_module.is_prefetching()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+  }
+  // wait for the last debug messages
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+  exec.cancel();
+  spin_thread.join();
+
+  std::lock_guard<std::mutex> lock(cache_miss_mutex);
+  size_t cache_miss_num = 0;
+  for (size_t i = 1; i < cache_miss_nums.size(); ++i) {
+    cache_miss_num += static_cast<size_t>(cache_miss_nums[i]);
+  }
+  return cache_miss_num;
+}
+
+TEST(MapUpdateModule, prefetch_reduces_map_cache_misses)  // NOLINT
+{
+  const std::vector<geometry_msgs::msg::Point> drive = make_drive();
+
+  const size_t misses_without_prefetch = count_cache_misses(drive, 400, 0.0);
+  const size_t misses_with_prefetch = count_cache_misses(drive, 400, 3.0);
+
+  RecordProperty("cache_misses_without_prefetch", static_cast<int>(misses_without_prefetch));
+  RecordProperty("cache_misses_with_prefetch", static_cast<int>(misses_with_prefetch));
+  EXPECT_GT(misses_without_prefetch, 0u);
+  EXPECT_LT(misses_with_prefetch, misses_without_prefetch / 2);
+}
+
+int main(int argc, char ** argv)
+{
+  rclcpp::init(argc, argv);
+  ::testing::InitGoogleTest(&argc, argv);
+  int result = RUN_ALL_TESTS();
+  rclcpp::shutdown();
+  return result;
+}
+
+#endif  // TEST_CASES__PREFETCH_REDUCES_MAP_CACHE_MISSES_HPP_
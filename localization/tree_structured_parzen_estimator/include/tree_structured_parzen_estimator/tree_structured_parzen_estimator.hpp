@@ -49,6 +49,9 @@ public:
     const Direction direction, const int64_t n_startup_trials, std::vector<bool> is_loop_variable);
   void add_trial(const Trial & trial);
   Input get_next_input() const;
+  // Proposes `n` inputs from the current trials at once, so that they can be evaluated in parallel
+  // before their results are added with add_trial()
+  std::vector<Input> get_next_inputs(const int64_t n) const;
 
 private:
   static constexpr double BASE_STDDEV_COEFF = 0.2;
@@ -93,6 +93,19 @@ TreeStructuredParzenEstimator::Input TreeStructuredParzenEstimator::get_next_inp
   return best_input;
 }
 
+std::vector<TreeStructuredParzenEstimator::Input> TreeStructuredParzenEstimator::get_next_inputs(
+  const int64_t n) const
+{
+  // Each proposal is the best of its own random EI candidates, so the proposals of a batch differ
+  // from each other even though they are drawn from the same trials.
+  std::vector<Input> inputs;
+  inputs.reserve(std::max(n, static_cast<int64_t>(0)));
+  for (int64_t i = 0; i < n; i++) {
+    inputs.push_back(get_next_input());
+  }
+  return inputs;
+}
+
 double TreeStructuredParzenEstimator::compute_log_likelihood_ratio(const Input & input) const
 {
   const int64_t n = trials_.size();
@@ -63,3 +63,44 @@ TEST(TreeStructuredParzenEstimatorTest, TPE_is_better_than_random_search_on_sphe
   }
   ASSERT_LT(mean_scores[0], mean_scores[1]);
 }
+
+TEST(TreeStructuredParzenEstimatorTest, batched_TPE_is_better_than_random_search_on_sphere_function)
+{
+  auto sphere_function = [](const TreeStructuredParzenEstimator::Input & input) {
+    double value = 0.0;
+    const int64_t n = input.size();
+    for (int64_t i = 0; i < n; i++) {
+      const double v = input[i] * 10;
+      value += v * v;
+    }
+    return value;
+  };
+
+  constexpr int64_t kOuterTrialsNum = 10;
+  constexpr int64_t kInnerTrialsNum = 100;
+  constexpr int64_t kBatchSize = 4;
+  std::vector<double> mean_scores;
+  for (const int64_t n_startup_trials : {kInnerTrialsNum, kInnerTrialsNum / 10}) {
+    double sum = 0.0;
+    for (int64_t i = 0; i < kOuterTrialsNum; i++) {
+      double best_score = std::numeric_limits<double>::lowest();
+      const std::vector<bool> is_loop_variable(6, false);
+      TreeStructuredParzenEstimator estimator(
+        TreeStructuredParzenEstimator::Direction::MAXIMIZE, n_startup_trials, is_loop_variable);
+      for (int64_t trial = 0; trial < kInnerTrialsNum; trial += kBatchSize) {
+        const std::vector<TreeStructuredParzenEstimator::Input> inputs =
+          estimator.get_next_inputs(kBatchSize);
+        ASSERT_EQ(static_cast<int64_t>(inputs.size()), kBatchSize);
+        for (const auto & input : inputs) {
+          ASSERT_EQ(input.size(), is_loop_variable.size());
+          const double score = -sphere_function(input);
+          estimator.add_trial({input, score});
+          best_score = std::max(best_score, score);
+        }
+      }
+      sum += best_score;
+    }
+    mean_scores.push_back(sum / kOuterTrialsNum);
+  }
+  ASSERT_LT(mean_scores[0], mean_scores[1]);
+}
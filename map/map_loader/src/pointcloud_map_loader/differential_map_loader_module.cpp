@@ -14,9 +14,16 @@
 
 #include "differential_map_loader_module.hpp"
 
+#include <string>
+#include <utility>
+#include <vector>
+
 DifferentialMapLoaderModule::DifferentialMapLoaderModule(
-  rclcpp::Node * node, const std::map<std::string, PCDFileMetadata> & pcd_file_metadata_dict)
-: logger_(node->get_logger()), all_pcd_file_metadata_dict_(pcd_file_metadata_dict)
+  rclcpp::Node * node, const std::map<std::string, PCDFileMetadata> & pcd_file_metadata_dict,
+  const std::shared_ptr<const PCDCellLoader> & cell_loader)
+: logger_(node->get_logger()),
+  all_pcd_file_metadata_dict_(pcd_file_metadata_dict),
+  cell_loader_(cell_loader)
 {
   get_differential_pcd_maps_service_ = node->create_service<GetDifferentialPointCloudMap>(
     "service/get_differential_pcd_map",
@@ -31,6 +38,7 @@ void DifferentialMapLoaderModule::differentialAreaLoad(
 {
   // iterate over all the available pcd map grids
   std::vector<bool> should_remove(static_cast<int>(cached_ids.size()), true);
+  std::vector<std::pair<std::string, PCDFileMetadata>> cells_to_load;
   for (const auto & ele : all_pcd_file_metadata_dict_) {
     std::string path = ele.first;
     PCDFileMetadata metadata = ele.second;
@@ -46,16 +54,24 @@ void DifferentialMapLoaderModule::differentialAreaLoad(
       int index = id_in_cached_list - cached_ids.begin();
       should_remove[index] = false;
     } else {
-      autoware_map_msgs::msg::PointCloudMapCellWithID pointcloud_map_cell_with_id =
-        loadPointCloudMapCellWithID(path, map_id);
-      pointcloud_map_cell_with_id.metadata.min_x = metadata.min.x;
-      pointcloud_map_cell_with_id.metadata.min_y = metadata.min.y;
-      pointcloud_map_cell_with_id.metadata.max_x = metadata.max.x;
-      pointcloud_map_cell_with_id.metadata.max_y = metadata.max.y;
-      response->new_pointcloud_with_ids.push_back(pointcloud_map_cell_with_id);
+      cells_to_load.emplace_back(path, metadata);
     }
   }
 
+  // load the new cells concurrently, keeping the order of the metadata
+  response->new_pointcloud_with_ids.resize(cells_to_load.size());
+  cell_loader_->parallelFor(cells_to_load.size(), [&](const size_t i) {
+    const auto & [path, metadata] = cells_to_load[i];
+    const std::string & map_id = path;
+    autoware_map_msgs::msg::PointCloudMapCellWithID & pointcloud_map_cell_with_id =
+      response->new_pointcloud_with_ids[i];
+    pointcloud_map_cell_with_id = loadPointCloudMapCellWithID(path, map_id);
+    pointcloud_map_cell_with_id.metadata.min_x = metadata.min.x;
+    pointcloud_map_cell_with_id.metadata.min_y = metadata.min.y;
+    pointcloud_map_cell_with_id.metadata.max_x = metadata.max.x;
+    pointcloud_map_cell_with_id.metadata.max_y = metadata.max.y;
+  });
+
   for (size_t i = 0; i < cached_ids.size(); ++i) {
     if (should_remove[i]) {
       response->ids_to_remove.push_back(cached_ids[i]);
@@ -79,7 +95,7 @@ DifferentialMapLoaderModule::loadPointCloudMapCellWithID(
   const std::string & path, const std::string & map_id) const
 {
   sensor_msgs::msg::PointCloud2 pcd;
-  if (pcl::io::loadPCDFile(path, pcd) == -1) {
+  if (!cell_loader_->load(path, pcd)) {
     RCLCPP_ERROR_STREAM(logger_, "PCD load failed: " << path);
   }
   autoware_map_msgs::msg::PointCloudMapCellWithID pointcloud_map_cell_with_id;
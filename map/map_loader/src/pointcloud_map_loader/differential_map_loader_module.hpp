@@ -15,6 +15,7 @@
 #ifndef POINTCLOUD_MAP_LOADER__DIFFERENTIAL_MAP_LOADER_MODULE_HPP_
 #define POINTCLOUD_MAP_LOADER__DIFFERENTIAL_MAP_LOADER_MODULE_HPP_
 
+#include "pcd_cell_loader.hpp"
 #include "utils.hpp"
 
 #include <rclcpp/rclcpp.hpp>
@@ -29,6 +30,7 @@
 #include <pcl_conversions/pcl_conversions.h>
 
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -38,12 +40,15 @@ class DifferentialMapLoaderModule
 
 public:
   explicit DifferentialMapLoaderModule(
-    rclcpp::Node * node, const std::map<std::string, PCDFileMetadata> & pcd_file_metadata_dict);
+    rclcpp::Node * node, const std::map<std::string, PCDFileMetadata> & pcd_file_metadata_dict,
+    const std::shared_ptr<const PCDCellLoader> & cell_loader =
+      std::make_shared<const PCDCellLoader>());
 
 private:
   rclcpp::Logger logger_;
 
   std::map<std::string, PCDFileMetadata> all_pcd_file_metadata_dict_;
+  std::shared_ptr<const PCDCellLoader> cell_loader_;
   rclcpp::Service<GetDifferentialPointCloudMap>::SharedPtr get_differential_pcd_maps_service_;
 
   bool onServiceGetDifferentialPointCloudMap(
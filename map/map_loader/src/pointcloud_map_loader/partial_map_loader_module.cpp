@@ -14,9 +14,16 @@
 
 #include "partial_map_loader_module.hpp"
 
+#include <string>
+#include <utility>
+#include <vector>
+
 PartialMapLoaderModule::PartialMapLoaderModule(
-  rclcpp::Node * node, const std::map<std::string, PCDFileMetadata> & pcd_file_metadata_dict)
-: logger_(node->get_logger()), all_pcd_file_metadata_dict_(pcd_file_metadata_dict)
+  rclcpp::Node * node, const std::map<std::string, PCDFileMetadata> & pcd_file_metadata_dict,
+  const std::shared_ptr<const PCDCellLoader> & cell_loader)
+: logger_(node->get_logger()),
+  all_pcd_file_metadata_dict_(pcd_file_metadata_dict),
+  cell_loader_(cell_loader)
 {
   get_partial_pcd_maps_service_ = node->create_service<GetPartialPointCloudMap>(
     "service/get_partial_pcd_map", std::bind(
@@ -29,25 +36,30 @@ void PartialMapLoaderModule::partialAreaLoad(
   GetPartialPointCloudMap::Response::SharedPtr & response) const
 {
   // iterate over all the available pcd map grids
+  std::vector<std::pair<std::string, PCDFileMetadata>> cells_to_load;
   for (const auto & ele : all_pcd_file_metadata_dict_) {
-    std::string path = ele.first;
-    PCDFileMetadata metadata = ele.second;
+    // skip if the pcd file is not within the queried area
+    if (!isGridWithinQueriedArea(area, ele.second)) continue;
 
-    // assume that the map ID = map path (for now)
-    std::string map_id = path;
+    cells_to_load.emplace_back(ele.first, ele.second);
+  }
 
-    // skip if the pcd file is not within the queried area
-    if (!isGridWithinQueriedArea(area, metadata)) continue;
+  // load the cells concurrently, keeping the order of the metadata
+  response->new_pointcloud_with_ids.resize(cells_to_load.size());
+  cell_loader_->parallelFor(cells_to_load.size(), [&](const size_t i) {
+    const auto & [path, metadata] = cells_to_load[i];
 
-    autoware_map_msgs::msg::PointCloudMapCellWithID pointcloud_map_cell_with_id =
-      loadPointCloudMapCellWithID(path, map_id);
+    // assume that the map ID = map path (for now)
+    const std::string & map_id = path;
+
+    autoware_map_msgs::msg::PointCloudMapCellWithID & pointcloud_map_cell_with_id =
+      response->new_pointcloud_with_ids[i];
+    pointcloud_map_cell_with_id = loadPointCloudMapCellWithID(path, map_id);
     pointcloud_map_cell_with_id.metadata.min_x = metadata.min.x;
     pointcloud_map_cell_with_id.metadata.min_y = metadata.min.y;
     pointcloud_map_cell_with_id.metadata.max_x = metadata.max.x;
     pointcloud_map_cell_with_id.metadata.max_y = metadata.max.y;
-
-    response->new_pointcloud_with_ids.push_back(pointcloud_map_cell_with_id);
-  }
+  });
 }
 
 bool PartialMapLoaderModule::onServiceGetPartialPointCloudMap(
@@ -63,7 +75,7 @@ autoware_map_msgs::msg::PointCloudMapCellWithID PartialMapLoaderModule::loadPoin
   const std::string & path, const std::string & map_id) const
 {
   sensor_msgs::msg::PointCloud2 pcd;
-  if (pcl::io::loadPCDFile(path, pcd) == -1) {
+  if (!cell_loader_->load(path, pcd)) {
     RCLCPP_ERROR_STREAM(logger_, "PCD load failed: " << path);
   }
   autoware_map_msgs::msg::PointCloudMapCellWithID pointcloud_map_cell_with_id;
@@ -0,0 +1,208 @@
+// Copyright 2024 The Autoware Contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "pcd_cell_loader.hpp"
+
+#include <pcl/io/pcd_io.h>
+#include <pcl_conversions/pcl_conversions.h>
+#include <yaml-cpp/yaml.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+std::string dataFilePath(const std::string & cell_index_path)
+{
+  return fs::path(cell_index_path).replace_extension(".bin").string();
+}
+
+std::string directoryPath(const std::string & cell_index_path)
+{
+  return fs::absolute(cell_index_path).parent_path().string();
+}
+}  // namespace
+
+std::string cellKey(const std::string & pcd_path, const std::string & cell_index_directory)
+{
+  return fs::absolute(pcd_path)
+    .lexically_normal()
+    .lexically_relative(fs::path(cell_index_directory).lexically_normal())
+    .generic_string();
+}
+
+PCDCellLoader::PCDCellLoader(const std::string & cell_index_path, const int num_threads)
+: num_threads_(num_threads)
+{
+  if (!cell_index_path.empty()) {
+    loadCellPack(cell_index_path);
+  }
+}
+
+PCDCellLoader::~PCDCellLoader()
+{
+  if (data_ != nullptr) {
+    munmap(const_cast<uint8_t *>(data_), data_size_);
+  }
+}
+
+void PCDCellLoader::loadCellPack(const std::string & cell_index_path)
+{
+  const YAML::Node index = YAML::LoadFile(cell_index_path);
+  cell_index_directory_ = directoryPath(cell_index_path);
+  point_step_ = index["point_step"].as<uint32_t>();
+  for (const auto & field_node : index["fields"]) {
+    sensor_msgs::msg::PointField field;
+    field.name = field_node["name"].as<std::string>();
+    field.offset = field_node["offset"].as<uint32_t>();
+    field.datatype = static_cast<uint8_t>(field_node["datatype"].as<int>());
+    field.count = field_node["count"].as<uint32_t>();
+    fields_.push_back(field);
+  }
+
+  const std::string data_path = dataFilePath(cell_index_path);
+  const int fd = open(data_path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error("Cell pack data file not found: " + data_path);
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0) {
+    close(fd);
+    throw std::runtime_error("Failed to read the size of the cell pack: " + data_path);
+  }
+  data_size_ = static_cast<size_t>(file_stat.st_size);
+  if (data_size_ > 0) {
+    void * data = mmap(nullptr, data_size_, PROT_READ, MAP_SHARED, fd, 0);
+    if (data == MAP_FAILED) {
+      close(fd);
+      throw std::runtime_error("Failed to map the cell pack: " + data_path);
+    }
+    data_ = static_cast<const uint8_t *>(data);
+  }
+  // The mapping stays valid after the file descriptor is closed
+  close(fd);
+
+  for (const auto & cell_node : index["cells"]) {
+    const auto values = cell_node.second.as<std::vector<size_t>>();
+    const PackedCell cell{values.at(0), static_cast<uint32_t>(values.at(1))};
+    if (cell.offset + static_cast<size_t>(cell.width) * point_step_ > data_size_) {
+      throw std::runtime_error(
+        "Cell " + cell_node.first.as<std::string>() + " is out of the cell pack: " + data_path);
+    }
+    cells_[cell_node.first.as<std::string>()] = cell;
+  }
+}
+
+bool PCDCellLoader::load(const std::string & path, sensor_msgs::msg::PointCloud2 & cloud) const
+{
+  const auto it =
+    cells_.empty() ? cells_.end() : cells_.find(cellKey(path, cell_index_directory_));
+  if (it == cells_.end()) {
+    return pcl::io::loadPCDFile(path, cloud) != -1;
+  }
+
+  const PackedCell & cell = it->second;
+  cloud.height = 1;
+  cloud.width = cell.width;
+  cloud.fields = fields_;
+  cloud.is_bigendian = false;
+  cloud.point_step = point_step_;
+  cloud.row_step = point_step_ * cell.width;
+  cloud.is_dense = false;
+  cloud.data.resize(cloud.row_step);
+  std::memcpy(cloud.data.data(), data_ + cell.offset, cloud.row_step);
+  return true;
+}
+
+void writeCellPack(const std::vector<std::string> & pcd_paths, const std::string & cell_index_path)
+{
+  const std::string data_path = dataFilePath(cell_index_path);
+  std::ofstream data_file(data_path, std::ios::binary | std::ios::trunc);
+  if (!data_file) {
+    throw std::runtime_error("Failed to open " + data_path);
+  }
+
+  const std::string cell_index_directory = directoryPath(cell_index_path);
+  YAML::Node cells(YAML::NodeType::Map);
+  std::unordered_set<std::string> keys;
+  std::vector<sensor_msgs::msg::PointField> fields;
+  uint32_t point_step = 0;
+  size_t offset = 0;
+  sensor_msgs::msg::PointCloud2 cloud;
+  for (const auto & path : pcd_paths) {
+    if (pcl::io::loadPCDFile(path, cloud) == -1) {
+      throw std::runtime_error("PCD load failed: " + path);
+    }
+    if (fields.empty()) {
+      fields = cloud.fields;
+      point_step = cloud.point_step;
+    } else if (cloud.fields != fields || cloud.point_step != point_step) {
+      throw std::runtime_error("PCD fields differ from the other cells: " + path);
+    }
+    const size_t num_points = static_cast<size_t>(cloud.width) * cloud.height;
+    const size_t size = num_points * point_step;
+    const std::string key = cellKey(path, cell_index_directory);
+    if (!keys.insert(key).second) {
+      throw std::runtime_error("PCD file listed twice: " + path);
+    }
+    data_file.write(reinterpret_cast<const char *>(cloud.data.data()), size);
+    if (!data_file) {
+      throw std::runtime_error("Failed to write " + data_path);
+    }
+
+    YAML::Node cell(YAML::NodeType::Sequence);
+    cell.SetStyle(YAML::EmitterStyle::Flow);
+    cell.push_back(offset);
+    cell.push_back(num_points);
+    cells[key] = cell;
+    offset += size;
+  }
+  data_file.close();
+  if (!data_file) {
+    throw std::runtime_error("Failed to write " + data_path);
+  }
+
+  YAML::Node index(YAML::NodeType::Map);
+  index["point_step"] = point_step;
+  index["fields"] = YAML::Node(YAML::NodeType::Sequence);
+  for (const auto & field : fields) {
+    YAML::Node field_node(YAML::NodeType::Map);
+    field_node.SetStyle(YAML::EmitterStyle::Flow);
+    field_node["name"] = field.name;
+    field_node["offset"] = field.offset;
+    field_node["datatype"] = static_cast<int>(field.datatype);
+    field_node["count"] = field.count;
+    index["fields"].push_back(field_node);
+  }
+  index["cells"] = cells;
+
+  std::ofstream index_file(cell_index_path, std::ios::trunc);
+  index_file << index << std::endl;
+  index_file.close();
+  if (!index_file) {
+    throw std::runtime_error("Failed to write " + cell_index_path);
+  }
+}
@@ -0,0 +1,103 @@
+// Copyright 2024 The Autoware Contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef POINTCLOUD_MAP_LOADER__PCD_CELL_LOADER_HPP_
+#define POINTCLOUD_MAP_LOADER__PCD_CELL_LOADER_HPP_
+
+#include <sensor_msgs/msg/point_cloud2.hpp>
+#include <sensor_msgs/msg/point_field.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Loads the PCD map cells, either from the PCD files or from a cell pack.
+//
+// A cell pack is a preconverted copy of the cells: a binary data file holding the point data of
+// every cell back to back, in the PointCloud2 layout, and a YAML index file that gives the field
+// layout and the offset and the number of points of each cell. The data file is memory-mapped,
+// so a cell is served by copying its bytes into the message, without parsing the PCD file.
+// Cells are looked up by the path of their PCD file relative to the directory of the index file,
+// so that PCD files with the same name in different directories are different cells. The cells
+// missing from the pack are read from their PCD file.
+class PCDCellLoader
+{
+public:
+  explicit PCDCellLoader(const std::string & cell_index_path = "", const int num_threads = 1);
+  ~PCDCellLoader();
+  PCDCellLoader(const PCDCellLoader &) = delete;
+  PCDCellLoader & operator=(const PCDCellLoader &) = delete;
+
+  // Return false if the cell could not be loaded
+  bool load(const std::string & path, sensor_msgs::msg::PointCloud2 & cloud) const;
+
+  // Call func(i) for i in [0, n) on up to num_threads threads
+  template <typename Func>
+  void parallelFor(const size_t n, Func && func) const
+  {
+    const size_t num_workers = std::min(static_cast<size_t>(std::max(num_threads_, 1)), n);
+    if (num_workers <= 1) {
+      for (size_t i = 0; i < n; ++i) {
+        func(i);
+      }
+      return;
+    }
+    std::atomic<size_t> next_index{0};
+    std::vector<std::thread> workers;
+    workers.reserve(num_workers);
+    for (size_t w = 0; w < num_workers; ++w) {
+      workers.emplace_back([&]() {
+        for (size_t i = next_index++; i < n; i = next_index++) {
+          func(i);
+        }
+      });
+    }
+    for (auto & worker : workers) {
+      worker.join();
+    }
+  }
+
+  size_t packedCellNum() const { return cells_.size(); }
+  int numThreads() const { return num_threads_; }
+
+private:
+  struct PackedCell
+  {
+    size_t offset;
+    uint32_t width;
+  };
+
+  int num_threads_;
+  std::string cell_index_directory_;
+  std::unordered_map<std::string, PackedCell> cells_;
+  std::vector<sensor_msgs::msg::PointField> fields_;
+  uint32_t point_step_{0};
+  const uint8_t * data_{nullptr};
+  size_t data_size_{0};
+
+  void loadCellPack(const std::string & cell_index_path);
+};
+
+// Write the cell pack of the given PCD files: `cell_index_path` and a data file with the same
+// name and the ".bin" extension next to it. All the PCD files must have the same fields.
+// Throws std::runtime_error if a PCD file cannot be read or the cell pack cannot be written.
+void writeCellPack(const std::vector<std::string> & pcd_paths, const std::string & cell_index_path);
+
+// Key of a PCD file in the cell pack: its path relative to the directory of the index file
+std::string cellKey(const std::string & pcd_path, const std::string & cell_index_directory);
+
+#endif  // POINTCLOUD_MAP_LOADER__PCD_CELL_LOADER_HPP_
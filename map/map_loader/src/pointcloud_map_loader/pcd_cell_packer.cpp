@@ -0,0 +1,57 @@
+// Copyright 2024 The Autoware Contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Converts the PCD files listed in a PCD metadata file into a cell pack for PCDCellLoader.
+//
+// usage: pcd_cell_packer <pcd_metadata.yaml> <pcd_directory> [<cell_index.yaml>]
+//
+// The cell index is written next to the metadata file as "pointcloud_map_cells.yaml" by default,
+// and the data file next to the cell index, with the ".bin" extension.
+
+#include "pcd_cell_loader.hpp"
+#include "utils.hpp"
+
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+int main(int argc, char ** argv)
+{
+  if (argc < 3 || argc > 4) {
+    std::cerr << "usage: " << argv[0] << " <pcd_metadata.yaml> <pcd_directory> [<cell_index.yaml>]"
+              << std::endl;
+    return 1;
+  }
+  const std::string pcd_metadata_path = argv[1];
+  const fs::path pcd_directory = argv[2];
+  const std::string cell_index_path =
+    argc == 4 ? std::string(argv[3])
+              : (fs::path(pcd_metadata_path).parent_path() / "pointcloud_map_cells.yaml").string();
+
+  try {
+    std::vector<std::string> pcd_paths;
+    for (const auto & [file_name, metadata] : loadPCDMetadata(pcd_metadata_path)) {
+      pcd_paths.push_back((pcd_directory / file_name).string());
+    }
+    writeCellPack(pcd_paths, cell_index_path);
+    std::cout << "Packed " << pcd_paths.size() << " cells into " << cell_index_path << std::endl;
+  } catch (std::exception & e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -18,7 +18,9 @@
 
 #include <fmt/format.h>
 
+#include <algorithm>
 #include <string>
+#include <utility>
 #include <vector>
 
 sensor_msgs::msg::PointCloud2 downsample(
@@ -40,8 +42,9 @@ sensor_msgs::msg::PointCloud2 downsample(
 
 PointcloudMapLoaderModule::PointcloudMapLoaderModule(
   rclcpp::Node * node, const std::vector<std::string> & pcd_paths,
-  const std::string & publisher_name, const bool use_downsample)
-: logger_(node->get_logger())
+  const std::string & publisher_name, const bool use_downsample,
+  const std::shared_ptr<const PCDCellLoader> & cell_loader)
+: logger_(node->get_logger()), cell_loader_(cell_loader)
 {
   rclcpp::QoS durable_qos{1};
   durable_qos.transient_local();
@@ -69,29 +72,42 @@ sensor_msgs::msg::PointCloud2 PointcloudMapLoaderModule::loadPCDFiles(
   const std::vector<std::string> & pcd_paths, const boost::optional<float> leaf_size) const
 {
   sensor_msgs::msg::PointCloud2 whole_pcd;
-  sensor_msgs::msg::PointCloud2 partial_pcd;
 
-  for (size_t i = 0; i < pcd_paths.size(); ++i) {
-    auto & path = pcd_paths[i];
-    if (i % 50 == 0) {
-      RCLCPP_DEBUG_STREAM(
-        logger_, fmt::format("Load {} ({} out of {})", path, i + 1, pcd_paths.size()));
-    }
-
-    if (pcl::io::loadPCDFile(path, partial_pcd) == -1) {
-      RCLCPP_ERROR_STREAM(logger_, "PCD load failed: " << path);
-    }
-
-    if (leaf_size) {
-      partial_pcd = downsample(partial_pcd, leaf_size.get());
-    }
-
-    if (whole_pcd.width == 0) {
-      whole_pcd = partial_pcd;
-    } else {
-      whole_pcd.width += partial_pcd.width;
-      whole_pcd.row_step += partial_pcd.row_step;
-      whole_pcd.data.insert(whole_pcd.data.end(), partial_pcd.data.begin(), partial_pcd.data.end());
+  // The cells are loaded (and downsampled) concurrently in chunks, and appended in the order of
+  // pcd_paths. The chunk bounds the number of cells held in memory besides whole_pcd.
+  const size_t chunk_size = 4 * static_cast<size_t>(std::max(cell_loader_->numThreads(), 1));
+  std::vector<sensor_msgs::msg::PointCloud2> partial_pcds(chunk_size);
+  for (size_t chunk_begin = 0; chunk_begin < pcd_paths.size(); chunk_begin += chunk_size) {
+    const size_t chunk_end = std::min(chunk_begin + chunk_size, pcd_paths.size());
+    cell_loader_->parallelFor(chunk_end - chunk_begin, [&](const size_t j) {
+      const size_t i = chunk_begin + j;
+      auto & path = pcd_paths[i];
+      if (i % 50 == 0) {
+        RCLCPP_DEBUG_STREAM(
+          logger_, fmt::format("Load {} ({} out of {})", path, i + 1, pcd_paths.size()));
+      }
+
+      auto & partial_pcd = partial_pcds[j];
+      partial_pcd = sensor_msgs::msg::PointCloud2();
+      if (!cell_loader_->load(path, partial_pcd)) {
+        RCLCPP_ERROR_STREAM(logger_, "PCD load failed: " << path);
+      }
+
+      if (leaf_size) {
+        partial_pcd = downsample(partial_pcd, leaf_size.get());
+      }
+    });
+
+    for (size_t j = 0; j < chunk_end - chunk_begin; ++j) {
+      auto & partial_pcd = partial_pcds[j];
+      if (whole_pcd.width == 0) {
+        whole_pcd = std::move(partial_pcd);
+      } else {
+        whole_pcd.width += partial_pcd.width;
+        whole_pcd.row_step += partial_pcd.row_step;
+        whole_pcd.data.insert(
+          whole_pcd.data.end(), partial_pcd.data.begin(), partial_pcd.data.end());
+      }
     }
   }
 
@@ -15,6 +15,8 @@
 #ifndef POINTCLOUD_MAP_LOADER__POINTCLOUD_MAP_LOADER_MODULE_HPP_
 #define POINTCLOUD_MAP_LOADER__POINTCLOUD_MAP_LOADER_MODULE_HPP_
 
+#include "pcd_cell_loader.hpp"
+
 #include <rclcpp/rclcpp.hpp>
 
 #include <sensor_msgs/msg/point_cloud2.hpp>
@@ -25,6 +27,7 @@
 #include <pcl/io/pcd_io.h>
 #include <pcl_conversions/pcl_conversions.h>
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -33,10 +36,13 @@ class PointcloudMapLoaderModule
 public:
   explicit PointcloudMapLoaderModule(
     rclcpp::Node * node, const std::vector<std::string> & pcd_paths,
-    const std::string & publisher_name, const bool use_downsample);
+    const std::string & publisher_name, const bool use_downsample,
+    const std::shared_ptr<const PCDCellLoader> & cell_loader =
+      std::make_shared<const PCDCellLoader>());
 
 private:
   rclcpp::Logger logger_;
+  std::shared_ptr<const PCDCellLoader> cell_loader_;
   rclcpp::Publisher<sensor_msgs::msg::PointCloud2>::SharedPtr pub_pointcloud_map_;
 
   sensor_msgs::msg::PointCloud2 loadPCDFiles(
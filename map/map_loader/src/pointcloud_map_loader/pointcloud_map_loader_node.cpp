@@ -54,17 +54,33 @@ PointCloudMapLoaderNode::PointCloudMapLoaderNode(const rclcpp::NodeOptions & opt
   bool enable_downsample_whole_load = declare_parameter<bool>("enable_downsampled_whole_load");
   bool enable_partial_load = declare_parameter<bool>("enable_partial_load");
   bool enable_selected_load = declare_parameter<bool>("enable_selected_load");
+  const std::string pcd_cell_index_path = declare_parameter<std::string>("pcd_cell_index_path");
+  const int num_load_threads = static_cast<int>(declare_parameter<int64_t>("num_load_threads"));
+
+  std::shared_ptr<const PCDCellLoader> cell_loader;
+  try {
+    cell_loader = std::make_shared<const PCDCellLoader>(pcd_cell_index_path, num_load_threads);
+  } catch (std::exception & e) {
+    RCLCPP_ERROR_STREAM(
+      get_logger(), "Failed to load the PCD cell pack. The PCD files are used instead: "
+                      << e.what());
+    cell_loader = std::make_shared<const PCDCellLoader>("", num_load_threads);
+  }
+  if (cell_loader->packedCellNum() > 0) {
+    RCLCPP_INFO_STREAM(
+      get_logger(), "Serve " << cell_loader->packedCellNum() << " cells from the PCD cell pack");
+  }
 
   if (enable_whole_load) {
     std::string publisher_name = "output/pointcloud_map";
-    pcd_map_loader_ =
-      std::make_unique<PointcloudMapLoaderModule>(this, pcd_paths, publisher_name, false);
+    pcd_map_loader_ = std::make_unique<PointcloudMapLoaderModule>(
+      this, pcd_paths, publisher_name, false, cell_loader);
   }
 
   if (enable_downsample_whole_load) {
     std::string publisher_name = "output/debug/downsampled_pointcloud_map";
-    downsampled_pcd_map_loader_ =
-      std::make_unique<PointcloudMapLoaderModule>(this, pcd_paths, publisher_name, true);
+    downsampled_pcd_map_loader_ = std::make_unique<PointcloudMapLoaderModule>(
+      this, pcd_paths, publisher_name, true, cell_loader);
   }
 
   std::map<std::string, PCDFileMetadata> pcd_metadata_dict;
@@ -75,13 +91,16 @@ PointCloudMapLoaderNode::PointCloudMapLoaderNode(const rclcpp::NodeOptions & opt
   }
 
   if (enable_partial_load) {
-    partial_map_loader_ = std::make_unique<PartialMapLoaderModule>(this, pcd_metadata_dict);
+    partial_map_loader_ =
+      std::make_unique<PartialMapLoaderModule>(this, pcd_metadata_dict, cell_loader);
   }
 
-  differential_map_loader_ = std::make_unique<DifferentialMapLoaderModule>(this, pcd_metadata_dict);
+  differential_map_loader_ =
+    std::make_unique<DifferentialMapLoaderModule>(this, pcd_metadata_dict, cell_loader);
 
   if (enable_selected_load) {
-    selected_map_loader_ = std::make_unique<SelectedMapLoaderModule>(this, pcd_metadata_dict);
+    selected_map_loader_ =
+      std::make_unique<SelectedMapLoaderModule>(this, pcd_metadata_dict, cell_loader);
   }
 }
 
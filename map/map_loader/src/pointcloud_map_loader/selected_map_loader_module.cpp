@@ -13,6 +13,11 @@
 // limitations under the License.
 
 #include "selected_map_loader_module.hpp"
+
+#include <string>
+#include <utility>
+#include <vector>
+
 namespace
 {
 autoware_map_msgs::msg::PointCloudMapMetaData createMetadata(
@@ -44,8 +49,11 @@ autoware_map_msgs::msg::PointCloudMapMetaData createMetadata(
 }  // namespace
 
 SelectedMapLoaderModule::SelectedMapLoaderModule(
-  rclcpp::Node * node, const std::map<std::string, PCDFileMetadata> & pcd_file_metadata_dict)
-: logger_(node->get_logger()), all_pcd_file_metadata_dict_(pcd_file_metadata_dict)
+  rclcpp::Node * node, const std::map<std::string, PCDFileMetadata> & pcd_file_metadata_dict,
+  const std::shared_ptr<const PCDCellLoader> & cell_loader)
+: logger_(node->get_logger()),
+  all_pcd_file_metadata_dict_(pcd_file_metadata_dict),
+  cell_loader_(cell_loader)
 {
   get_selected_pcd_maps_service_ = node->create_service<GetSelectedPointCloudMap>(
     "service/get_selected_pcd_map", std::bind(
@@ -65,6 +73,7 @@ bool SelectedMapLoaderModule::onServiceGetSelectedPointCloudMap(
   GetSelectedPointCloudMap::Response::SharedPtr res) const
 {
   const auto request_ids = req->cell_ids;
+  std::vector<std::pair<std::string, PCDFileMetadata>> cells_to_load;
   for (const auto & request_id : request_ids) {
     const auto requested_selected_map_iterator = all_pcd_file_metadata_dict_.find(request_id);
 
@@ -74,20 +83,24 @@ bool SelectedMapLoaderModule::onServiceGetSelectedPointCloudMap(
       continue;
     }
 
-    const std::string path = requested_selected_map_iterator->first;
+    cells_to_load.emplace_back(*requested_selected_map_iterator);
+  }
+
+  // load the cells concurrently, keeping the order of the request
+  res->new_pointcloud_with_ids.resize(cells_to_load.size());
+  cell_loader_->parallelFor(cells_to_load.size(), [&](const size_t i) {
+    const auto & [path, metadata] = cells_to_load[i];
     // assume that the map ID = map path (for now)
-    const std::string map_id = path;
-    PCDFileMetadata metadata = requested_selected_map_iterator->second;
+    const std::string & map_id = path;
 
-    autoware_map_msgs::msg::PointCloudMapCellWithID pointcloud_map_cell_with_id =
-      loadPointCloudMapCellWithID(path, map_id);
+    autoware_map_msgs::msg::PointCloudMapCellWithID & pointcloud_map_cell_with_id =
+      res->new_pointcloud_with_ids[i];
+    pointcloud_map_cell_with_id = loadPointCloudMapCellWithID(path, map_id);
     pointcloud_map_cell_with_id.metadata.min_x = metadata.min.x;
     pointcloud_map_cell_with_id.metadata.min_y = metadata.min.y;
     pointcloud_map_cell_with_id.metadata.max_x = metadata.max.x;
     pointcloud_map_cell_with_id.metadata.max_y = metadata.max.y;
-
-    res->new_pointcloud_with_ids.push_back(pointcloud_map_cell_with_id);
-  }
+  });
   res->header.frame_id = "map";
   return true;
 }
@@ -97,7 +110,7 @@ SelectedMapLoaderModule::loadPointCloudMapCellWithID(
   const std::string & path, const std::string & map_id) const
 {
   sensor_msgs::msg::PointCloud2 pcd;
-  if (pcl::io::loadPCDFile(path, pcd) == -1) {
+  if (!cell_loader_->load(path, pcd)) {
     RCLCPP_ERROR_STREAM(logger_, "PCD load failed: " << path);
   }
   autoware_map_msgs::msg::PointCloudMapCellWithID pointcloud_map_cell_with_id;
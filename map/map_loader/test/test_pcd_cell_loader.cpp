@@ -0,0 +1,128 @@
+// Copyright 2024 The Autoware Contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "../src/pointcloud_map_loader/pcd_cell_loader.hpp"
+
+#include <gmock/gmock.h>
+#include <pcl/io/pcd_io.h>
+#include <pcl/point_types.h>
+#include <pcl_conversions/pcl_conversions.h>
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+class TestPCDCellLoader : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    // Generate dummy cells of different sizes
+    for (int i = 0; i < 3; ++i) {
+      pcl::PointCloud<pcl::PointXYZI> cloud;
+      for (int j = 0; j <= i * 10; ++j) {
+        pcl::PointXYZI point;
+        point.x = static_cast<float>(i * 20 + j);
+        point.y = static_cast<float>(j);
+        point.z = static_cast<float>(-j);
+        point.intensity = static_cast<float>(i);
+        cloud.push_back(point);
+      }
+      const std::string path =
+        (fs::temp_directory_path() / ("cell_" + std::to_string(i) + ".pcd")).string();
+      pcl::io::savePCDFileBinary(path, cloud);
+      pcd_paths_.push_back(path);
+    }
+    cell_index_path_ = (fs::temp_directory_path() / "test_pointcloud_map_cells.yaml").string();
+  }
+
+  std::vector<std::string> pcd_paths_;
+  std::string cell_index_path_;
+};
+
+TEST_F(TestPCDCellLoader, LoadFromCellPackMatchesPCD)
+{
+  // Pack the first two cells only
+  writeCellPack({pcd_paths_[0], pcd_paths_[1]}, cell_index_path_);
+  const PCDCellLoader cell_loader(cell_index_path_);
+  EXPECT_EQ(cell_loader.packedCellNum(), 2u);
+
+  for (const auto & path : pcd_paths_) {
+    sensor_msgs::msg::PointCloud2 expected;
+    ASSERT_NE(pcl::io::loadPCDFile(path, expected), -1);
+
+    sensor_msgs::msg::PointCloud2 result;
+    ASSERT_TRUE(cell_loader.load(path, result));
+    EXPECT_EQ(result.width * result.height, expected.width * expected.height);
+    EXPECT_EQ(result.point_step, expected.point_step);
+    EXPECT_EQ(result.fields, expected.fields);
+    EXPECT_EQ(result.data, expected.data);
+  }
+}
+
+TEST_F(TestPCDCellLoader, SameFileNameInDifferentDirectories)
+{
+  // Two different cells with the same file name
+  const fs::path root = fs::temp_directory_path() / "test_pcd_cell_loader_directories";
+  fs::create_directories(root / "a");
+  fs::create_directories(root / "b");
+  const std::vector<std::string> paths = {
+    (root / "a" / "cell.pcd").string(), (root / "b" / "cell.pcd").string()};
+  fs::copy_file(pcd_paths_[1], paths[0], fs::copy_options::overwrite_existing);
+  fs::copy_file(pcd_paths_[2], paths[1], fs::copy_options::overwrite_existing);
+
+  const std::string cell_index_path = (root / "pointcloud_map_cells.yaml").string();
+  writeCellPack(paths, cell_index_path);
+  const PCDCellLoader cell_loader(cell_index_path);
+  EXPECT_EQ(cell_loader.packedCellNum(), 2u);
+
+  for (const auto & path : paths) {
+    sensor_msgs::msg::PointCloud2 expected;
+    ASSERT_NE(pcl::io::loadPCDFile(path, expected), -1);
+
+    sensor_msgs::msg::PointCloud2 result;
+    ASSERT_TRUE(cell_loader.load(path, result));
+    EXPECT_EQ(result.data, expected.data);
+  }
+}
+
+TEST_F(TestPCDCellLoader, ParallelForVisitsEveryIndexOnce)
+{
+  const PCDCellLoader cell_loader("", 4);
+  std::vector<int> visit_counts(100, 0);
+  cell_loader.parallelFor(visit_counts.size(), [&](const size_t i) { ++visit_counts[i]; });
+  EXPECT_THAT(visit_counts, ::testing::Each(1));
+}
+
+TEST_F(TestPCDCellLoader, UnwritableCellPackThrows)
+{
+  const std::string cell_index_path =
+    (fs::temp_directory_path() / "missing_directory" / "pointcloud_map_cells.yaml").string();
+  EXPECT_THROW(writeCellPack({pcd_paths_[0]}, cell_index_path), std::runtime_error);
+}
+
+TEST_F(TestPCDCellLoader, MissingDataFileThrows)
+{
+  writeCellPack({pcd_paths_[0]}, cell_index_path_);
+  fs::remove(fs::path(cell_index_path_).replace_extension(".bin"));
+  EXPECT_THROW(PCDCellLoader cell_loader(cell_index_path_), std::runtime_error);
+}
+
+int main(int argc, char ** argv)
+{
+  ::testing::InitGoogleMock(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,175 @@
+// Copyright 2024 TIER IV, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Compares the neighbor voxel search on the voxel grid with the search on the voxel hash map of
+// the static map loader, on a synthetic map.
+//
+// usage: voxel_grid_map_loader_benchmark [-r <repeats>]
+//
+// The map is a flat ground with walls along a straight road. The input points are scattered over
+// the whole map, half of them on the ground or the walls with noise, like the ground and the
+// buildings in a lidar scan, and the others in the air, like the obstacles to keep.
+
+#include "compare_map_segmentation/voxel_grid_map_loader.hpp"
+
+#include <pcl_conversions/pcl_conversions.h>
+#include <rclcpp/rclcpp.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
+
+using compare_map_segmentation::VoxelGridStaticMapLoader;
+
+constexpr float road_length = 400.0;   // [m]
+constexpr float road_width = 20.0;     // [m]
+constexpr float wall_height = 10.0;    // [m]
+constexpr float map_resolution = 0.1;  // [m]
+constexpr float point_noise = 0.05;    // [m]
+
+class BenchmarkMapLoader : public VoxelGridStaticMapLoader
+{
+public:
+  using VoxelGridStaticMapLoader::VoxelGridStaticMapLoader;
+
+  // The search of the static map loader before the voxel hash map
+  bool is_close_to_map_on_voxel_grid(const pcl::PointXYZ & point, const double distance_threshold)
+  {
+    return is_close_to_neighbor_voxels(point, distance_threshold, voxel_map_ptr_, voxel_grid_);
+  }
+
+  size_t map_voxel_num() const { return voxel_map_ptr_->size(); }
+};
+
+pcl::PointCloud<pcl::PointXYZ> make_map()
+{
+  pcl::PointCloud<pcl::PointXYZ> map;
+  for (float x = 0.0; x < road_length; x += map_resolution) {
+    for (float y = 0.0; y < road_width; y += map_resolution) {
+      map.push_back(pcl::PointXYZ(x, y, 0.0));
+    }
+    for (float z = 0.0; z < wall_height; z += map_resolution) {
+      map.push_back(pcl::PointXYZ(x, 0.0, z));
+      map.push_back(pcl::PointXYZ(x, road_width, z));
+    }
+  }
+  return map;
+}
+
+std::vector<pcl::PointXYZ> make_input_points(const size_t point_num, std::mt19937 & engine)
+{
+  std::uniform_real_distribution<float> x_distribution(0.0, road_length);
+  std::uniform_real_distribution<float> y_distribution(0.0, road_width);
+  std::uniform_real_distribution<float> z_distribution(0.0, wall_height);
+  std::uniform_int_distribution<int> surface_distribution(0, 3);
+  std::normal_distribution<float> noise_distribution(0.0, point_noise);
+
+  std::vector<pcl::PointXYZ> points;
+  for (size_t i = 0; i < point_num; ++i) {
+    const float x = x_distribution(engine);
+    switch (surface_distribution(engine)) {
+      case 0:  // ground
+        points.emplace_back(x, y_distribution(engine), noise_distribution(engine));
+        break;
+      case 1:  // wall
+        points.emplace_back(x, noise_distribution(engine), z_distribution(engine));
+        break;
+      default:  // obstacle
+        points.emplace_back(x, y_distribution(engine), 0.3 + z_distribution(engine));
+        break;
+    }
+  }
+  return points;
+}
+
+template <typename Func>
+double measure_ns_per_point(const size_t point_num, const int repeats, Func && func)
+{
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < repeats; ++i) {
+    func();
+  }
+  const auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(end - start).count() / repeats / point_num;
+}
+
+int main(int argc, char ** argv)
+{
+  rclcpp::init(argc, argv);
+  const auto args = rclcpp::remove_ros_arguments(argc, argv);
+
+  int repeats = 5;
+  for (size_t i = 1; i < args.size(); ++i) {
+    if (args.at(i) == "-r" && i + 1 < args.size()) {
+      repeats = std::max(std::atoi(args.at(++i).c_str()), 1);
+    } else {
+      std::fprintf(stderr, "usage: %s [-r <repeats>]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  rclcpp::NodeOptions node_options;
+  node_options.append_parameter_override("publish_debug_pcd", false);
+  std::string map_frame;
+  std::mutex mutex;
+  std::mt19937 engine(0);
+
+  std::printf(
+    "%10s  %10s  %14s  %14s  %8s  %s\n", "leaf size", "voxels", "grid [ns/pt]", "hash [ns/pt]",
+    "removed", "different results");
+  for (const double leaf_size : {0.5, 0.2}) {
+    // the map loader declares its parameters, so each one needs its own node
+    const auto node =
+      std::make_shared<rclcpp::Node>("voxel_grid_map_loader_benchmark", node_options);
+    BenchmarkMapLoader map_loader(node.get(), leaf_size, 0.5, &map_frame, &mutex);
+    auto map_msg = std::make_shared<sensor_msgs::msg::PointCloud2>();
+    pcl::toROSMsg(make_map(), *map_msg);
+    map_msg->header.frame_id = "map";
+    map_loader.onMapCallback(map_msg);
+
+    const auto points = make_input_points(200000, engine);
+    const double distance_threshold = leaf_size;
+    std::vector<char> grid_results(points.size());
+    std::vector<char> hash_results(points.size());
+    const double grid_ns = measure_ns_per_point(points.size(), repeats, [&]() {
+      for (size_t i = 0; i < points.size(); ++i) {
+        grid_results[i] = map_loader.is_close_to_map_on_voxel_grid(points[i], distance_threshold);
+      }
+    });
+    const double hash_ns = measure_ns_per_point(points.size(), repeats, [&]() {
+      for (size_t i = 0; i < points.size(); ++i) {
+        hash_results[i] = map_loader.is_close_to_map(points[i], distance_threshold);
+      }
+    });
+
+    size_t removed_num = 0;
+    size_t different_num = 0;
+    for (size_t i = 0; i < points.size(); ++i) {
+      removed_num += hash_results[i];
+      different_num += grid_results[i] != hash_results[i];
+    }
+    std::printf(
+      "%10.2f  %10zu  %14.1f  %14.1f  %8zu  %zu\n", leaf_size, map_loader.map_voxel_num(), grid_ns,
+      hash_ns, removed_num, different_num);
+  }
+
+  rclcpp::shutdown();
+  return 0;
+}
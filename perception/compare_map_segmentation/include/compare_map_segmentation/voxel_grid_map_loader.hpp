@@ -26,6 +26,7 @@
 #include <pcl/search/pcl_search.h>
 #include <pcl_conversions/pcl_conversions.h>
 
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <string>
@@ -89,6 +90,74 @@ public:
   inline std::vector<int> getLeafLayout() { return (leaf_layout_); }
 };
 
+/** \brief Flat open addressing hash map from the grid coordinates of a voxel to its centroid,
+ * built from a VoxelGrid filtered with the leaf layout saved */
+class VoxelHashMap
+{
+public:
+  struct Voxel
+  {
+    int i;
+    int j;
+    int k;
+    bool is_used;
+    float x;
+    float y;
+    float z;
+  };
+
+  void build(
+    const VoxelGridEx<pcl::PointXYZ> & voxel_grid,
+    const pcl::PointCloud<pcl::PointXYZ> & centroids);
+
+  inline bool empty() const { return size_ == 0; }
+  inline size_t size() const { return size_; }
+  inline const Eigen::Array4f & get_inverse_leaf_size() const { return inverse_leaf_size_; }
+
+  /** \brief Return the voxel at the grid coordinates, nullptr if the voxel is empty */
+  inline const Voxel * find(const int i, const int j, const int k) const
+  {
+    if (size_ == 0) {
+      return nullptr;
+    }
+    for (size_t slot = hash(i, j, k) & mask_;; slot = (slot + 1) & mask_) {
+      const Voxel & voxel = voxels_[slot];
+      if (!voxel.is_used) {
+        return nullptr;
+      }
+      if (voxel.i == i && voxel.j == j && voxel.k == k) {
+        return &voxel;
+      }
+    }
+  }
+
+  /** \brief Return the voxel containing the point, nullptr if the voxel is empty */
+  inline const Voxel * find(const pcl::PointXYZ & point) const
+  {
+    return find(
+      static_cast<int>(std::floor(point.x * inverse_leaf_size_[0])),
+      static_cast<int>(std::floor(point.y * inverse_leaf_size_[1])),
+      static_cast<int>(std::floor(point.z * inverse_leaf_size_[2])));
+  }
+
+private:
+  static inline size_t hash(const int i, const int j, const int k)
+  {
+    uint64_t h = static_cast<uint64_t>(static_cast<uint32_t>(i)) * 73856093ULL ^
+                 static_cast<uint64_t>(static_cast<uint32_t>(j)) * 19349663ULL ^
+                 static_cast<uint64_t>(static_cast<uint32_t>(k)) * 83492791ULL;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return static_cast<size_t>(h);
+  }
+
+  std::vector<Voxel> voxels_;
+  size_t mask_ = 0;
+  size_t size_ = 0;
+  Eigen::Array4f inverse_leaf_size_ = Eigen::Array4f::Zero();
+};
+
 class VoxelGridMapLoader
 {
 protected:
@@ -115,6 +184,11 @@ public:
   bool is_close_to_neighbor_voxels(
     const pcl::PointXYZ & point, const double distance_threshold, const PointCloudPtr & map,
     VoxelGridPointXYZ & voxel) const;
+  /** \brief Same check as with the voxel grid, with the 27 neighbor voxels looked up at once in
+   * the hash map */
+  bool is_close_to_neighbor_voxels(
+    const pcl::PointXYZ & point, const double distance_threshold,
+    const VoxelHashMap & voxel_map) const;
   bool is_in_voxel(
     const pcl::PointXYZ & src_point, const pcl::PointXYZ & target_point,
     const double distance_threshold, const PointCloudPtr & map, VoxelGridPointXYZ & voxel) const;
@@ -132,6 +206,7 @@ protected:
   rclcpp::Subscription<sensor_msgs::msg::PointCloud2>::SharedPtr sub_map_;
   VoxelGridPointXYZ voxel_grid_;
   PointCloudPtr voxel_map_ptr_;
+  VoxelHashMap voxel_hash_map_;
 
 public:
   explicit VoxelGridStaticMapLoader(
@@ -148,6 +223,7 @@ protected:
   {
     VoxelGridPointXYZ map_cell_voxel_grid;
     PointCloudPtr map_cell_pc_ptr;
+    VoxelHashMap map_cell_voxel_hash_map;
     float min_b_x, min_b_y, max_b_x, max_b_y;
     pcl::search::Search<pcl::PointXYZ>::Ptr map_cell_kdtree;
   };
@@ -312,6 +388,9 @@ public:
 
     current_voxel_grid_list_item.map_cell_pc_ptr.reset(new pcl::PointCloud<pcl::PointXYZ>);
     current_voxel_grid_list_item.map_cell_pc_ptr = std::move(map_cell_downsampled_pc_ptr_tmp);
+    current_voxel_grid_list_item.map_cell_voxel_hash_map.build(
+      current_voxel_grid_list_item.map_cell_voxel_grid,
+      *current_voxel_grid_list_item.map_cell_pc_ptr);
     // add
     (*mutex_ptr_).lock();
     current_voxel_grid_dict_.insert({map_cell_to_add.cell_id, current_voxel_grid_list_item});
@@ -29,9 +29,7 @@ bool VoxelBasedApproximateStaticMapLoader::is_close_to_map(
   if (voxel_map_ptr_ == NULL) {
     return false;
   }
-  const int index =
-    voxel_grid_.getCentroidIndexAt(voxel_grid_.getGridCoordinates(point.x, point.y, point.z));
-  if (index == -1) {
+  if (voxel_hash_map_.find(point) == nullptr) {
     return false;
   } else {
     return true;
@@ -53,11 +51,9 @@ bool VoxelBasedApproximateDynamicMapLoader::is_close_to_map(
     return false;
   }
   if (current_voxel_grid_array_.at(map_grid_index) != NULL) {
-    const int index = current_voxel_grid_array_.at(map_grid_index)
-                        ->map_cell_voxel_grid.getCentroidIndexAt(
-                          current_voxel_grid_array_.at(map_grid_index)
-                            ->map_cell_voxel_grid.getGridCoordinates(point.x, point.y, point.z));
-    if (index == -1) {
+    if (
+      current_voxel_grid_array_.at(map_grid_index)->map_cell_voxel_hash_map.find(point) ==
+      nullptr) {
       return false;
     } else {
       return true;
@@ -14,6 +14,45 @@
 
 #include "compare_map_segmentation/voxel_grid_map_loader.hpp"
 
+#include <array>
+
+void VoxelHashMap::build(
+  const VoxelGridEx<pcl::PointXYZ> & voxel_grid, const pcl::PointCloud<pcl::PointXYZ> & centroids)
+{
+  inverse_leaf_size_ = voxel_grid.get_inverse_leaf_size();
+  size_ = 0;
+
+  // keep the load factor under 0.5 for short probe sequences
+  size_t capacity = 16;
+  while (capacity < 2 * centroids.size()) {
+    capacity *= 2;
+  }
+  mask_ = capacity - 1;
+  voxels_.assign(capacity, Voxel{0, 0, 0, false, 0.0f, 0.0f, 0.0f});
+
+  // the leaf layout gives the grid coordinates of each centroid as getCentroidIndexAt() sees them
+  const Eigen::Vector4i min_b = voxel_grid.get_min_b();
+  const Eigen::Vector4i div_b = voxel_grid.get_div_b();
+  const size_t div_b_xy = static_cast<size_t>(div_b[0]) * div_b[1];
+  const std::vector<int> & leaf_layout = voxel_grid.leaf_layout_;
+  for (size_t index = 0; index < leaf_layout.size(); ++index) {
+    const int centroid_index = leaf_layout[index];
+    if (centroid_index < 0 || static_cast<size_t>(centroid_index) >= centroids.size()) {
+      continue;
+    }
+    const int i = min_b[0] + static_cast<int>(index % div_b[0]);
+    const int j = min_b[1] + static_cast<int>((index / div_b[0]) % div_b[1]);
+    const int k = min_b[2] + static_cast<int>(index / div_b_xy);
+    size_t slot = hash(i, j, k) & mask_;
+    while (voxels_[slot].is_used) {
+      slot = (slot + 1) & mask_;
+    }
+    const auto & centroid = centroids.points[centroid_index];
+    voxels_[slot] = Voxel{i, j, k, true, centroid.x, centroid.y, centroid.z};
+    ++size_;
+  }
+}
+
 VoxelGridMapLoader::VoxelGridMapLoader(
   rclcpp::Node * node, double leaf_size, double downsize_ratio_z_axis,
   std::string * tf_map_input_frame, std::mutex * mutex)
@@ -231,6 +270,51 @@ bool VoxelGridMapLoader::is_close_to_neighbor_voxels(
   return false;
 }
 
+bool VoxelGridMapLoader::is_close_to_neighbor_voxels(
+  const pcl::PointXYZ & point, const double distance_threshold,
+  const VoxelHashMap & voxel_map) const
+{
+  if (voxel_map.empty()) {
+    return false;
+  }
+  const double distance_threshold_z = downsize_ratio_z_axis_ * distance_threshold;
+  const Eigen::Array4f & inverse_leaf_size = voxel_map.get_inverse_leaf_size();
+
+  // grid coordinates of the same neighbor positions as the search on the voxel grid, with the
+  // voxel of the point first as it is the most likely to be close
+  const auto to_grid_coordinate = [](const double position, const float inverse_leaf_size) {
+    return static_cast<int>(std::floor(static_cast<float>(position) * inverse_leaf_size));
+  };
+  const std::array<int, 3> grid_x{
+    to_grid_coordinate(point.x, inverse_leaf_size[0]),
+    to_grid_coordinate(point.x - distance_threshold, inverse_leaf_size[0]),
+    to_grid_coordinate(point.x + distance_threshold, inverse_leaf_size[0])};
+  const std::array<int, 3> grid_y{
+    to_grid_coordinate(point.y, inverse_leaf_size[1]),
+    to_grid_coordinate(point.y - distance_threshold, inverse_leaf_size[1]),
+    to_grid_coordinate(point.y + distance_threshold, inverse_leaf_size[1])};
+  const std::array<int, 3> grid_z{
+    to_grid_coordinate(point.z, inverse_leaf_size[2]),
+    to_grid_coordinate(point.z - distance_threshold_z, inverse_leaf_size[2]),
+    to_grid_coordinate(point.z + distance_threshold_z, inverse_leaf_size[2])};
+
+  for (const int i : grid_x) {
+    for (const int j : grid_y) {
+      for (const int k : grid_z) {
+        const VoxelHashMap::Voxel * voxel = voxel_map.find(i, j, k);
+        // check if the point is inside the distance threshold voxel
+        if (
+          voxel != nullptr && std::abs(voxel->x - point.x) < distance_threshold &&
+          std::abs(voxel->y - point.y) < distance_threshold &&
+          std::abs(voxel->z - point.z) < distance_threshold_z) {
+          return true;
+        }
+      }
+    }
+  }
+  return false;
+}
+
 bool VoxelGridMapLoader::is_in_voxel(
   const pcl::PointXYZ & src_point, const pcl::PointXYZ & target_point,
   const double distance_threshold, const PointCloudPtr & map, VoxelGridPointXYZ & voxel) const
@@ -276,6 +360,7 @@ void VoxelGridStaticMapLoader::onMapCallback(
   voxel_grid_.setInputCloud(map_pcl_ptr);
   voxel_grid_.setSaveLeafLayout(true);
   voxel_grid_.filter(*voxel_map_ptr_);
+  voxel_hash_map_.build(voxel_grid_, *voxel_map_ptr_);
   (*mutex_ptr_).unlock();
 
   if (debug_) {
@@ -285,7 +370,7 @@ void VoxelGridStaticMapLoader::onMapCallback(
 bool VoxelGridStaticMapLoader::is_close_to_map(
   const pcl::PointXYZ & point, const double distance_threshold)
 {
-  if (is_close_to_neighbor_voxels(point, distance_threshold, voxel_map_ptr_, voxel_grid_)) {
+  if (is_close_to_neighbor_voxels(point, distance_threshold, voxel_hash_map_)) {
     return true;
   }
   return false;
@@ -343,8 +428,7 @@ bool VoxelGridDynamicMapLoader::is_close_to_next_map_grid(
   }
   if (is_close_to_neighbor_voxels(
         point, distance_threshold,
-        current_voxel_grid_array_.at(neighbor_map_grid_index)->map_cell_pc_ptr,
-        current_voxel_grid_array_.at(neighbor_map_grid_index)->map_cell_voxel_grid)) {
+        current_voxel_grid_array_.at(neighbor_map_grid_index)->map_cell_voxel_hash_map)) {
     return true;
   }
   return false;
@@ -369,8 +453,8 @@ bool VoxelGridDynamicMapLoader::is_close_to_map(
   if (
     current_voxel_grid_array_.at(map_grid_index) != NULL &&
     is_close_to_neighbor_voxels(
-      point, distance_threshold, current_voxel_grid_array_.at(map_grid_index)->map_cell_pc_ptr,
-      current_voxel_grid_array_.at(map_grid_index)->map_cell_voxel_grid)) {
+      point, distance_threshold,
+      current_voxel_grid_array_.at(map_grid_index)->map_cell_voxel_hash_map)) {
     return true;
   }
 
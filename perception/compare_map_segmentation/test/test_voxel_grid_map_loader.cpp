@@ -0,0 +1,120 @@
+// Copyright 2024 TIER IV, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "compare_map_segmentation/voxel_grid_map_loader.hpp"
+
+#include <pcl_conversions/pcl_conversions.h>
+#include <rclcpp/rclcpp.hpp>
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
+
+using compare_map_segmentation::VoxelGridStaticMapLoader;
+
+class TestMapLoader : public VoxelGridStaticMapLoader
+{
+public:
+  using VoxelGridStaticMapLoader::VoxelGridStaticMapLoader;
+
+  bool is_close_to_map_on_voxel_grid(const pcl::PointXYZ & point, const double distance_threshold)
+  {
+    return is_close_to_neighbor_voxels(point, distance_threshold, voxel_map_ptr_, voxel_grid_);
+  }
+};
+
+class VoxelGridMapLoaderTest : public ::testing::Test
+{
+protected:
+  void SetUp() override { rclcpp::init(0, nullptr); }
+  void TearDown() override { rclcpp::shutdown(); }
+
+  // a ground with a wall and a pole, across the origin so that the grid starts at negative indices
+  static sensor_msgs::msg::PointCloud2::SharedPtr make_map()
+  {
+    pcl::PointCloud<pcl::PointXYZ> map;
+    for (float x = -2.0; x < 2.0; x += 0.1) {
+      for (float y = -1.0; y < 3.0; y += 0.1) {
+        map.push_back(pcl::PointXYZ(x, y, 0.0));
+      }
+      for (float z = 0.0; z < 2.0; z += 0.1) {
+        map.push_back(pcl::PointXYZ(x, 3.0, z));
+      }
+    }
+    for (float z = 0.0; z < 3.0; z += 0.1) {
+      map.push_back(pcl::PointXYZ(1.05, 0.45, z));
+    }
+    auto map_msg = std::make_shared<sensor_msgs::msg::PointCloud2>();
+    pcl::toROSMsg(map, *map_msg);
+    map_msg->header.frame_id = "map";
+    return map_msg;
+  }
+
+  // random points around the map, and points across its border along each axis
+  static std::vector<pcl::PointXYZ> make_points()
+  {
+    std::mt19937 engine(0);
+    // beyond the border of the map by more than the distance threshold on all the sides
+    std::uniform_real_distribution<float> x_distribution(-3.5, 3.5);
+    std::uniform_real_distribution<float> y_distribution(-2.5, 4.5);
+    std::uniform_real_distribution<float> z_distribution(-1.5, 4.5);
+    std::vector<pcl::PointXYZ> points;
+    for (int i = 0; i < 20000; ++i) {
+      points.emplace_back(x_distribution(engine), y_distribution(engine), z_distribution(engine));
+    }
+    for (float t = -1.0; t < 1.0; t += 0.01) {
+      points.emplace_back(-2.0 + t, 1.0, 0.0);
+      points.emplace_back(2.0 + t, 1.0, 0.0);
+      points.emplace_back(0.0, -1.0 + t, 0.0);
+      points.emplace_back(0.0, 3.0 + t, 1.0);
+      points.emplace_back(0.0, 1.0, t);
+      points.emplace_back(1.05, 0.45, 3.0 + t);
+    }
+    return points;
+  }
+};
+
+TEST_F(VoxelGridMapLoaderTest, VoxelHashMapMatchesVoxelGrid)
+{
+  rclcpp::NodeOptions node_options;
+  node_options.append_parameter_override("publish_debug_pcd", false);
+  std::string map_frame;
+  std::mutex mutex;
+  const auto points = make_points();
+
+  for (const double leaf_size : {0.5, 0.3}) {
+    // the map loader declares its parameters, so each one needs its own node
+    const auto node = std::make_shared<rclcpp::Node>("test_voxel_grid_map_loader", node_options);
+    TestMapLoader map_loader(node.get(), leaf_size, 0.5, &map_frame, &mutex);
+    map_loader.onMapCallback(make_map());
+
+    for (const double distance_threshold : {leaf_size, 0.6 * leaf_size}) {
+      size_t close_num = 0;
+      for (const auto & point : points) {
+        const bool is_close = map_loader.is_close_to_map_on_voxel_grid(point, distance_threshold);
+        ASSERT_EQ(map_loader.is_close_to_map(point, distance_threshold), is_close)
+          << "leaf size " << leaf_size << ", distance threshold " << distance_threshold
+          << ", point (" << point.x << ", " << point.y << ", " << point.z << ")";
+        close_num += is_close;
+      }
+      // both results are covered
+      EXPECT_GT(close_num, 0u);
+      EXPECT_LT(close_num, points.size());
+    }
+  }
+}
@@ -20,6 +20,9 @@
 #include <pcl/filters/voxel_grid.h>
 #include <pcl/point_types.h>
 
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace euclidean_cluster
@@ -31,7 +34,7 @@ public:
   VoxelGridBasedEuclideanCluster(bool use_height, int min_cluster_size, int max_cluster_size);
   VoxelGridBasedEuclideanCluster(
     bool use_height, int min_cluster_size, int max_cluster_size, float tolerance,
-    float voxel_leaf_size, int min_points_number_per_voxel);
+    float voxel_leaf_size, int min_points_number_per_voxel, bool use_grid_clustering = false);
   bool cluster(
     const pcl::PointCloud<pcl::PointXYZ>::ConstPtr & pointcloud,
     std::vector<pcl::PointCloud<pcl::PointXYZ>> & clusters) override;
@@ -41,12 +44,35 @@ public:
   {
     min_points_number_per_voxel_ = min_points_number_per_voxel;
   }
+  void setUseGridClustering(bool use_grid_clustering)
+  {
+    use_grid_clustering_ = use_grid_clustering;
+  }
 
 private:
+  // Cluster the occupied 2d voxels as the connected components of the grid: two voxels are
+  // connected when the distance between their centers is within the tolerance. No search tree is
+  // built, and the buffers are kept between the calls.
+  bool clusterWithGrid(
+    const pcl::PointCloud<pcl::PointXYZ>::ConstPtr & pointcloud,
+    std::vector<pcl::PointCloud<pcl::PointXYZ>> & clusters);
+  int findRoot(int voxel_index);
+
   pcl::VoxelGrid<pcl::PointXYZ> voxel_grid_;
   float tolerance_;
   float voxel_leaf_size_;
   int min_points_number_per_voxel_;
+  bool use_grid_clustering_ = false;
+
+  // buffers of clusterWithGrid
+  std::unordered_map<std::uint64_t, int> voxel_index_map_;
+  std::vector<std::pair<int, int>> voxel_cells_;
+  std::vector<int> voxel_point_nums_;
+  std::vector<int> voxel_parents_;
+  std::vector<int> voxel_cluster_indices_;
+  std::vector<int> point_voxel_indices_;
+  std::vector<int> cluster_offsets_;
+  std::vector<int> cluster_point_indices_;
 };
 
 }  // namespace euclidean_cluster
@@ -17,7 +17,10 @@
 #include <pcl/kdtree/kdtree.h>
 #include <pcl/segmentation/extract_clusters.h>
 
+#include <algorithm>
+#include <cmath>
 #include <unordered_map>
+#include <utility>
 
 namespace euclidean_cluster
 {
@@ -33,11 +36,12 @@ VoxelGridBasedEuclideanCluster::VoxelGridBasedEuclideanCluster(
 
 VoxelGridBasedEuclideanCluster::VoxelGridBasedEuclideanCluster(
   bool use_height, int min_cluster_size, int max_cluster_size, float tolerance,
-  float voxel_leaf_size, int min_points_number_per_voxel)
+  float voxel_leaf_size, int min_points_number_per_voxel, bool use_grid_clustering)
 : EuclideanClusterInterface(use_height, min_cluster_size, max_cluster_size),
   tolerance_(tolerance),
   voxel_leaf_size_(voxel_leaf_size),
-  min_points_number_per_voxel_(min_points_number_per_voxel)
+  min_points_number_per_voxel_(min_points_number_per_voxel),
+  use_grid_clustering_(use_grid_clustering)
 {
 }
 
@@ -47,6 +51,10 @@ bool VoxelGridBasedEuclideanCluster::cluster(
 {
   // TODO(Saito) implement use_height is false version
 
+  if (use_grid_clustering_) {
+    return clusterWithGrid(pointcloud, clusters);
+  }
+
   // create voxel
   pcl::PointCloud<pcl::PointXYZ>::Ptr voxel_map_ptr(new pcl::PointCloud<pcl::PointXYZ>);
   voxel_grid_.setLeafSize(voxel_leaf_size_, voxel_leaf_size_, 100000.0);
@@ -116,4 +124,145 @@ bool VoxelGridBasedEuclideanCluster::cluster(
   return true;
 }
 
+int VoxelGridBasedEuclideanCluster::findRoot(int voxel_index)
+{
+  while (voxel_parents_[voxel_index] != voxel_index) {
+    voxel_parents_[voxel_index] = voxel_parents_[voxel_parents_[voxel_index]];
+    voxel_index = voxel_parents_[voxel_index];
+  }
+  return voxel_index;
+}
+
+bool VoxelGridBasedEuclideanCluster::clusterWithGrid(
+  const pcl::PointCloud<pcl::PointXYZ>::ConstPtr & pointcloud,
+  std::vector<pcl::PointCloud<pcl::PointXYZ>> & clusters)
+{
+  const auto cell_key = [](const int ix, const int iy) {
+    return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(ix)) << 32) |
+           static_cast<std::uint32_t>(iy);
+  };
+
+  // create voxel, in the same cells as pcl::VoxelGrid
+  const float inverse_leaf_size = 1.0f / voxel_leaf_size_;
+  const size_t point_num = pointcloud->points.size();
+  voxel_index_map_.clear();
+  voxel_cells_.clear();
+  voxel_point_nums_.clear();
+  point_voxel_indices_.resize(point_num);
+  for (size_t i = 0; i < point_num; ++i) {
+    const auto & point = pointcloud->points[i];
+    if (!std::isfinite(point.x) || !std::isfinite(point.y) || !std::isfinite(point.z)) {
+      point_voxel_indices_[i] = -1;
+      continue;
+    }
+    const int ix = static_cast<int>(std::floor(point.x * inverse_leaf_size));
+    const int iy = static_cast<int>(std::floor(point.y * inverse_leaf_size));
+    const auto [itr, is_new_voxel] =
+      voxel_index_map_.try_emplace(cell_key(ix, iy), static_cast<int>(voxel_cells_.size()));
+    if (is_new_voxel) {
+      voxel_cells_.emplace_back(ix, iy);
+      voxel_point_nums_.push_back(0);
+    }
+    point_voxel_indices_[i] = itr->second;
+    ++voxel_point_nums_[itr->second];
+  }
+  const int voxel_num = static_cast<int>(voxel_cells_.size());
+
+  // offsets of the neighbor cells within the tolerance, half of them since the links are symmetric
+  const float tolerance_in_cells = tolerance_ * inverse_leaf_size;
+  const int cell_radius = static_cast<int>(std::floor(tolerance_in_cells));
+  std::vector<std::pair<int, int>> neighbor_offsets;
+  for (int dy = 0; dy <= cell_radius; ++dy) {
+    for (int dx = -cell_radius; dx <= cell_radius; ++dx) {
+      if ((dy == 0 && dx <= 0) || dx * dx + dy * dy > tolerance_in_cells * tolerance_in_cells) {
+        continue;
+      }
+      neighbor_offsets.emplace_back(dx, dy);
+    }
+  }
+
+  // connect the voxels having enough points
+  voxel_parents_.resize(voxel_num);
+  for (int v = 0; v < voxel_num; ++v) {
+    voxel_parents_[v] = v;
+  }
+  for (int v = 0; v < voxel_num; ++v) {
+    if (voxel_point_nums_[v] < min_points_number_per_voxel_) {
+      continue;
+    }
+    const auto & [ix, iy] = voxel_cells_[v];
+    for (const auto & [dx, dy] : neighbor_offsets) {
+      const auto itr = voxel_index_map_.find(cell_key(ix + dx, iy + dy));
+      if (
+        itr == voxel_index_map_.end() ||
+        voxel_point_nums_[itr->second] < min_points_number_per_voxel_) {
+        continue;
+      }
+      const int root = findRoot(v);
+      const int neighbor_root = findRoot(itr->second);
+      if (root != neighbor_root) {
+        voxel_parents_[std::max(root, neighbor_root)] = std::min(root, neighbor_root);
+      }
+    }
+  }
+
+  // number the clusters and count their points
+  voxel_cluster_indices_.assign(voxel_num, -1);
+  cluster_offsets_.clear();
+  for (int v = 0; v < voxel_num; ++v) {
+    if (voxel_point_nums_[v] < min_points_number_per_voxel_) {
+      continue;
+    }
+    const int root = findRoot(v);
+    if (voxel_cluster_indices_[root] < 0) {
+      voxel_cluster_indices_[root] = static_cast<int>(cluster_offsets_.size());
+      cluster_offsets_.push_back(0);
+    }
+    voxel_cluster_indices_[v] = voxel_cluster_indices_[root];
+    cluster_offsets_[voxel_cluster_indices_[v]] += voxel_point_nums_[v];
+  }
+
+  // sort the point indices by cluster with a counting sort
+  int point_index_num = 0;
+  for (auto & offset : cluster_offsets_) {
+    const int cluster_point_num = offset;
+    offset = point_index_num;
+    point_index_num += cluster_point_num;
+  }
+  cluster_offsets_.push_back(point_index_num);
+  cluster_point_indices_.resize(point_index_num);
+  for (size_t i = 0; i < point_num; ++i) {
+    if (point_voxel_indices_[i] < 0) {
+      continue;
+    }
+    const int cluster_index = voxel_cluster_indices_[point_voxel_indices_[i]];
+    if (cluster_index < 0) {
+      continue;
+    }
+    // after this loop, the offset of each cluster is the end of its indices
+    cluster_point_indices_[cluster_offsets_[cluster_index]++] = static_cast<int>(i);
+  }
+
+  // build output and check cluster size
+  int cluster_begin = 0;
+  for (size_t cluster_index = 0; cluster_index + 1 < cluster_offsets_.size(); ++cluster_index) {
+    const int cluster_end = cluster_offsets_[cluster_index];
+    const int cluster_point_num = cluster_end - cluster_begin;
+    if (min_cluster_size_ <= cluster_point_num && cluster_point_num <= max_cluster_size_) {
+      pcl::PointCloud<pcl::PointXYZ> cluster;
+      cluster.points.reserve(cluster_point_num);
+      for (int i = cluster_begin; i < cluster_end; ++i) {
+        cluster.points.push_back(pointcloud->points[cluster_point_indices_[i]]);
+      }
+      cluster.width = cluster_point_num;
+      cluster.height = 1;
+      cluster.is_dense = false;
+      clusters.push_back(std::move(cluster));
+    }
+    cluster_begin = cluster_end;
+  }
+
+  return true;
+}
+
 }  // namespace euclidean_cluster
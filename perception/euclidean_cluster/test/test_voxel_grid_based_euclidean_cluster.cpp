@@ -0,0 +1,110 @@
+// Copyright 2024 TIER IV, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "euclidean_cluster/voxel_grid_based_euclidean_cluster.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+using euclidean_cluster::VoxelGridBasedEuclideanCluster;
+
+constexpr float voxel_leaf_size = 0.3;
+constexpr float tolerance = 0.7;
+constexpr int min_cluster_size = 10;
+constexpr int max_cluster_size = 10000;
+
+using SortedCluster = std::vector<std::array<float, 3>>;
+
+// the clusters as sorted point lists, in a sorted order, since the two paths order them differently
+std::vector<SortedCluster> cluster_pointcloud(
+  const pcl::PointCloud<pcl::PointXYZ> & pointcloud, const int min_points_number_per_voxel,
+  const bool use_grid_clustering)
+{
+  VoxelGridBasedEuclideanCluster voxel_grid_based_euclidean_cluster(
+    true, min_cluster_size, max_cluster_size, tolerance, voxel_leaf_size,
+    min_points_number_per_voxel, use_grid_clustering);
+  std::vector<pcl::PointCloud<pcl::PointXYZ>> clusters;
+  const pcl::PointCloud<pcl::PointXYZ>::ConstPtr pointcloud_ptr(
+    new pcl::PointCloud<pcl::PointXYZ>(pointcloud));
+  EXPECT_TRUE(voxel_grid_based_euclidean_cluster.cluster(pointcloud_ptr, clusters));
+
+  std::vector<SortedCluster> sorted_clusters;
+  for (const auto & cluster : clusters) {
+    EXPECT_EQ(cluster.width, cluster.points.size());
+    SortedCluster sorted_cluster;
+    for (const auto & point : cluster.points) {
+      sorted_cluster.push_back({point.x, point.y, point.z});
+    }
+    std::sort(sorted_cluster.begin(), sorted_cluster.end());
+    sorted_clusters.push_back(sorted_cluster);
+  }
+  std::sort(sorted_clusters.begin(), sorted_clusters.end());
+  return sorted_clusters;
+}
+
+// add the points of a box, at 0.1 m intervals which are off the voxel boundaries
+void add_box(
+  const float min_x, const float min_y, const int x_num, const int y_num,
+  const std::vector<float> & heights, pcl::PointCloud<pcl::PointXYZ> & pointcloud)
+{
+  for (int ix = 0; ix < x_num; ++ix) {
+    for (int iy = 0; iy < y_num; ++iy) {
+      for (const float z : heights) {
+        pointcloud.push_back(pcl::PointXYZ(min_x + 0.1f * ix, min_y + 0.1f * iy, z));
+      }
+    }
+  }
+}
+
+TEST(VoxelGridBasedEuclideanClusterTest, GridClusteringMatchesKdTreeClustering)
+{
+  pcl::PointCloud<pcl::PointXYZ> pointcloud;
+  // a car
+  add_box(0.05, 0.05, 40, 18, {0.5, 1.2}, pointcloud);
+  // a pedestrian standing on the ground, with points just below z=0
+  add_box(6.05, 0.05, 5, 5, {-0.02, 0.8, 1.6}, pointcloud);
+  // an L-shaped wall, whose arms are linked across an empty row of voxels
+  add_box(10.05, 0.05, 30, 3, {1.0}, pointcloud);
+  add_box(10.05, 0.65, 3, 30, {-0.01, 1.0}, pointcloud);
+  // too small clusters
+  add_box(20.05, 5.05, 3, 3, {0.5}, pointcloud);
+  pointcloud.push_back(pcl::PointXYZ(-5.05, -5.05, -0.01));
+
+  for (const int min_points_number_per_voxel : {1, 3}) {
+    const auto kd_tree_clusters =
+      cluster_pointcloud(pointcloud, min_points_number_per_voxel, false);
+    const auto grid_clusters = cluster_pointcloud(pointcloud, min_points_number_per_voxel, true);
+    EXPECT_EQ(kd_tree_clusters.size(), 3u);
+    EXPECT_EQ(grid_clusters, kd_tree_clusters);
+  }
+}
+
+TEST(VoxelGridBasedEuclideanClusterTest, GridClusteringCountsPointsAcrossZeroHeight)
+{
+  // pcl::VoxelGrid splits the column of a voxel at z=0, so the 3 points just below z=0 are a voxel
+  // of their own, which is dropped by the KD-tree path, while the grid path counts the whole column
+  pcl::PointCloud<pcl::PointXYZ> pointcloud;
+  add_box(0.05, 0.05, 6, 6, {0.5, 1.0, 1.5}, pointcloud);
+  add_box(0.05, 0.05, 1, 3, {-0.02}, pointcloud);
+
+  const auto kd_tree_clusters = cluster_pointcloud(pointcloud, 5, false);
+  const auto grid_clusters = cluster_pointcloud(pointcloud, 5, true);
+  ASSERT_EQ(kd_tree_clusters.size(), 1u);
+  ASSERT_EQ(grid_clusters.size(), 1u);
+  EXPECT_EQ(kd_tree_clusters.front().size(), pointcloud.size() - 3);
+  EXPECT_EQ(grid_clusters.front().size(), pointcloud.size());
+}
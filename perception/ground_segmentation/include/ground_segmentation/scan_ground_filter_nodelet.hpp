@@ -197,6 +197,7 @@ private:
   bool use_lowest_point_;  // to select lowest point for reference in recheck ground cluster,
                            // otherwise select middle point
   size_t radial_dividers_num_;
+  int num_threads_;  // the radial divisions are sorted and classified in parallel
   VehicleInfo vehicle_info_;
 
   /*!
@@ -220,6 +221,11 @@ private:
   void convertPointcloudGridScan(
     const PointCloud2ConstPtr & in_cloud,
     std::vector<PointCloudVector> & out_radial_ordered_points_manager);
+  /*!
+   * Sort the points of a radial division by radius, with a radix sort on the quantized radius
+   * @param points Points of a radial division to sort
+   */
+  static void sortByRadius(PointCloudVector & points);
   /*!
    * Output ground center of front wheels as the virtual ground point
    * @param[out] point Virtual ground origin point
@@ -262,6 +268,13 @@ private:
   void recheckGroundCluster(
     PointsCentroid & gnd_cluster, const float non_ground_threshold, const bool use_lowest_point,
     pcl::PointIndices & non_ground_indices);
+  /*!
+   * Concatenates the indices found in each radial division, in the order of the divisions
+   * @param in_indices_list Indices of each radial division
+   * @param out_indices Resulting indices
+   */
+  void mergeIndices(
+    const std::vector<pcl::PointIndices> & in_indices_list, pcl::PointIndices & out_indices);
   /*!
    * Returns the resulting complementary PointCloud, one with the points kept
    * and the other removed as indicated in the indices
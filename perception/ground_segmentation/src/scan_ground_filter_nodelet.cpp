@@ -19,6 +19,8 @@
 #include <tier4_autoware_utils/math/unit_conversion.hpp>
 #include <vehicle_info_util/vehicle_info_util.hpp>
 
+#include <algorithm>
+#include <array>
 #include <memory>
 #include <string>
 #include <vector>
@@ -58,6 +60,7 @@ ScanGroundFilterComponent::ScanGroundFilterComponent(const rclcpp::NodeOptions &
     use_virtual_ground_point_ = declare_parameter<bool>("use_virtual_ground_point");
     use_recheck_ground_cluster_ = declare_parameter<bool>("use_recheck_ground_cluster");
     use_lowest_point_ = declare_parameter<bool>("use_lowest_point");
+    num_threads_ = declare_parameter<int>("num_threads");
     radial_dividers_num_ = std::ceil(2.0 * M_PI / radial_divider_angle_rad_);
     vehicle_info_ = VehicleInfoUtil(*this).getVehicleInfo();
 
@@ -157,10 +160,9 @@ void ScanGroundFilterComponent::convertPointcloudGridScan(
   }
 
   // sort by distance
+#pragma omp parallel for num_threads(num_threads_) schedule(dynamic)
   for (size_t i = 0; i < radial_dividers_num_; ++i) {
-    std::sort(
-      out_radial_ordered_points[i].begin(), out_radial_ordered_points[i].end(),
-      [](const PointData & a, const PointData & b) { return a.radius < b.radius; });
+    sortByRadius(out_radial_ordered_points[i]);
   }
 }
 
@@ -195,10 +197,53 @@ void ScanGroundFilterComponent::convertPointcloud(
     ++point_index;
   }
   // sort by distance
+#pragma omp parallel for num_threads(num_threads_) schedule(dynamic)
   for (size_t i = 0; i < radial_dividers_num_; ++i) {
-    std::sort(
-      out_radial_ordered_points[i].begin(), out_radial_ordered_points[i].end(),
-      [](const PointData & a, const PointData & b) { return a.radius < b.radius; });
+    sortByRadius(out_radial_ordered_points[i]);
+  }
+}
+
+void ScanGroundFilterComponent::sortByRadius(PointCloudVector & points)
+{
+  constexpr float inv_radius_resolution = 1.0f / 0.01f;  // [1/m]
+  constexpr size_t key_max = 0xFFFF;
+  constexpr size_t digit_bits = 8;
+  constexpr size_t digit_mask = (1 << digit_bits) - 1;
+
+  // LSD radix sort on the radius quantized to 1 [cm], two digits of 8 bits
+  std::vector<uint16_t> keys(points.size());
+  for (size_t i = 0; i < points.size(); ++i) {
+    keys[i] = static_cast<uint16_t>(
+      std::min(static_cast<size_t>(points[i].radius * inv_radius_resolution), key_max));
+  }
+  PointCloudVector sorted_points(points.size());
+  std::vector<uint16_t> sorted_keys(points.size());
+  for (size_t shift = 0; shift < 16; shift += digit_bits) {
+    std::array<size_t, digit_mask + 2> offsets{};
+    for (const auto key : keys) {
+      ++offsets[((key >> shift) & digit_mask) + 1];
+    }
+    for (size_t d = 1; d < offsets.size(); ++d) {
+      offsets[d] += offsets[d - 1];
+    }
+    for (size_t i = 0; i < points.size(); ++i) {
+      const size_t dst = offsets[(keys[i] >> shift) & digit_mask]++;
+      sorted_points[dst] = points[i];
+      sorted_keys[dst] = keys[i];
+    }
+    points.swap(sorted_points);
+    keys.swap(sorted_keys);
+  }
+
+  // the points are sorted up to the quantization, the insertion sort only moves the points
+  // within a cell of 1 [cm]
+  for (size_t i = 1; i < points.size(); ++i) {
+    const PointData p = points[i];
+    size_t j = i;
+    for (; j > 0 && p.radius < points[j - 1].radius; --j) {
+      points[j] = points[j - 1];
+    }
+    points[j] = p;
   }
 }
 
@@ -335,8 +380,12 @@ void ScanGroundFilterComponent::classifyPointCloudGridScan(
   const PointCloud2ConstPtr & in_cloud, std::vector<PointCloudVector> & in_radial_ordered_clouds,
   pcl::PointIndices & out_no_ground_indices)
 {
-  out_no_ground_indices.indices.clear();
+  // the rays are independent, each ray has its own output so that the merged indices do not
+  // depend on the number of threads
+  std::vector<pcl::PointIndices> ray_no_ground_indices(in_radial_ordered_clouds.size());
+#pragma omp parallel for num_threads(num_threads_) schedule(dynamic)
   for (size_t i = 0; i < in_radial_ordered_clouds.size(); ++i) {
+    pcl::PointIndices & no_ground_indices = ray_no_ground_indices[i];
     PointsCentroid ground_cluster;
     ground_cluster.initialize();
     std::vector<GridCenter> gnd_grids;
@@ -369,7 +418,7 @@ void ScanGroundFilterComponent::classifyPointCloudGridScan(
       if (
         !initialized_first_gnd_grid && global_slope_ratio_p >= global_slope_max_ratio_ &&
         p_orig_point.z > non_ground_height_threshold_local) {
-        out_no_ground_indices.indices.push_back(p->orig_index);
+        no_ground_indices.indices.push_back(p->orig_index);
         p->point_state = PointLabel::NON_GROUND;
         continue;
       }
@@ -406,7 +455,7 @@ void ScanGroundFilterComponent::classifyPointCloudGridScan(
         // check if the prev grid have ground point cloud
         if (use_recheck_ground_cluster_) {
           recheckGroundCluster(
-            ground_cluster, non_ground_height_threshold_, use_lowest_point_, out_no_ground_indices);
+            ground_cluster, non_ground_height_threshold_, use_lowest_point_, no_ground_indices);
         }
         curr_gnd_grid.radius = ground_cluster.getAverageRadius();
         curr_gnd_grid.avg_height = ground_cluster.getAverageHeight();
@@ -428,11 +477,11 @@ void ScanGroundFilterComponent::classifyPointCloudGridScan(
         points_xy_distance_square < split_points_distance_tolerance_square_ &&
         p_orig_point.z > prev_p_orig_point.z) {
         p->point_state = PointLabel::NON_GROUND;
-        out_no_ground_indices.indices.push_back(p->orig_index);
+        no_ground_indices.indices.push_back(p->orig_index);
         continue;
       }
       if (global_slope_ratio_p > global_slope_max_ratio_) {
-        out_no_ground_indices.indices.push_back(p->orig_index);
+        no_ground_indices.indices.push_back(p->orig_index);
         continue;
       }
       // gnd grid is continuous, the last gnd grid is close
@@ -450,27 +499,29 @@ void ScanGroundFilterComponent::classifyPointCloudGridScan(
         checkBreakGndGrid(*p, p_orig_point, gnd_grids);
       }
       if (p->point_state == PointLabel::NON_GROUND) {
-        out_no_ground_indices.indices.push_back(p->orig_index);
+        no_ground_indices.indices.push_back(p->orig_index);
       } else if (p->point_state == PointLabel::GROUND) {
         ground_cluster.addPoint(p->radius, p_orig_point.z, p->orig_index);
       }
     }
   }
+  mergeIndices(ray_no_ground_indices, out_no_ground_indices);
 }
 
 void ScanGroundFilterComponent::classifyPointCloud(
   const PointCloud2ConstPtr & in_cloud, std::vector<PointCloudVector> & in_radial_ordered_clouds,
   pcl::PointIndices & out_no_ground_indices)
 {
-  out_no_ground_indices.indices.clear();
-
   const pcl::PointXYZ init_ground_point(0, 0, 0);
   pcl::PointXYZ virtual_ground_point(0, 0, 0);
   calcVirtualGroundOrigin(virtual_ground_point);
 
   // point classification algorithm
-  // sweep through each radial division
+  // sweep through each radial division, in parallel as they are independent
+  std::vector<pcl::PointIndices> ray_no_ground_indices(in_radial_ordered_clouds.size());
+#pragma omp parallel for num_threads(num_threads_) schedule(dynamic)
   for (size_t i = 0; i < in_radial_ordered_clouds.size(); ++i) {
+    pcl::PointIndices & no_ground_indices = ray_no_ground_indices[i];
     float prev_gnd_radius = 0.0f;
     float prev_gnd_slope = 0.0f;
     float points_distance = 0.0f;
@@ -544,12 +595,12 @@ void ScanGroundFilterComponent::classifyPointCloud(
         non_ground_cluster.initialize();
       }
       if (p->point_state == PointLabel::NON_GROUND) {
-        out_no_ground_indices.indices.push_back(p->orig_index);
+        no_ground_indices.indices.push_back(p->orig_index);
       } else if (  // NOLINT
         (prev_point_label == PointLabel::NON_GROUND) &&
         (p->point_state == PointLabel::POINT_FOLLOW)) {
         p->point_state = PointLabel::NON_GROUND;
-        out_no_ground_indices.indices.push_back(p->orig_index);
+        no_ground_indices.indices.push_back(p->orig_index);
       } else if (  // NOLINT
         (prev_point_label == PointLabel::GROUND) && (p->point_state == PointLabel::POINT_FOLLOW)) {
         p->point_state = PointLabel::GROUND;
@@ -570,6 +621,22 @@ void ScanGroundFilterComponent::classifyPointCloud(
       }
     }
   }
+  mergeIndices(ray_no_ground_indices, out_no_ground_indices);
+}
+
+void ScanGroundFilterComponent::mergeIndices(
+  const std::vector<pcl::PointIndices> & in_indices_list, pcl::PointIndices & out_indices)
+{
+  size_t indices_num = 0;
+  for (const auto & indices : in_indices_list) {
+    indices_num += indices.indices.size();
+  }
+  out_indices.indices.clear();
+  out_indices.indices.reserve(indices_num);
+  for (const auto & indices : in_indices_list) {
+    out_indices.indices.insert(
+      out_indices.indices.end(), indices.indices.begin(), indices.indices.end());
+  }
 }
 
 void ScanGroundFilterComponent::extractObjectPoints(
@@ -718,6 +785,9 @@ rcl_interfaces::msg::SetParametersResult ScanGroundFilterComponent::onParameter(
       get_logger(),
       "Setting use_recheck_ground_cluster to: " << std::boolalpha << use_recheck_ground_cluster_);
   }
+  if (get_param(p, "num_threads", num_threads_)) {
+    RCLCPP_DEBUG(get_logger(), "Setting num_threads to: %d.", num_threads_);
+  }
   rcl_interfaces::msg::SetParametersResult result;
   result.successful = true;
   result.reason = "success";
@@ -84,6 +84,7 @@ protected:
     parameters.emplace_back(
       rclcpp::Parameter("use_recheck_ground_cluster", use_recheck_ground_cluster_));
     parameters.emplace_back(rclcpp::Parameter("use_lowest_point", use_lowest_point_));
+    parameters.emplace_back(rclcpp::Parameter("num_threads", num_threads_));
 
     options.parameter_overrides(parameters);
 
@@ -159,6 +160,7 @@ public:
     radial_divider_angle_deg_ = params["radial_divider_angle_deg"].as<float>();
     use_recheck_ground_cluster_ = params["use_recheck_ground_cluster"].as<bool>();
     use_lowest_point_ = params["use_lowest_point"].as<bool>();
+    num_threads_ = params["num_threads"].as<int>();
   }
 
   float global_slope_max_angle_deg_ = 0.0;
@@ -177,6 +179,7 @@ public:
   float radial_divider_angle_deg_;
   bool use_recheck_ground_cluster_;
   bool use_lowest_point_;
+  int num_threads_;
 };
 
 TEST_F(ScanGroundFilterTest, TestCase1)
@@ -205,3 +208,18 @@ TEST_F(ScanGroundFilterTest, TestCase1)
   //           << ",percentage:" << percent << std::endl;
   EXPECT_GE(percent, 0.9);
 }
+
+TEST_F(ScanGroundFilterTest, TestParallelClassification)
+{
+  sensor_msgs::msg::PointCloud2 serial_out_cloud;
+  scan_ground_filter_->set_parameter(rclcpp::Parameter("num_threads", 1));
+  filter(serial_out_cloud);
+
+  // the no ground points are merged in the order of the radial divisions in any case
+  sensor_msgs::msg::PointCloud2 parallel_out_cloud;
+  scan_ground_filter_->set_parameter(rclcpp::Parameter("num_threads", 4));
+  filter(parallel_out_cloud);
+
+  EXPECT_EQ(serial_out_cloud.width, parallel_out_cloud.width);
+  EXPECT_EQ(serial_out_cloud.data, parallel_out_cloud.data);
+}
@@ -0,0 +1,204 @@
+// Copyright 2024 TIER IV, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Replays the tracked objects recorded in a rosbag through the map based prediction, and reports
+// the time to predict each frame.
+//
+// usage: prediction_replay_benchmark <bag> <param.yaml> [-t <num_threads>] [-o <objects_topic>]
+//          [-m <vector_map_topic>]
+//
+// The bag has to contain the vector map as well as the tracked objects, in the map frame. The
+// frames are fed one at a time to the node, and the time from publishing a frame to receiving its
+// predicted objects is measured. The node initializes glog, so it can be created only once per
+// process: run the benchmark once for each number of threads to compare.
+
+#include "map_based_prediction/map_based_prediction_node.hpp"
+
+#include <rclcpp/rclcpp.hpp>
+#include <rclcpp/serialization.hpp>
+#include <rosbag2_cpp/reader.hpp>
+#include <tf2_ros/static_transform_broadcaster.hpp>
+
+#include <geometry_msgs/msg/transform_stamped.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <vector>
+
+using autoware_auto_mapping_msgs::msg::HADMapBin;
+using autoware_auto_perception_msgs::msg::PredictedObjects;
+using autoware_auto_perception_msgs::msg::TrackedObjects;
+
+struct Recording
+{
+  HADMapBin::SharedPtr vector_map;
+  std::vector<TrackedObjects::SharedPtr> frames;
+};
+
+Recording read_bag(
+  const std::string & bag_path, const std::string & objects_topic,
+  const std::string & vector_map_topic)
+{
+  rosbag2_cpp::Reader bag_reader;
+  bag_reader.open(bag_path);
+
+  rclcpp::Serialization<HADMapBin> map_serialization;
+  rclcpp::Serialization<TrackedObjects> objects_serialization;
+  Recording recording;
+  while (bag_reader.has_next()) {
+    const rosbag2_storage::SerializedBagMessageSharedPtr msg = bag_reader.read_next();
+    rclcpp::SerializedMessage serialized_msg(*msg->serialized_data);
+    if (msg->topic_name == vector_map_topic && !recording.vector_map) {
+      recording.vector_map = std::make_shared<HADMapBin>();
+      map_serialization.deserialize_message(&serialized_msg, recording.vector_map.get());
+    } else if (msg->topic_name == objects_topic) {
+      const auto objects = std::make_shared<TrackedObjects>();
+      objects_serialization.deserialize_message(&serialized_msg, objects.get());
+      recording.frames.push_back(objects);
+    }
+  }
+  return recording;
+}
+
+// Return the processing time of each frame [ms], or a negative time for the dropped frames
+std::vector<double> replay(
+  const Recording & recording, const std::string & param_path, const int num_threads)
+{
+  rclcpp::NodeOptions node_options;
+  node_options.arguments({"--ros-args", "--params-file", param_path});
+  node_options.append_parameter_override("num_threads", num_threads);
+  const auto prediction_node =
+    std::make_shared<map_based_prediction::MapBasedPredictionNode>(node_options);
+
+  const auto replay_node = std::make_shared<rclcpp::Node>("prediction_replay_benchmark");
+  const auto map_pub =
+    replay_node->create_publisher<HADMapBin>("/vector_map", rclcpp::QoS{1}.transient_local());
+  const auto objects_pub = replay_node->create_publisher<TrackedObjects>(
+    "/map_based_prediction/input/objects", rclcpp::QoS{1});
+  bool is_received = false;
+  const auto predicted_objects_sub = replay_node->create_subscription<PredictedObjects>(
+    "/map_based_prediction/output/objects", rclcpp::QoS{1},
+    [&is_received](const PredictedObjects::ConstSharedPtr) { is_received = true; });
+
+  // The objects are in the map frame, base_link is only used for the debug markers
+  tf2_ros::StaticTransformBroadcaster tf_broadcaster(replay_node);
+  geometry_msgs::msg::TransformStamped map_to_base_link;
+  map_to_base_link.header.frame_id = "map";
+  map_to_base_link.child_frame_id = "base_link";
+  map_to_base_link.transform.rotation.w = 1.0;
+  tf_broadcaster.sendTransform(map_to_base_link);
+
+  rclcpp::executors::SingleThreadedExecutor executor;
+  executor.add_node(prediction_node);
+  executor.add_node(replay_node);
+
+  const auto spin_for = [&](const std::chrono::milliseconds timeout) {
+    const auto start = std::chrono::steady_clock::now();
+    while (!is_received && std::chrono::steady_clock::now() - start < timeout) {
+      executor.spin_some(std::chrono::milliseconds(1));
+    }
+  };
+
+  // let the node load the map and receive the transform
+  map_pub->publish(*recording.vector_map);
+  spin_for(std::chrono::milliseconds(2000));
+
+  std::vector<double> processing_times;
+  for (const auto & frame : recording.frames) {
+    is_received = false;
+    const auto start = std::chrono::steady_clock::now();
+    objects_pub->publish(*frame);
+    spin_for(std::chrono::milliseconds(5000));
+    const std::chrono::duration<double, std::milli> elapsed =
+      std::chrono::steady_clock::now() - start;
+    processing_times.push_back(is_received ? elapsed.count() : -1.0);
+  }
+  return processing_times;
+}
+
+void print_result(const int num_threads, std::vector<double> processing_times)
+{
+  const auto dropped_itr = std::remove_if(
+    processing_times.begin(), processing_times.end(), [](const double t) { return t < 0.0; });
+  const size_t dropped_num = std::distance(dropped_itr, processing_times.end());
+  processing_times.erase(dropped_itr, processing_times.end());
+  if (processing_times.empty()) {
+    printf("%11d %8s %8s %8s %8zu\n", num_threads, "-", "-", "-", dropped_num);
+    return;
+  }
+
+  std::sort(processing_times.begin(), processing_times.end());
+  const double mean =
+    std::accumulate(processing_times.begin(), processing_times.end(), 0.0) /
+    processing_times.size();
+  const double p95 = processing_times.at((processing_times.size() - 1) * 95 / 100);
+  printf(
+    "%11d %8.2f %8.2f %8.2f %8zu\n", num_threads, mean, p95, processing_times.back(),
+    dropped_num);
+}
+
+int main(int argc, char ** argv)
+{
+  rclcpp::init(argc, argv);
+  const auto args = rclcpp::remove_ros_arguments(argc, argv);
+
+  std::vector<std::string> positional_args;
+  int num_threads = 1;
+  std::string objects_topic = "/perception/object_recognition/tracking/objects";
+  std::string vector_map_topic = "/map/vector_map";
+  for (size_t i = 1; i < args.size(); ++i) {
+    if (args.at(i) == "-t" && i + 1 < args.size()) {
+      num_threads = std::atoi(args.at(++i).c_str());
+    } else if (args.at(i) == "-o" && i + 1 < args.size()) {
+      objects_topic = args.at(++i);
+    } else if (args.at(i) == "-m" && i + 1 < args.size()) {
+      vector_map_topic = args.at(++i);
+    } else {
+      positional_args.push_back(args.at(i));
+    }
+  }
+  if (positional_args.size() != 2) {
+    fprintf(
+      stderr,
+      "usage: %s <bag> <param.yaml> [-t <num_threads>] [-o <objects_topic>] "
+      "[-m <vector_map_topic>]\n",
+      argv[0]);
+    return 1;
+  }
+
+  const auto recording = read_bag(positional_args.at(0), objects_topic, vector_map_topic);
+  if (!recording.vector_map || recording.frames.empty()) {
+    fprintf(
+      stderr, "%s or %s is not in the bag\n", vector_map_topic.c_str(), objects_topic.c_str());
+    return 1;
+  }
+  size_t object_num = 0;
+  for (const auto & frame : recording.frames) {
+    object_num += frame->objects.size();
+  }
+  printf(
+    "%zu frames, %.1f objects per frame\n", recording.frames.size(),
+    static_cast<double>(object_num) / recording.frames.size());
+
+  printf("%11s %8s %8s %8s %8s\n", "num_threads", "mean[ms]", "p95[ms]", "max[ms]", "dropped");
+  print_result(num_threads, replay(recording, positional_args.at(1), num_threads));
+
+  rclcpp::shutdown();
+  return 0;
+}
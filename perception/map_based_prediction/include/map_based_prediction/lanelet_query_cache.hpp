@@ -0,0 +1,96 @@
+// Copyright 2024 TIER IV, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MAP_BASED_PREDICTION__LANELET_QUERY_CACHE_HPP_
+#define MAP_BASED_PREDICTION__LANELET_QUERY_CACHE_HPP_
+
+#include <lanelet2_core/Forward.h>
+#include <lanelet2_core/primitives/Lanelet.h>
+#include <lanelet2_routing/Forward.h>
+#include <lanelet2_routing/LaneletPath.h>
+
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace map_based_prediction
+{
+/**
+ * @brief Cache of the lanelet queries of the prediction, valid for one lanelet map
+ * @details The nearest lanelet search is answered from a list of candidate lanelets per cell of a
+ * coarse grid, which holds every lanelet that can be among the nearest ones of a point in the cell.
+ * The possible paths are memoized by start lanelet, with the range of search distances for which
+ * the routing graph returns the same paths, in a bounded LRU.
+ * possiblePaths() may be called from several threads, findNearestLanelets() may not.
+ */
+class LaneletQueryCache
+{
+public:
+  LaneletQueryCache(
+    const std::shared_ptr<lanelet::LaneletMap> & lanelet_map_ptr,
+    const std::shared_ptr<lanelet::routing::RoutingGraph> & routing_graph_ptr,
+    const size_t nearest_lanelet_num);
+
+  /**
+   * @brief same as lanelet::geometry::findNearest(laneletLayer, search_point, nearest_lanelet_num)
+   */
+  std::vector<std::pair<double, lanelet::Lanelet>> findNearestLanelets(
+    const lanelet::BasicPoint2d & search_point);
+
+  /**
+   * @brief same as routing_graph_ptr->possiblePaths(lanelet, {search_dist, {}, 0, false, true})
+   */
+  lanelet::routing::LaneletPaths possiblePaths(
+    const lanelet::ConstLanelet & lanelet, const double search_dist);
+
+private:
+  // Possible paths searched at search_dist, which are also the ones of any search distance in
+  // (min_search_dist, max_search_dist)
+  struct PossiblePathsEntry
+  {
+    lanelet::Id lanelet_id;
+    double min_search_dist;
+    double max_search_dist;
+    double search_dist;
+    lanelet::routing::LaneletPaths paths;
+  };
+  using PossiblePathsList = std::list<PossiblePathsEntry>;
+
+  static constexpr double cell_size_ = 10.0;                   // [m]
+  static constexpr size_t max_cached_possible_paths_ = 20000;  // [entries]
+
+  std::shared_ptr<lanelet::LaneletMap> lanelet_map_ptr_;
+  std::shared_ptr<lanelet::routing::RoutingGraph> routing_graph_ptr_;
+  size_t nearest_lanelet_num_;
+
+  std::unordered_map<std::uint64_t, lanelet::Lanelets> cell_candidates_;
+  // Ordered from the most recently used entry to the least recently used one
+  PossiblePathsList possible_paths_;
+  // Keyed by lanelet id and min_search_dist, which differ for the entries of different paths
+  std::map<std::pair<lanelet::Id, double>, PossiblePathsList::iterator> possible_paths_index_;
+  std::mutex possible_paths_mutex_;
+
+  const lanelet::Lanelets & getCellCandidates(const std::int64_t ix, const std::int64_t iy);
+  PossiblePathsEntry makePossiblePathsEntry(
+    const lanelet::ConstLanelet & lanelet, const double search_dist,
+    lanelet::routing::LaneletPaths paths) const;
+};
+}  // namespace map_based_prediction
+
+#endif  // MAP_BASED_PREDICTION__LANELET_QUERY_CACHE_HPP_
@@ -15,8 +15,10 @@
 #ifndef MAP_BASED_PREDICTION__MAP_BASED_PREDICTION_NODE_HPP_
 #define MAP_BASED_PREDICTION__MAP_BASED_PREDICTION_NODE_HPP_
 
+#include "map_based_prediction/lanelet_query_cache.hpp"
 #include "map_based_prediction/path_generator.hpp"
 #include "tf2/LinearMath/Quaternion.h"
+#include "tier4_autoware_utils/geometry/boost_geometry.hpp"
 #include "tier4_autoware_utils/geometry/geometry.hpp"
 #include "tier4_autoware_utils/ros/update_param.hpp"
 
@@ -37,6 +39,8 @@
 #include <geometry_msgs/msg/twist.hpp>
 #include <visualization_msgs/msg/marker_array.hpp>
 
+#include <boost/geometry/index/rtree.hpp>
+
 #include <lanelet2_core/Forward.h>
 #include <lanelet2_routing/Forward.h>
 #include <lanelet2_traffic_rules/TrafficRules.h>
@@ -45,6 +49,7 @@
 #include <deque>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <unordered_map>
@@ -137,11 +142,13 @@ private:
   // Object History
   std::unordered_map<std::string, std::deque<ObjectData>> objects_history_;
   std::map<std::pair<std::string, lanelet::Id>, rclcpp::Time> stopped_times_against_green_;
+  std::mutex stopped_times_against_green_mutex_;
 
   // Lanelet Map Pointers
   std::shared_ptr<lanelet::LaneletMap> lanelet_map_ptr_;
   std::shared_ptr<lanelet::routing::RoutingGraph> routing_graph_ptr_;
   std::shared_ptr<lanelet::traffic_rules::TrafficRules> traffic_rules_ptr_;
+  std::unique_ptr<LaneletQueryCache> lanelet_query_cache_;
 
   std::unordered_map<lanelet::Id, TrafficSignal> traffic_signal_id_map_;
 
@@ -159,6 +166,11 @@ private:
   // Crosswalk Entry Points
   lanelet::ConstLanelets crosswalks_;
 
+  // Fence segments of the map
+  boost::geometry::index::rtree<
+    tier4_autoware_utils::Segment2d, boost::geometry::index::rstar<16>>
+    fence_rtree_;
+
   // Parameters
   bool enable_delay_compensation_;
   double prediction_time_horizon_;
@@ -200,6 +212,8 @@ private:
   std::vector<double> distance_set_for_no_intention_to_walk_;
   std::vector<double> timeout_set_for_no_intention_to_walk_;
 
+  int num_threads_;
+
   std::unique_ptr<tier4_autoware_utils::PublishedTimePublisher> published_time_publisher_;
 
   // Member Functions
@@ -208,12 +222,9 @@ private:
   void objectsCallback(const TrackedObjects::ConstSharedPtr in_objects);
 
   bool doesPathCrossAnyFence(const PredictedPath & predicted_path);
-  bool doesPathCrossFence(
-    const PredictedPath & predicted_path, const lanelet::ConstLineString3d & fence_line);
-  lanelet::BasicLineString2d convertToFenceLine(const lanelet::ConstLineString3d & fence);
   bool isIntersecting(
     const geometry_msgs::msg::Point & point1, const geometry_msgs::msg::Point & point2,
-    const lanelet::ConstPoint3d & point3, const lanelet::ConstPoint3d & point4);
+    const tier4_autoware_utils::Point2d & point3, const tier4_autoware_utils::Point2d & point4);
 
   PredictedObjectKinematics convertToPredictedKinematics(
     const TrackedObjectKinematics & tracked_object);
@@ -222,6 +233,10 @@ private:
 
   PredictedObject getPredictedObjectAsCrosswalkUser(const TrackedObject & object);
 
+  std::optional<PredictedObject> getPredictedObjectAsVehicle(
+    const TrackedObject & object, const LaneletsData & current_lanelets,
+    const double objects_detected_time, std::optional<Maneuver> & debug_maneuver);
+
   void removeOldObjectsHistory(
     const double current_time, const TrackedObjects::ConstSharedPtr in_objects);
 
@@ -0,0 +1,163 @@
+// Copyright 2024 TIER IV, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "map_based_prediction/lanelet_query_cache.hpp"
+
+#include <lanelet2_core/LaneletMap.h>
+#include <lanelet2_core/geometry/Lanelet.h>
+#include <lanelet2_core/geometry/LaneletMap.h>
+#include <lanelet2_routing/RoutingGraph.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace map_based_prediction
+{
+LaneletQueryCache::LaneletQueryCache(
+  const std::shared_ptr<lanelet::LaneletMap> & lanelet_map_ptr,
+  const std::shared_ptr<lanelet::routing::RoutingGraph> & routing_graph_ptr,
+  const size_t nearest_lanelet_num)
+: lanelet_map_ptr_(lanelet_map_ptr),
+  routing_graph_ptr_(routing_graph_ptr),
+  nearest_lanelet_num_(nearest_lanelet_num)
+{
+}
+
+std::vector<std::pair<double, lanelet::Lanelet>> LaneletQueryCache::findNearestLanelets(
+  const lanelet::BasicPoint2d & search_point)
+{
+  const auto ix = static_cast<std::int64_t>(std::floor(search_point.x() / cell_size_));
+  const auto iy = static_cast<std::int64_t>(std::floor(search_point.y() / cell_size_));
+  const auto & candidates = getCellCandidates(ix, iy);
+
+  std::vector<std::pair<double, lanelet::Lanelet>> nearest_lanelets;
+  nearest_lanelets.reserve(candidates.size());
+  for (const auto & candidate : candidates) {
+    nearest_lanelets.emplace_back(
+      lanelet::geometry::distance2d(candidate, search_point), candidate);
+  }
+  const size_t nearest_lanelet_num = std::min(nearest_lanelets.size(), nearest_lanelet_num_);
+  std::partial_sort(
+    nearest_lanelets.begin(), nearest_lanelets.begin() + nearest_lanelet_num,
+    nearest_lanelets.end(),
+    [](const auto & a, const auto & b) { return a.first < b.first; });
+  nearest_lanelets.resize(nearest_lanelet_num);
+  return nearest_lanelets;
+}
+
+const lanelet::Lanelets & LaneletQueryCache::getCellCandidates(
+  const std::int64_t ix, const std::int64_t iy)
+{
+  const std::uint64_t key =
+    (static_cast<std::uint64_t>(ix) << 32) | static_cast<std::uint32_t>(iy);
+  const auto cell_itr = cell_candidates_.find(key);
+  if (cell_itr != cell_candidates_.end()) {
+    return cell_itr->second;
+  }
+
+  // The nearest lanelets of any point in the cell are closer to the cell center than the
+  // farthest nearest lanelet of the center, plus twice the distance from the center to a corner
+  auto & candidates = cell_candidates_[key];
+  const lanelet::BasicPoint2d center((ix + 0.5) * cell_size_, (iy + 0.5) * cell_size_);
+  const auto center_nearest_lanelets =
+    lanelet::geometry::findNearest(lanelet_map_ptr_->laneletLayer, center, nearest_lanelet_num_);
+  if (center_nearest_lanelets.empty()) {
+    return candidates;
+  }
+  const double half_diagonal = cell_size_ * M_SQRT1_2;
+  const double search_radius = center_nearest_lanelets.back().first + 2.0 * half_diagonal;
+  for (const auto & lanelet :
+       lanelet::geometry::findWithin2d(lanelet_map_ptr_->laneletLayer, center, search_radius)) {
+    candidates.push_back(lanelet.second);
+  }
+  return candidates;
+}
+
+lanelet::routing::LaneletPaths LaneletQueryCache::possiblePaths(
+  const lanelet::ConstLanelet & lanelet, const double search_dist)
+{
+  {
+    std::lock_guard<std::mutex> lock(possible_paths_mutex_);
+    // the entry of the lanelet with the largest min_search_dist not above search_dist
+    auto index_itr = possible_paths_index_.upper_bound(std::make_pair(lanelet.id(), search_dist));
+    if (index_itr != possible_paths_index_.begin()) {
+      --index_itr;
+      const auto & entry = *index_itr->second;
+      const bool in_range =
+        entry.min_search_dist < search_dist && search_dist < entry.max_search_dist;
+      if (entry.lanelet_id == lanelet.id() && (in_range || entry.search_dist == search_dist)) {
+        possible_paths_.splice(possible_paths_.begin(), possible_paths_, index_itr->second);
+        return entry.paths;
+      }
+    }
+  }
+
+  // Search outside the lock, so that the threads missing the cache do not wait for each other
+  const lanelet::routing::PossiblePathsParams possible_params{search_dist, {}, 0, false, true};
+  auto entry = makePossiblePathsEntry(
+    lanelet, search_dist, routing_graph_ptr_->possiblePaths(lanelet, possible_params));
+  auto paths = entry.paths;
+
+  std::lock_guard<std::mutex> lock(possible_paths_mutex_);
+  const auto key = std::make_pair(entry.lanelet_id, entry.min_search_dist);
+  if (possible_paths_index_.count(key) > 0) {
+    return paths;
+  }
+  possible_paths_.push_front(std::move(entry));
+  possible_paths_index_.emplace(key, possible_paths_.begin());
+  while (possible_paths_.size() > max_cached_possible_paths_) {
+    const auto & oldest = possible_paths_.back();
+    possible_paths_index_.erase(std::make_pair(oldest.lanelet_id, oldest.min_search_dist));
+    possible_paths_.pop_back();
+  }
+  return paths;
+}
+
+LaneletQueryCache::PossiblePathsEntry LaneletQueryCache::makePossiblePathsEntry(
+  const lanelet::ConstLanelet & lanelet, const double search_dist,
+  lanelet::routing::LaneletPaths paths) const
+{
+  // The paths are the branches of the shortest path tree from the lanelet, in which the lanelets
+  // whose routing cost is below search_dist are expanded. They stay the same as long as no lanelet
+  // of the tree has a routing cost between the search distances.
+  PossiblePathsEntry entry{
+    lanelet.id(), std::numeric_limits<double>::lowest(), std::numeric_limits<double>::max(),
+    search_dist, {}};
+  for (const auto & path : paths) {
+    double cost = 0.0;
+    for (size_t i = 0; i < path.size(); ++i) {
+      if (i > 0) {
+        const auto edge_cost = routing_graph_ptr_->getEdgeCost(path[i - 1], path[i]);
+        if (!edge_cost) {
+          // only reused for the same search distance
+          entry.min_search_dist = search_dist;
+          entry.max_search_dist = search_dist;
+          entry.paths = std::move(paths);
+          return entry;
+        }
+        cost += *edge_cost;
+      }
+      if (cost < search_dist) {
+        entry.min_search_dist = std::max(entry.min_search_dist, cost);
+      } else {
+        entry.max_search_dist = std::min(entry.max_search_dist, cost);
+      }
+    }
+  }
+  entry.paths = std::move(paths);
+  return entry;
+}
+}  // namespace map_based_prediction
@@ -788,6 +788,8 @@ MapBasedPredictionNode::MapBasedPredictionNode(const rclcpp::NodeOptions & node_
   timeout_set_for_no_intention_to_walk_ = declare_parameter<std::vector<double>>(
     "crosswalk_with_signal.timeout_set_for_no_intention_to_walk");
 
+  num_threads_ = declare_parameter<int>("num_threads");
+
   path_generator_ = std::make_shared<PathGenerator>(
     prediction_time_horizon_, lateral_control_time_horizon_, prediction_sampling_time_interval_,
     min_crosswalk_user_velocity_);
@@ -873,12 +875,30 @@ void MapBasedPredictionNode::mapCallback(const HADMapBin::ConstSharedPtr msg)
   lanelet::utils::conversion::fromBinMsg(
     *msg, lanelet_map_ptr_, &traffic_rules_ptr_, &routing_graph_ptr_);
   RCLCPP_DEBUG(get_logger(), "[Map Based Prediction]: Map is loaded");
+  lanelet_query_cache_ = std::make_unique<LaneletQueryCache>(
+    lanelet_map_ptr_, routing_graph_ptr_, /* nearest_lanelet_num = */ 10);
 
   const auto all_lanelets = lanelet::utils::query::laneletLayer(lanelet_map_ptr_);
+  // The centerlines are computed lazily by lanelet2, so compute them here before the objects are
+  // predicted in parallel
+  for (const auto & lanelet : all_lanelets) {
+    lanelet.centerline();
+  }
   const auto crosswalks = lanelet::utils::query::crosswalkLanelets(all_lanelets);
   const auto walkways = lanelet::utils::query::walkwayLanelets(all_lanelets);
   crosswalks_.insert(crosswalks_.end(), crosswalks.begin(), crosswalks.end());
   crosswalks_.insert(crosswalks_.end(), walkways.begin(), walkways.end());
+
+  // Index the fence segments once, since the fence crossing is checked for every crosswalk path
+  std::vector<tier4_autoware_utils::Segment2d> fence_segments;
+  for (const auto & fence : lanelet::utils::query::getAllFences(lanelet_map_ptr_)) {
+    for (size_t i = 0; i + 1 < fence.size(); ++i) {
+      fence_segments.emplace_back(
+        tier4_autoware_utils::Point2d{fence[i].x(), fence[i].y()},
+        tier4_autoware_utils::Point2d{fence[i + 1].x(), fence[i + 1].y()});
+    }
+  }
+  fence_rtree_ = decltype(fence_rtree_)(fence_segments);
 }
 
 void MapBasedPredictionNode::trafficSignalsCallback(const TrafficSignalArray::ConstSharedPtr msg)
@@ -926,9 +946,16 @@ void MapBasedPredictionNode::objectsCallback(const TrackedObjects::ConstSharedPt
   // result debug
   visualization_msgs::msg::MarkerArray debug_markers;
 
-  for (const auto & object : in_objects->objects) {
-    std::string object_id = tier4_autoware_utils::toHexString(object.object_id);
-    TrackedObject transformed_object = object;
+  // Transform the objects and update the history of the vehicles first. The history is the only
+  // state that gets new entries, so the prediction below can run on each object in parallel.
+  const size_t object_num = in_objects->objects.size();
+  std::vector<TrackedObject> transformed_objects(object_num);
+  std::vector<ObjectClassification::_label_type> labels(object_num);
+  std::vector<LaneletsData> current_lanelets_set(object_num);
+  for (size_t i = 0; i < object_num; ++i) {
+    const auto & object = in_objects->objects.at(i);
+    TrackedObject & transformed_object = transformed_objects.at(i);
+    transformed_object = object;
 
     // transform object frame if it's based on map frame
     if (in_objects->header.frame_id != "map") {
@@ -941,16 +968,9 @@ void MapBasedPredictionNode::objectsCallback(const TrackedObjects::ConstSharedPt
 
     // get tracking label and update it for the prediction
     const auto & label_ = transformed_object.classification.front().label;
-    const auto label = changeLabelForPrediction(label_, object, lanelet_map_ptr_);
+    labels.at(i) = changeLabelForPrediction(label_, object, lanelet_map_ptr_);
 
-    switch (label) {
-      case ObjectClassification::PEDESTRIAN:
-      case ObjectClassification::BICYCLE: {
-        const auto predicted_object_crosswalk =
-          getPredictedObjectAsCrosswalkUser(transformed_object);
-        output.objects.push_back(predicted_object_crosswalk);
-        break;
-      }
+    switch (labels.at(i)) {
       case ObjectClassification::CAR:
       case ObjectClassification::BUS:
       case ObjectClassification::TRAILER:
@@ -960,142 +980,37 @@ void MapBasedPredictionNode::objectsCallback(const TrackedObjects::ConstSharedPt
         updateObjectData(transformed_object);
 
         // Get Closest Lanelet
-        const auto current_lanelets = getCurrentLanelets(transformed_object);
+        current_lanelets_set.at(i) = getCurrentLanelets(transformed_object);
 
         // Update Objects History
-        updateObjectsHistory(output.header, transformed_object, current_lanelets);
-
-        // For off lane obstacles
-        if (current_lanelets.empty()) {
-          PredictedPath predicted_path =
-            path_generator_->generatePathForOffLaneVehicle(transformed_object);
-          predicted_path.confidence = 1.0;
-          if (predicted_path.path.empty()) break;
-
-          auto predicted_object_vehicle = convertToPredictedObject(transformed_object);
-          predicted_object_vehicle.kinematics.predicted_paths.push_back(predicted_path);
-          output.objects.push_back(predicted_object_vehicle);
-          break;
-        }
-
-        // For too-slow vehicle
-        const double abs_obj_speed = std::hypot(
-          transformed_object.kinematics.twist_with_covariance.twist.linear.x,
-          transformed_object.kinematics.twist_with_covariance.twist.linear.y);
-        if (std::fabs(abs_obj_speed) < min_velocity_for_map_based_prediction_) {
-          PredictedPath predicted_path =
-            path_generator_->generatePathForLowSpeedVehicle(transformed_object);
-          predicted_path.confidence = 1.0;
-          if (predicted_path.path.empty()) break;
-
-          auto predicted_slow_object = convertToPredictedObject(transformed_object);
-          predicted_slow_object.kinematics.predicted_paths.push_back(predicted_path);
-          output.objects.push_back(predicted_slow_object);
-          break;
-        }
-
-        // Get Predicted Reference Path for Each Maneuver and current lanelets
-        // return: <probability, paths>
-        const auto ref_paths =
-          getPredictedReferencePath(transformed_object, current_lanelets, objects_detected_time);
-
-        // If predicted reference path is empty, assume this object is out of the lane
-        if (ref_paths.empty()) {
-          PredictedPath predicted_path =
-            path_generator_->generatePathForLowSpeedVehicle(transformed_object);
-          predicted_path.confidence = 1.0;
-          if (predicted_path.path.empty()) break;
-
-          auto predicted_object_out_of_lane = convertToPredictedObject(transformed_object);
-          predicted_object_out_of_lane.kinematics.predicted_paths.push_back(predicted_path);
-          output.objects.push_back(predicted_object_out_of_lane);
-          break;
-        }
-
-        // Get Debug Marker for On Lane Vehicles
-        const auto max_prob_path = std::max_element(
-          ref_paths.begin(), ref_paths.end(),
-          [](const PredictedRefPath & a, const PredictedRefPath & b) {
-            return a.probability < b.probability;
-          });
-        const auto debug_marker =
-          getDebugMarker(object, max_prob_path->maneuver, debug_markers.markers.size());
-        debug_markers.markers.push_back(debug_marker);
-
-        // Fix object angle if its orientation unreliable (e.g. far object by radar sensor)
-        // This prevent bending predicted path
-        TrackedObject yaw_fixed_transformed_object = transformed_object;
-        if (
-          transformed_object.kinematics.orientation_availability ==
-          autoware_auto_perception_msgs::msg::TrackedObjectKinematics::UNAVAILABLE) {
-          replaceObjectYawWithLaneletsYaw(current_lanelets, yaw_fixed_transformed_object);
-        }
-        // Generate Predicted Path
-        std::vector<PredictedPath> predicted_paths;
-        double min_avg_curvature = std::numeric_limits<double>::max();
-        PredictedPath path_with_smallest_avg_curvature;
-
-        for (const auto & ref_path : ref_paths) {
-          PredictedPath predicted_path = path_generator_->generatePathForOnLaneVehicle(
-            yaw_fixed_transformed_object, ref_path.path, ref_path.speed_limit);
-          if (predicted_path.path.empty()) continue;
-
-          if (!check_lateral_acceleration_constraints_) {
-            predicted_path.confidence = ref_path.probability;
-            predicted_paths.push_back(predicted_path);
-            continue;
-          }
-
-          // Check lat. acceleration constraints
-          const auto trajectory_with_const_velocity =
-            toTrajectoryPoints(predicted_path, abs_obj_speed);
-
-          if (isLateralAccelerationConstraintSatisfied(
-                trajectory_with_const_velocity, prediction_sampling_time_interval_)) {
-            predicted_path.confidence = ref_path.probability;
-            predicted_paths.push_back(predicted_path);
-            continue;
-          }
-
-          // Calculate curvature assuming the trajectory points interval is constant
-          // In case all paths are deleted, a copy of the straightest path is kept
-
-          constexpr double curvature_calculation_distance = 2.0;
-          constexpr double points_interval = 1.0;
-          const size_t idx_dist = static_cast<size_t>(
-            std::max(static_cast<int>((curvature_calculation_distance) / points_interval), 1));
-          const auto curvature_v =
-            calcTrajectoryCurvatureFrom3Points(trajectory_with_const_velocity, idx_dist);
-          if (curvature_v.empty()) {
-            continue;
-          }
-          const auto curvature_avg =
-            std::accumulate(curvature_v.begin(), curvature_v.end(), 0.0) / curvature_v.size();
-          if (curvature_avg < min_avg_curvature) {
-            min_avg_curvature = curvature_avg;
-            path_with_smallest_avg_curvature = predicted_path;
-            path_with_smallest_avg_curvature.confidence = ref_path.probability;
-          }
-        }
-
-        if (predicted_paths.empty()) predicted_paths.push_back(path_with_smallest_avg_curvature);
-        // Normalize Path Confidence and output the predicted object
-
-        float sum_confidence = 0.0;
-        for (const auto & predicted_path : predicted_paths) {
-          sum_confidence += predicted_path.confidence;
-        }
-        const float min_sum_confidence_value = 1e-3;
-        sum_confidence = std::max(sum_confidence, min_sum_confidence_value);
-
-        auto predicted_object = convertToPredictedObject(transformed_object);
+        updateObjectsHistory(output.header, transformed_object, current_lanelets_set.at(i));
+        break;
+      }
+      default:
+        break;
+    }
+  }
 
-        for (auto & predicted_path : predicted_paths) {
-          predicted_path.confidence = predicted_path.confidence / sum_confidence;
-          if (predicted_object.kinematics.predicted_paths.size() >= 100) break;
-          predicted_object.kinematics.predicted_paths.push_back(predicted_path);
-        }
-        output.objects.push_back(predicted_object);
+  // Predict the paths. Each object only modifies its own entry of the history here.
+  std::vector<std::optional<PredictedObject>> predicted_objects(object_num);
+  std::vector<std::optional<Maneuver>> debug_maneuvers(object_num);
+#pragma omp parallel for num_threads(num_threads_) schedule(dynamic)
+  for (size_t i = 0; i < object_num; ++i) {
+    const TrackedObject & transformed_object = transformed_objects.at(i);
+    switch (labels.at(i)) {
+      case ObjectClassification::PEDESTRIAN:
+      case ObjectClassification::BICYCLE: {
+        predicted_objects.at(i) = getPredictedObjectAsCrosswalkUser(transformed_object);
+        break;
+      }
+      case ObjectClassification::CAR:
+      case ObjectClassification::BUS:
+      case ObjectClassification::TRAILER:
+      case ObjectClassification::MOTORCYCLE:
+      case ObjectClassification::TRUCK: {
+        predicted_objects.at(i) = getPredictedObjectAsVehicle(
+          transformed_object, current_lanelets_set.at(i), objects_detected_time,
+          debug_maneuvers.at(i));
         break;
       }
       default: {
@@ -1105,12 +1020,24 @@ void MapBasedPredictionNode::objectsCallback(const TrackedObjects::ConstSharedPt
         predicted_path.confidence = 1.0;
 
         predicted_unknown_object.kinematics.predicted_paths.push_back(predicted_path);
-        output.objects.push_back(predicted_unknown_object);
+        predicted_objects.at(i) = predicted_unknown_object;
         break;
       }
     }
   }
 
+  // Output the objects and the debug markers in the input order
+  for (size_t i = 0; i < object_num; ++i) {
+    if (debug_maneuvers.at(i)) {
+      const auto debug_marker = getDebugMarker(
+        in_objects->objects.at(i), *debug_maneuvers.at(i), debug_markers.markers.size());
+      debug_markers.markers.push_back(debug_marker);
+    }
+    if (predicted_objects.at(i)) {
+      output.objects.push_back(*predicted_objects.at(i));
+    }
+  }
+
   // Publish Results
   pub_objects_->publish(output);
   published_time_publisher_->publish_if_subscribed(pub_objects_, output.header.stamp);
@@ -1125,25 +1052,16 @@ void MapBasedPredictionNode::objectsCallback(const TrackedObjects::ConstSharedPt
 
 bool MapBasedPredictionNode::doesPathCrossAnyFence(const PredictedPath & predicted_path)
 {
-  const lanelet::ConstLineStrings3d & all_fences =
-    lanelet::utils::query::getAllFences(lanelet_map_ptr_);
-  for (const auto & fence_line : all_fences) {
-    if (doesPathCrossFence(predicted_path, fence_line)) {
-      return true;
-    }
-  }
-  return false;
-}
-
-bool MapBasedPredictionNode::doesPathCrossFence(
-  const PredictedPath & predicted_path, const lanelet::ConstLineString3d & fence_line)
-{
-  // check whether the predicted path cross with fence
-  for (size_t i = 0; i < predicted_path.path.size(); ++i) {
-    for (size_t j = 0; j < fence_line.size() - 1; ++j) {
-      if (isIntersecting(
-            predicted_path.path[i].position, predicted_path.path[i + 1].position, fence_line[j],
-            fence_line[j + 1])) {
+  // check whether the predicted path cross with fence, testing only the fence segments whose
+  // bounding box overlaps the one of the path segment
+  for (size_t i = 0; i + 1 < predicted_path.path.size(); ++i) {
+    const auto & p1 = predicted_path.path[i].position;
+    const auto & p2 = predicted_path.path[i + 1].position;
+    const tier4_autoware_utils::Box2d path_segment_box(
+      {std::min(p1.x, p2.x), std::min(p1.y, p2.y)}, {std::max(p1.x, p2.x), std::max(p1.y, p2.y)});
+    for (auto itr = fence_rtree_.qbegin(boost::geometry::index::intersects(path_segment_box));
+         itr != fence_rtree_.qend(); ++itr) {
+      if (isIntersecting(p1, p2, itr->first, itr->second)) {
         return true;
       }
     }
@@ -1153,7 +1071,7 @@ bool MapBasedPredictionNode::doesPathCrossFence(
 
 bool MapBasedPredictionNode::isIntersecting(
   const geometry_msgs::msg::Point & point1, const geometry_msgs::msg::Point & point2,
-  const lanelet::ConstPoint3d & point3, const lanelet::ConstPoint3d & point4)
+  const tier4_autoware_utils::Point2d & point3, const tier4_autoware_utils::Point2d & point4)
 {
   const auto p1 = tier4_autoware_utils::createPoint(point1.x, point1.y, 0.0);
   const auto p2 = tier4_autoware_utils::createPoint(point2.x, point2.y, 0.0);
@@ -1295,6 +1213,134 @@ PredictedObject MapBasedPredictionNode::getPredictedObjectAsCrosswalkUser(
   return predicted_object;
 }
 
+std::optional<PredictedObject> MapBasedPredictionNode::getPredictedObjectAsVehicle(
+  const TrackedObject & object, const LaneletsData & current_lanelets,
+  const double objects_detected_time, std::optional<Maneuver> & debug_maneuver)
+{
+  // For off lane obstacles
+  if (current_lanelets.empty()) {
+    PredictedPath predicted_path = path_generator_->generatePathForOffLaneVehicle(object);
+    predicted_path.confidence = 1.0;
+    if (predicted_path.path.empty()) return std::nullopt;
+
+    auto predicted_object_vehicle = convertToPredictedObject(object);
+    predicted_object_vehicle.kinematics.predicted_paths.push_back(predicted_path);
+    return predicted_object_vehicle;
+  }
+
+  // For too-slow vehicle
+  const double abs_obj_speed = std::hypot(
+    object.kinematics.twist_with_covariance.twist.linear.x,
+    object.kinematics.twist_with_covariance.twist.linear.y);
+  if (std::fabs(abs_obj_speed) < min_velocity_for_map_based_prediction_) {
+    PredictedPath predicted_path = path_generator_->generatePathForLowSpeedVehicle(object);
+    predicted_path.confidence = 1.0;
+    if (predicted_path.path.empty()) return std::nullopt;
+
+    auto predicted_slow_object = convertToPredictedObject(object);
+    predicted_slow_object.kinematics.predicted_paths.push_back(predicted_path);
+    return predicted_slow_object;
+  }
+
+  // Get Predicted Reference Path for Each Maneuver and current lanelets
+  // return: <probability, paths>
+  const auto ref_paths =
+    getPredictedReferencePath(object, current_lanelets, objects_detected_time);
+
+  // If predicted reference path is empty, assume this object is out of the lane
+  if (ref_paths.empty()) {
+    PredictedPath predicted_path = path_generator_->generatePathForLowSpeedVehicle(object);
+    predicted_path.confidence = 1.0;
+    if (predicted_path.path.empty()) return std::nullopt;
+
+    auto predicted_object_out_of_lane = convertToPredictedObject(object);
+    predicted_object_out_of_lane.kinematics.predicted_paths.push_back(predicted_path);
+    return predicted_object_out_of_lane;
+  }
+
+  // Get Maneuver of the Debug Marker for On Lane Vehicles
+  const auto max_prob_path = std::max_element(
+    ref_paths.begin(), ref_paths.end(),
+    [](const PredictedRefPath & a, const PredictedRefPath & b) {
+      return a.probability < b.probability;
+    });
+  debug_maneuver = max_prob_path->maneuver;
+
+  // Fix object angle if its orientation unreliable (e.g. far object by radar sensor)
+  // This prevent bending predicted path
+  TrackedObject yaw_fixed_object = object;
+  if (
+    object.kinematics.orientation_availability ==
+    autoware_auto_perception_msgs::msg::TrackedObjectKinematics::UNAVAILABLE) {
+    replaceObjectYawWithLaneletsYaw(current_lanelets, yaw_fixed_object);
+  }
+  // Generate Predicted Path
+  std::vector<PredictedPath> predicted_paths;
+  double min_avg_curvature = std::numeric_limits<double>::max();
+  PredictedPath path_with_smallest_avg_curvature;
+
+  for (const auto & ref_path : ref_paths) {
+    PredictedPath predicted_path = path_generator_->generatePathForOnLaneVehicle(
+      yaw_fixed_object, ref_path.path, ref_path.speed_limit);
+    if (predicted_path.path.empty()) continue;
+
+    if (!check_lateral_acceleration_constraints_) {
+      predicted_path.confidence = ref_path.probability;
+      predicted_paths.push_back(predicted_path);
+      continue;
+    }
+
+    // Check lat. acceleration constraints
+    const auto trajectory_with_const_velocity = toTrajectoryPoints(predicted_path, abs_obj_speed);
+
+    if (isLateralAccelerationConstraintSatisfied(
+          trajectory_with_const_velocity, prediction_sampling_time_interval_)) {
+      predicted_path.confidence = ref_path.probability;
+      predicted_paths.push_back(predicted_path);
+      continue;
+    }
+
+    // Calculate curvature assuming the trajectory points interval is constant
+    // In case all paths are deleted, a copy of the straightest path is kept
+
+    constexpr double curvature_calculation_distance = 2.0;
+    constexpr double points_interval = 1.0;
+    const size_t idx_dist = static_cast<size_t>(
+      std::max(static_cast<int>((curvature_calculation_distance) / points_interval), 1));
+    const auto curvature_v =
+      calcTrajectoryCurvatureFrom3Points(trajectory_with_const_velocity, idx_dist);
+    if (curvature_v.empty()) {
+      continue;
+    }
+    const auto curvature_avg =
+      std::accumulate(curvature_v.begin(), curvature_v.end(), 0.0) / curvature_v.size();
+    if (curvature_avg < min_avg_curvature) {
+      min_avg_curvature = curvature_avg;
+      path_with_smallest_avg_curvature = predicted_path;
+      path_with_smallest_avg_curvature.confidence = ref_path.probability;
+    }
+  }
+
+  if (predicted_paths.empty()) predicted_paths.push_back(path_with_smallest_avg_curvature);
+  // Normalize Path Confidence and output the predicted object
+
+  float sum_confidence = 0.0;
+  for (const auto & predicted_path : predicted_paths) {
+    sum_confidence += predicted_path.confidence;
+  }
+  const float min_sum_confidence_value = 1e-3;
+  sum_confidence = std::max(sum_confidence, min_sum_confidence_value);
+
+  auto predicted_object = convertToPredictedObject(object);
+
+  for (auto & predicted_path : predicted_paths) {
+    predicted_path.confidence = predicted_path.confidence / sum_confidence;
+    if (predicted_object.kinematics.predicted_paths.size() >= 100) break;
+    predicted_object.kinematics.predicted_paths.push_back(predicted_path);
+  }
+  return predicted_object;
+}
+
 void MapBasedPredictionNode::updateObjectData(TrackedObject & object)
 {
   if (
@@ -1409,7 +1455,7 @@ LaneletsData MapBasedPredictionNode::getCurrentLanelets(const TrackedObject & ob
 
   // nearest lanelet
   std::vector<std::pair<double, lanelet::Lanelet>> surrounding_lanelets =
-    lanelet::geometry::findNearest(lanelet_map_ptr_->laneletLayer, search_point, 10);
+    lanelet_query_cache_->findNearestLanelets(search_point);
 
   {  // Step 1. Search same directional lanelets
     // No Closest Lanelets
@@ -1671,7 +1717,6 @@ std::vector<PredictedRefPath> MapBasedPredictionNode::getPredictedReferencePath(
                            : get_search_distance_with_decaying_acc();
     search_dist += lanelet::utils::getLaneletLength3d(current_lanelet_data.lanelet);
 
-    lanelet::routing::PossiblePathsParams possible_params{search_dist, {}, 0, false, true};
     const double validate_time_horizon =
       t_h * prediction_time_horizon_rate_for_validate_lane_length_;
 
@@ -1680,7 +1725,7 @@ std::vector<PredictedRefPath> MapBasedPredictionNode::getPredictedReferencePath(
     auto getPathsForNormalOrIsolatedLanelet = [&](const lanelet::ConstLanelet & lanelet) {
       // if lanelet is not isolated, return normal possible paths
       if (!isIsolatedLanelet(lanelet, routing_graph_ptr_)) {
-        return routing_graph_ptr_->possiblePaths(lanelet, possible_params);
+        return lanelet_query_cache_->possiblePaths(lanelet, search_dist);
       }
       // if lanelet is isolated, check if it has enough length
       if (!validateIsolatedLaneletLength(lanelet, object, validate_time_horizon)) {
@@ -2305,6 +2350,8 @@ bool MapBasedPredictionNode::calcIntentionToCrossWithTrafficSignal(
   }();
 
   const auto key = std::make_pair(tier4_autoware_utils::toHexString(object.object_id), signal_id);
+  // The crosswalk users are predicted in parallel
+  std::lock_guard<std::mutex> lock(stopped_times_against_green_mutex_);
   if (
     signal_color == TrafficSignalElement::GREEN &&
     tier4_autoware_utils::calcNorm(object.kinematics.twist_with_covariance.twist.linear) <
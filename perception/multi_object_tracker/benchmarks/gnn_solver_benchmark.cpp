@@ -0,0 +1,185 @@
+// Copyright 2024 TIER IV, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Compares the dense and the sparse entry points of the GNN solvers on synthetic association
+// problems.
+//
+// usage: gnn_solver_benchmark [-r <repeats>]
+//
+// In the dense problems every agent can be assigned to every task. In the sparse problems the
+// agents and the tasks are scattered on a plane, and only the pairs closer than the gate distance
+// have a score, like after the gating of the data association.
+
+#include "multi_object_tracker/data_association/solver/gnn_solver.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using gnn_solver::GnnSolverInterface;
+using gnn_solver::ScoreEdge;
+
+constexpr double area_length = 200.0;  // [m]
+constexpr double gate_distance = 5.0;  // [m]
+
+struct Problem
+{
+  std::string name;
+  int n_agents;
+  int n_tasks;
+  std::vector<ScoreEdge> scores;
+};
+
+Problem make_dense_problem(const int n_agents, const int n_tasks, std::mt19937 & engine)
+{
+  std::uniform_real_distribution<double> score_distribution(0.01, 1.0);
+  Problem problem{"dense", n_agents, n_tasks, {}};
+  for (int agent = 0; agent < n_agents; ++agent) {
+    for (int task = 0; task < n_tasks; ++task) {
+      problem.scores.push_back({agent, task, score_distribution(engine)});
+    }
+  }
+  return problem;
+}
+
+Problem make_sparse_problem(const int n_agents, const int n_tasks, std::mt19937 & engine)
+{
+  std::uniform_real_distribution<double> position_distribution(0.0, area_length);
+  std::normal_distribution<double> noise_distribution(0.0, 1.0);
+  std::vector<std::pair<double, double>> agents(n_agents);
+  for (auto & agent : agents) {
+    agent = {position_distribution(engine), position_distribution(engine)};
+  }
+  // Tasks are noisy observations of the agents, then clutter
+  std::vector<std::pair<double, double>> tasks(n_tasks);
+  for (int task = 0; task < n_tasks; ++task) {
+    if (task < n_agents) {
+      tasks.at(task) = {
+        agents.at(task).first + noise_distribution(engine),
+        agents.at(task).second + noise_distribution(engine)};
+    } else {
+      tasks.at(task) = {position_distribution(engine), position_distribution(engine)};
+    }
+  }
+
+  Problem problem{"sparse", n_agents, n_tasks, {}};
+  for (int agent = 0; agent < n_agents; ++agent) {
+    for (int task = 0; task < n_tasks; ++task) {
+      const double dist = std::hypot(
+        agents.at(agent).first - tasks.at(task).first,
+        agents.at(agent).second - tasks.at(task).second);
+      if (dist < gate_distance) {
+        problem.scores.push_back({agent, task, (gate_distance - dist) / gate_distance});
+      }
+    }
+  }
+  return problem;
+}
+
+std::vector<std::vector<double>> to_dense(const Problem & problem)
+{
+  std::vector<std::vector<double>> cost(
+    problem.n_agents, std::vector<double>(problem.n_tasks, 0.0));
+  for (const auto & edge : problem.scores) {
+    cost.at(edge.agent).at(edge.task) = edge.score;
+  }
+  return cost;
+}
+
+double total_score(const Problem & problem, const std::unordered_map<int, int> & assignment)
+{
+  const auto cost = to_dense(problem);
+  double total = 0.0;
+  for (const auto & [agent, task] : assignment) {
+    total += cost.at(agent).at(task);
+  }
+  return total;
+}
+
+template <typename Func>
+double measure_ms(const int repeats, Func && func)
+{
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < repeats; ++i) {
+    func();
+  }
+  const auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count() / repeats;
+}
+
+void run(
+  const std::string & solver_name, GnnSolverInterface & solver, const Problem & problem,
+  const int repeats)
+{
+  std::unordered_map<int, int> dense_direct, dense_reverse;
+  std::unordered_map<int, int> sparse_direct, sparse_reverse;
+
+  // The dense time includes the construction of the dense matrix, as in the data association
+  const double dense_ms = measure_ms(repeats, [&]() {
+    dense_direct.clear();
+    dense_reverse.clear();
+    solver.maximizeLinearAssignment(to_dense(problem), &dense_direct, &dense_reverse);
+  });
+  const double sparse_ms = measure_ms(repeats, [&]() {
+    sparse_direct.clear();
+    sparse_reverse.clear();
+    solver.maximizeSparseLinearAssignment(
+      problem.n_agents, problem.n_tasks, problem.scores, &sparse_direct, &sparse_reverse);
+  });
+
+  std::printf(
+    "%-6s %-6s %4d x %4d  edges: %6zu  dense: %9.3f [ms] (score %8.3f)  "
+    "sparse: %9.3f [ms] (score %8.3f)\n",
+    solver_name.c_str(), problem.name.c_str(), problem.n_agents, problem.n_tasks,
+    problem.scores.size(), dense_ms, total_score(problem, dense_direct), sparse_ms,
+    total_score(problem, sparse_direct));
+}
+
+int main(int argc, char ** argv)
+{
+  int repeats = 10;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+      repeats = std::max(std::atoi(argv[++i]), 1);
+    } else {
+      std::fprintf(stderr, "usage: %s [-r <repeats>]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  std::mt19937 engine(0);
+  std::vector<Problem> problems;
+  for (const auto & [n_agents, n_tasks] :
+       std::vector<std::pair<int, int>>{{20, 30}, {50, 70}, {150, 200}}) {
+    problems.push_back(make_dense_problem(n_agents, n_tasks, engine));
+    problems.push_back(make_sparse_problem(n_agents, n_tasks, engine));
+  }
+
+  gnn_solver::MuSSP mussp;
+  gnn_solver::SSP ssp;
+  for (const auto & problem : problems) {
+    run("muSSP", mussp, problem, repeats);
+    run("SSP", ssp, problem, repeats);
+  }
+  return 0;
+}
@@ -19,7 +19,6 @@
 #ifndef MULTI_OBJECT_TRACKER__DATA_ASSOCIATION__DATA_ASSOCIATION_HPP_
 #define MULTI_OBJECT_TRACKER__DATA_ASSOCIATION__DATA_ASSOCIATION_HPP_
 
-#include <list>
 #include <memory>
 #include <unordered_map>
 #include <vector>
@@ -30,6 +29,7 @@
 
 #include <Eigen/Core>
 #include <Eigen/Geometry>
+#include <Eigen/Sparse>
 
 #include <autoware_auto_perception_msgs/msg/detected_objects.hpp>
 
@@ -45,6 +45,12 @@ private:
   const double score_threshold_;
   std::unique_ptr<gnn_solver::GnnSolverInterface> gnn_solver_ptr_;
 
+  double calcScore(
+    const autoware_auto_perception_msgs::msg::DetectedObject & measurement_object,
+    const std::uint8_t measurement_label,
+    const autoware_auto_perception_msgs::msg::TrackedObject & tracked_object,
+    const Eigen::Matrix2d & tracker_inverse_covariance, const std::uint8_t tracker_label) const;
+
 public:
   EIGEN_MAKE_ALIGNED_OPERATOR_NEW
   DataAssociation(
@@ -52,11 +58,12 @@ public:
     std::vector<double> max_area_vector, std::vector<double> min_area_vector,
     std::vector<double> max_rad_vector, std::vector<double> min_iou_vector);
   void assign(
-    const Eigen::MatrixXd & src, std::unordered_map<int, int> & direct_assignment,
+    const Eigen::SparseMatrix<double> & src, std::unordered_map<int, int> & direct_assignment,
     std::unordered_map<int, int> & reverse_assignment);
-  Eigen::MatrixXd calcScoreMatrix(
+  // Only the pairs that pass all the gates are stored, so the other scores are 0
+  Eigen::SparseMatrix<double> calcScoreMatrix(
     const autoware_auto_perception_msgs::msg::DetectedObjects & measurements,
-    const std::list<std::shared_ptr<Tracker>> & trackers);
+    const std::vector<std::shared_ptr<Tracker>> & trackers);
   virtual ~DataAssociation() {}
 };
 
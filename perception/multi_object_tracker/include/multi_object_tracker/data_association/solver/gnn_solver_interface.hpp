@@ -20,6 +20,14 @@
 
 namespace gnn_solver
 {
+// Score of assigning the task to the agent
+struct ScoreEdge
+{
+  int agent;
+  int task;
+  double score;
+};
+
 class GnnSolverInterface
 {
 public:
@@ -29,6 +37,12 @@ public:
   virtual void maximizeLinearAssignment(
     const std::vector<std::vector<double>> & cost, std::unordered_map<int, int> * direct_assignment,
     std::unordered_map<int, int> * reverse_assignment) = 0;
+
+  // Same as maximizeLinearAssignment, with the score matrix given as its non-zero entries
+  virtual void maximizeSparseLinearAssignment(
+    const int n_agents, const int n_tasks, const std::vector<ScoreEdge> & scores,
+    std::unordered_map<int, int> * direct_assignment,
+    std::unordered_map<int, int> * reverse_assignment) = 0;
 };
 }  // namespace gnn_solver
 
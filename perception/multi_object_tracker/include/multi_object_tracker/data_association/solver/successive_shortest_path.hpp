@@ -31,6 +31,11 @@ public:
   void maximizeLinearAssignment(
     const std::vector<std::vector<double>> & cost, std::unordered_map<int, int> * direct_assignment,
     std::unordered_map<int, int> * reverse_assignment) override;
+
+  void maximizeSparseLinearAssignment(
+    const int n_agents, const int n_tasks, const std::vector<ScoreEdge> & scores,
+    std::unordered_map<int, int> * direct_assignment,
+    std::unordered_map<int, int> * reverse_assignment) override;
 };
 }  // namespace gnn_solver
 
@@ -28,6 +28,7 @@
 #include <geometry_msgs/msg/pose_stamped.hpp>
 
 #include <memory>
+#include <string>
 
 /**
  * @brief Debugger class for multi object tracker
@@ -44,6 +45,7 @@ public:
   void endMeasurementTime(const rclcpp::Time & now);
   void startPublishTime(const rclcpp::Time & now);
   void endPublishTime(const rclcpp::Time & now, const rclcpp::Time & object_time);
+  void publishStageTime(const std::string & stage, const double time_ms) const;
 
   void setupDiagnostics();
   void checkDelay(diagnostic_updater::DiagnosticStatusWrapper & stat);
@@ -24,7 +24,6 @@
 #include <autoware_auto_perception_msgs/msg/detected_objects.hpp>
 #include <autoware_auto_perception_msgs/msg/tracked_objects.hpp>
 
-#include <list>
 #include <map>
 #include <memory>
 #include <string>
@@ -34,9 +33,9 @@
 class TrackerProcessor
 {
 public:
-  explicit TrackerProcessor(const std::map<std::uint8_t, std::string> & tracker_map);
+  TrackerProcessor(const std::map<std::uint8_t, std::string> & tracker_map, const int num_threads);
 
-  const std::list<std::shared_ptr<Tracker>> & getListTracker() const { return list_tracker_; }
+  const std::vector<std::shared_ptr<Tracker>> & getListTracker() const { return list_tracker_; }
   // tracker processes
   void predict(const rclcpp::Time & time);
   void update(
@@ -60,7 +59,7 @@ public:
 
 private:
   std::map<std::uint8_t, std::string> tracker_map_;
-  std::list<std::shared_ptr<Tracker>> list_tracker_;
+  std::vector<std::shared_ptr<Tracker>> list_tracker_;
 
   // parameters
   float max_elapsed_time_;            // [s]
@@ -68,6 +67,7 @@ private:
   float min_iou_for_unknown_object_;  // [ratio]
   double distance_threshold_;         // [m]
   int confident_count_threshold_;     // [count]
+  int num_threads_;                   // threads for predicting and updating the trackers
 
   void removeOldTracker(const rclcpp::Time & time);
   void removeOverlappedTracker(const rclcpp::Time & time);
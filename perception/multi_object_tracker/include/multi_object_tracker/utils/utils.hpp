@@ -25,6 +25,7 @@
 #include <autoware_auto_perception_msgs/msg/detected_object.hpp>
 #include <autoware_auto_perception_msgs/msg/shape.hpp>
 #include <autoware_auto_perception_msgs/msg/tracked_object.hpp>
+#include <geometry_msgs/msg/point.hpp>
 #include <geometry_msgs/msg/polygon.hpp>
 #include <geometry_msgs/msg/transform.hpp>
 #include <geometry_msgs/msg/vector3.hpp>
@@ -33,7 +34,9 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <tuple>
+#include <unordered_map>
 #include <vector>
 
 namespace utils
@@ -369,6 +372,55 @@ inline bool getMeasurementYaw(
          autoware_auto_perception_msgs::msg::DetectedObjectKinematics::UNAVAILABLE;
 }
 
+/**
+ * @brief uniform grid of indexed 2D positions, to find the positions close to a point
+ */
+class PositionGrid
+{
+public:
+  explicit PositionGrid(const double cell_size) : cell_size_(cell_size) {}
+
+  void insert(const size_t index, const geometry_msgs::msg::Point & position)
+  {
+    cells_[getCellKey(getCellIndex(position.x), getCellIndex(position.y))].push_back(index);
+  }
+
+  /**
+   * @brief get the indices of the positions in the 3x3 cells around the point, in ascending order
+   * @param position: query point
+   * @param indices: output indices, which include all the positions closer than the cell size
+   */
+  void findNeighbors(
+    const geometry_msgs::msg::Point & position, std::vector<size_t> & indices) const
+  {
+    indices.clear();
+    const std::int64_t ix = getCellIndex(position.x);
+    const std::int64_t iy = getCellIndex(position.y);
+    for (std::int64_t dx = -1; dx <= 1; ++dx) {
+      for (std::int64_t dy = -1; dy <= 1; ++dy) {
+        const auto cell_itr = cells_.find(getCellKey(ix + dx, iy + dy));
+        if (cell_itr != cells_.end()) {
+          indices.insert(indices.end(), cell_itr->second.begin(), cell_itr->second.end());
+        }
+      }
+    }
+    std::sort(indices.begin(), indices.end());
+  }
+
+private:
+  double cell_size_;
+  std::unordered_map<std::uint64_t, std::vector<size_t>> cells_;
+
+  std::int64_t getCellIndex(const double x) const
+  {
+    return static_cast<std::int64_t>(std::floor(x / cell_size_));
+  }
+  static std::uint64_t getCellKey(const std::int64_t ix, const std::int64_t iy)
+  {
+    return (static_cast<std::uint64_t>(ix) << 32) | static_cast<std::uint32_t>(iy);
+  }
+};
+
 }  // namespace utils
 
 #endif  // MULTI_OBJECT_TRACKER__UTILS__UTILS_HPP_
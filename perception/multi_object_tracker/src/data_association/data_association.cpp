@@ -19,7 +19,8 @@
 #include "object_recognition_utils/object_recognition_utils.hpp"
 
 #include <algorithm>
-#include <list>
+#include <cmath>
+#include <cstdint>
 #include <memory>
 #include <unordered_map>
 #include <vector>
@@ -28,14 +29,14 @@ namespace
 {
 double getMahalanobisDistance(
   const geometry_msgs::msg::Point & measurement, const geometry_msgs::msg::Point & tracker,
-  const Eigen::Matrix2d & covariance)
+  const Eigen::Matrix2d & inverse_covariance)
 {
   Eigen::Vector2d measurement_point;
   measurement_point << measurement.x, measurement.y;
   Eigen::Vector2d tracker_point;
   tracker_point << tracker.x, tracker.y;
   Eigen::MatrixXd mahalanobis_squared = (measurement_point - tracker_point).transpose() *
-                                        covariance.inverse() * (measurement_point - tracker_point);
+                                        inverse_covariance * (measurement_point - tracker_point);
   return std::sqrt(mahalanobis_squared(0));
 }
 
@@ -115,21 +116,22 @@ DataAssociation::DataAssociation(
 }
 
 void DataAssociation::assign(
-  const Eigen::MatrixXd & src, std::unordered_map<int, int> & direct_assignment,
+  const Eigen::SparseMatrix<double> & src, std::unordered_map<int, int> & direct_assignment,
   std::unordered_map<int, int> & reverse_assignment)
 {
-  std::vector<std::vector<double>> score(src.rows());
-  for (int row = 0; row < src.rows(); ++row) {
-    score.at(row).resize(src.cols());
-    for (int col = 0; col < src.cols(); ++col) {
-      score.at(row).at(col) = src(row, col);
+  std::vector<gnn_solver::ScoreEdge> scores;
+  scores.reserve(src.nonZeros());
+  for (int col = 0; col < src.outerSize(); ++col) {
+    for (Eigen::SparseMatrix<double>::InnerIterator it(src, col); it; ++it) {
+      scores.push_back({static_cast<int>(it.row()), static_cast<int>(it.col()), it.value()});
     }
   }
   // Solve
-  gnn_solver_ptr_->maximizeLinearAssignment(score, &direct_assignment, &reverse_assignment);
+  gnn_solver_ptr_->maximizeSparseLinearAssignment(
+    src.rows(), src.cols(), scores, &direct_assignment, &reverse_assignment);
 
   for (auto itr = direct_assignment.begin(); itr != direct_assignment.end();) {
-    if (src(itr->first, itr->second) < score_threshold_) {
+    if (src.coeff(itr->first, itr->second) < score_threshold_) {
       itr = direct_assignment.erase(itr);
       continue;
     } else {
@@ -137,7 +139,7 @@ void DataAssociation::assign(
     }
   }
   for (auto itr = reverse_assignment.begin(); itr != reverse_assignment.end();) {
-    if (src(itr->second, itr->first) < score_threshold_) {
+    if (src.coeff(itr->second, itr->first) < score_threshold_) {
       itr = reverse_assignment.erase(itr);
       continue;
     } else {
@@ -146,81 +148,102 @@ void DataAssociation::assign(
   }
 }
 
-Eigen::MatrixXd DataAssociation::calcScoreMatrix(
+Eigen::SparseMatrix<double> DataAssociation::calcScoreMatrix(
   const autoware_auto_perception_msgs::msg::DetectedObjects & measurements,
-  const std::list<std::shared_ptr<Tracker>> & trackers)
+  const std::vector<std::shared_ptr<Tracker>> & trackers)
 {
-  Eigen::MatrixXd score_matrix =
-    Eigen::MatrixXd::Zero(trackers.size(), measurements.objects.size());
-  size_t tracker_idx = 0;
-  for (auto tracker_itr = trackers.begin(); tracker_itr != trackers.end();
-       ++tracker_itr, ++tracker_idx) {
-    const std::uint8_t tracker_label = (*tracker_itr)->getHighestProbLabel();
-
-    for (size_t measurement_idx = 0; measurement_idx < measurements.objects.size();
-         ++measurement_idx) {
-      const autoware_auto_perception_msgs::msg::DetectedObject & measurement_object =
-        measurements.objects.at(measurement_idx);
-      const std::uint8_t measurement_label =
-        object_recognition_utils::getHighestProbLabel(measurement_object.classification);
-
-      double score = 0.0;
-      if (can_assign_matrix_(tracker_label, measurement_label)) {
-        autoware_auto_perception_msgs::msg::TrackedObject tracked_object;
-        (*tracker_itr)->getTrackedObject(measurements.header.stamp, tracked_object);
-
-        const double max_dist = max_dist_matrix_(tracker_label, measurement_label);
-        const double dist = tier4_autoware_utils::calcDistance2d(
-          measurement_object.kinematics.pose_with_covariance.pose.position,
-          tracked_object.kinematics.pose_with_covariance.pose.position);
-
-        bool passed_gate = true;
-        // dist gate
-        if (passed_gate) {
-          if (max_dist < dist) passed_gate = false;
-        }
-        // area gate
-        if (passed_gate) {
-          const double max_area = max_area_matrix_(tracker_label, measurement_label);
-          const double min_area = min_area_matrix_(tracker_label, measurement_label);
-          const double area = tier4_autoware_utils::getArea(measurement_object.shape);
-          if (area < min_area || max_area < area) passed_gate = false;
-        }
-        // angle gate
-        if (passed_gate) {
-          const double max_rad = max_rad_matrix_(tracker_label, measurement_label);
-          const double angle = getFormedYawAngle(
-            measurement_object.kinematics.pose_with_covariance.pose.orientation,
-            tracked_object.kinematics.pose_with_covariance.pose.orientation, false);
-          if (std::fabs(max_rad) < M_PI && std::fabs(max_rad) < std::fabs(angle))
-            passed_gate = false;
-        }
-        // mahalanobis dist gate
-        if (passed_gate) {
-          const double mahalanobis_dist = getMahalanobisDistance(
-            measurement_object.kinematics.pose_with_covariance.pose.position,
-            tracked_object.kinematics.pose_with_covariance.pose.position,
-            getXYCovariance(tracked_object.kinematics.pose_with_covariance));
-          if (3.035 /*99%*/ <= mahalanobis_dist) passed_gate = false;
-        }
-        // 2d iou gate
-        if (passed_gate) {
-          const double min_iou = min_iou_matrix_(tracker_label, measurement_label);
-          const double min_union_iou_area = 1e-2;
-          const double iou = object_recognition_utils::get2dIoU(
-            measurement_object, tracked_object, min_union_iou_area);
-          if (iou < min_iou) passed_gate = false;
-        }
-
-        // all gate is passed
-        if (passed_gate) {
-          score = (max_dist - std::min(dist, max_dist)) / max_dist;
-          if (score < score_threshold_) score = 0.0;
-        }
+  // Bucket the measurements into a grid whose cell is the largest gate distance, so that a tracker
+  // only needs to be scored against the measurements in the 3x3 cells around it
+  utils::PositionGrid measurement_grid(std::max(max_dist_matrix_.maxCoeff(), 1.0));
+  std::vector<std::uint8_t> measurement_labels(measurements.objects.size());
+  for (size_t measurement_idx = 0; measurement_idx < measurements.objects.size();
+       ++measurement_idx) {
+    const autoware_auto_perception_msgs::msg::DetectedObject & measurement_object =
+      measurements.objects.at(measurement_idx);
+    measurement_labels.at(measurement_idx) =
+      object_recognition_utils::getHighestProbLabel(measurement_object.classification);
+    measurement_grid.insert(
+      measurement_idx, measurement_object.kinematics.pose_with_covariance.pose.position);
+  }
+
+  std::vector<Eigen::Triplet<double>> scores;
+  std::vector<size_t> candidate_indices;
+  for (size_t tracker_idx = 0; tracker_idx < trackers.size(); ++tracker_idx) {
+    const auto & tracker = trackers.at(tracker_idx);
+    const std::uint8_t tracker_label = tracker->getHighestProbLabel();
+
+    // Predict the tracker once for all the measurements
+    autoware_auto_perception_msgs::msg::TrackedObject tracked_object;
+    tracker->getTrackedObject(measurements.header.stamp, tracked_object);
+    const Eigen::Matrix2d tracker_inverse_covariance =
+      getXYCovariance(tracked_object.kinematics.pose_with_covariance).inverse();
+
+    measurement_grid.findNeighbors(
+      tracked_object.kinematics.pose_with_covariance.pose.position, candidate_indices);
+
+    for (const size_t measurement_idx : candidate_indices) {
+      const std::uint8_t measurement_label = measurement_labels.at(measurement_idx);
+      if (!can_assign_matrix_(tracker_label, measurement_label)) continue;
+
+      const double score = calcScore(
+        measurements.objects.at(measurement_idx), measurement_label, tracked_object,
+        tracker_inverse_covariance, tracker_label);
+      if (0.0 < score) {
+        scores.emplace_back(tracker_idx, measurement_idx, score);
       }
-      score_matrix(tracker_idx, measurement_idx) = score;
     }
   }
 
+  Eigen::SparseMatrix<double> score_matrix(trackers.size(), measurements.objects.size());
+  score_matrix.setFromTriplets(scores.begin(), scores.end());
   return score_matrix;
 }
+
+double DataAssociation::calcScore(
+  const autoware_auto_perception_msgs::msg::DetectedObject & measurement_object,
+  const std::uint8_t measurement_label,
+  const autoware_auto_perception_msgs::msg::TrackedObject & tracked_object,
+  const Eigen::Matrix2d & tracker_inverse_covariance, const std::uint8_t tracker_label) const
+{
+  const double max_dist = max_dist_matrix_(tracker_label, measurement_label);
+  const double dist = tier4_autoware_utils::calcDistance2d(
+    measurement_object.kinematics.pose_with_covariance.pose.position,
+    tracked_object.kinematics.pose_with_covariance.pose.position);
+
+  // dist gate
+  if (max_dist < dist) return 0.0;
+  // area gate
+  {
+    const double max_area = max_area_matrix_(tracker_label, measurement_label);
+    const double min_area = min_area_matrix_(tracker_label, measurement_label);
+    const double area = tier4_autoware_utils::getArea(measurement_object.shape);
+    if (area < min_area || max_area < area) return 0.0;
+  }
+  // angle gate
+  {
+    const double max_rad = max_rad_matrix_(tracker_label, measurement_label);
+    const double angle = getFormedYawAngle(
+      measurement_object.kinematics.pose_with_covariance.pose.orientation,
+      tracked_object.kinematics.pose_with_covariance.pose.orientation, false);
+    if (std::fabs(max_rad) < M_PI && std::fabs(max_rad) < std::fabs(angle)) return 0.0;
+  }
+  // mahalanobis dist gate
+  {
+    const double mahalanobis_dist = getMahalanobisDistance(
+      measurement_object.kinematics.pose_with_covariance.pose.position,
+      tracked_object.kinematics.pose_with_covariance.pose.position, tracker_inverse_covariance);
+    if (3.035 /*99%*/ <= mahalanobis_dist) return 0.0;
+  }
+  // 2d iou gate
+  {
+    const double min_iou = min_iou_matrix_(tracker_label, measurement_label);
+    const double min_union_iou_area = 1e-2;
+    const double iou =
+      object_recognition_utils::get2dIoU(measurement_object, tracked_object, min_union_iou_area);
+    if (iou < min_iou) return 0.0;
+  }
+
+  // all gate is passed
+  const double score = (max_dist - std::min(dist, max_dist)) / max_dist;
+  return score < score_threshold_ ? 0.0 : score;
+}
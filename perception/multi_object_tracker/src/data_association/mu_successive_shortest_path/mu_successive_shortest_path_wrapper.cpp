@@ -20,12 +20,25 @@
 #include <cassert>
 #include <fstream>
 #include <iostream>
+#include <numeric>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
 namespace gnn_solver
 {
+namespace
+{
+int findRoot(std::vector<int> & parents, int node)
+{
+  while (parents.at(node) != node) {
+    parents.at(node) = parents.at(parents.at(node));
+    node = parents.at(node);
+  }
+  return node;
+}
+}  // namespace
+
 void MuSSP::maximizeLinearAssignment(
   const std::vector<std::vector<double>> & cost, std::unordered_map<int, int> * direct_assignment,
   std::unordered_map<int, int> * reverse_assignment)
@@ -38,4 +51,83 @@ void MuSSP::maximizeLinearAssignment(
   // Solve DA by muSSP
   solve_muSSP(cost, direct_assignment, reverse_assignment);
 }
+
+void MuSSP::maximizeSparseLinearAssignment(
+  const int n_agents, const int n_tasks, const std::vector<ScoreEdge> & scores,
+  std::unordered_map<int, int> * direct_assignment,
+  std::unordered_map<int, int> * reverse_assignment)
+{
+  // Terminate if the graph is empty
+  if (n_agents == 0 || n_tasks == 0 || scores.empty()) {
+    return;
+  }
+
+  // Agents and tasks that are not connected by any edge can be assigned independently, so split
+  // the graph into its connected components and solve each of them as a small dense problem.
+  // Nodes: {0, ..., n_agents-1} are agents, {n_agents, ..., n_agents+n_tasks-1} are tasks.
+  std::vector<int> parents(n_agents + n_tasks);
+  std::iota(parents.begin(), parents.end(), 0);
+  for (const auto & edge : scores) {
+    if (edge.score <= 0.0) continue;
+    const int agent_root = findRoot(parents, edge.agent);
+    const int task_root = findRoot(parents, n_agents + edge.task);
+    if (agent_root != task_root) {
+      parents.at(agent_root) = task_root;
+    }
+  }
+
+  // Component of each root node, and local index of each node in its component
+  std::vector<int> components(n_agents + n_tasks, -1);
+  std::vector<int> local_indices(n_agents + n_tasks, -1);
+  std::vector<std::vector<int>> component_agents;
+  std::vector<std::vector<int>> component_tasks;
+  const auto getComponent = [&](const int node) {
+    const int root = findRoot(parents, node);
+    if (components.at(root) < 0) {
+      components.at(root) = component_agents.size();
+      component_agents.emplace_back();
+      component_tasks.emplace_back();
+    }
+    return components.at(root);
+  };
+  for (const auto & edge : scores) {
+    if (edge.score <= 0.0) continue;
+    const int component = getComponent(edge.agent);
+    if (local_indices.at(edge.agent) < 0) {
+      local_indices.at(edge.agent) = component_agents.at(component).size();
+      component_agents.at(component).push_back(edge.agent);
+    }
+    if (local_indices.at(n_agents + edge.task) < 0) {
+      local_indices.at(n_agents + edge.task) = component_tasks.at(component).size();
+      component_tasks.at(component).push_back(edge.task);
+    }
+  }
+
+  std::vector<std::vector<std::vector<double>>> component_costs(component_agents.size());
+  for (size_t component = 0; component < component_agents.size(); ++component) {
+    component_costs.at(component).assign(
+      component_agents.at(component).size(),
+      std::vector<double>(component_tasks.at(component).size(), 0.0));
+  }
+  for (const auto & edge : scores) {
+    if (edge.score <= 0.0) continue;
+    component_costs.at(getComponent(edge.agent))
+      .at(local_indices.at(edge.agent))
+      .at(local_indices.at(n_agents + edge.task)) = edge.score;
+  }
+
+  // Solve DA by muSSP for each component
+  for (size_t component = 0; component < component_costs.size(); ++component) {
+    std::unordered_map<int, int> component_direct_assignment;
+    std::unordered_map<int, int> component_reverse_assignment;
+    solve_muSSP(
+      component_costs.at(component), &component_direct_assignment, &component_reverse_assignment);
+    for (const auto & [local_agent, local_task] : component_direct_assignment) {
+      const int agent = component_agents.at(component).at(local_agent);
+      const int task = component_tasks.at(component).at(local_task);
+      (*direct_assignment)[agent] = task;
+      (*reverse_assignment)[task] = agent;
+    }
+  }
+}
 }  // namespace gnn_solver
@@ -46,6 +46,29 @@ struct ResidualEdge
 void SSP::maximizeLinearAssignment(
   const std::vector<std::vector<double>> & cost, std::unordered_map<int, int> * direct_assignment,
   std::unordered_map<int, int> * reverse_assignment)
+{
+  // When there is no agents or no tasks, terminate
+  if (cost.size() == 0 || cost.at(0).size() == 0) {
+    return;
+  }
+
+  const int n_agents = cost.size();
+  const int n_tasks = cost.at(0).size();
+  std::vector<ScoreEdge> scores;
+  scores.reserve(n_agents * n_tasks);
+  for (int agent = 0; agent < n_agents; ++agent) {
+    for (int task = 0; task < n_tasks; ++task) {
+      scores.push_back({agent, task, cost.at(agent).at(task)});
+    }
+  }
+  maximizeSparseLinearAssignment(
+    n_agents, n_tasks, scores, direct_assignment, reverse_assignment);
+}
+
+void SSP::maximizeSparseLinearAssignment(
+  const int n_agents, const int n_tasks, const std::vector<ScoreEdge> & scores,
+  std::unordered_map<int, int> * direct_assignment,
+  std::unordered_map<int, int> * reverse_assignment)
 {
   // NOTE: Need to set as default arguments
   bool sparse_cost = true;
@@ -58,14 +81,29 @@ void SSP::maximizeLinearAssignment(
   const double EPS = 1e-5;
 
   // When there is no agents or no tasks, terminate
-  if (cost.size() == 0 || cost.at(0).size() == 0) {
+  if (n_agents == 0 || n_tasks == 0) {
     return;
   }
 
-  // Construct a bipartite graph from the cost matrix
-  int n_agents = cost.size();
-  int n_tasks = cost.at(0).size();
+  // Edges of the bipartite graph, in the order of the agents then of the tasks
+  std::vector<ScoreEdge> edges;
+  edges.reserve(scores.size());
+  for (const auto & edge : scores) {
+    if (!sparse_cost || edge.score > EPS) {
+      edges.push_back(edge);
+    }
+  }
+  std::sort(edges.begin(), edges.end(), [](const ScoreEdge & a, const ScoreEdge & b) {
+    return a.agent < b.agent || (a.agent == b.agent && a.task < b.task);
+  });
+  std::vector<int> n_agent_edges(n_agents, 0);
+  std::vector<int> n_task_edges(n_tasks, 0);
+  for (const auto & edge : edges) {
+    ++n_agent_edges.at(edge.agent);
+    ++n_task_edges.at(edge.task);
+  }
 
+  // Construct a bipartite graph from the edges
   int n_dummies;
   if (sparse_cost) {
     n_dummies = n_agents;
@@ -77,17 +115,6 @@ void SSP::maximizeLinearAssignment(
   int sink = n_agents + n_tasks + 1;
   int n_nodes = n_agents + n_tasks + n_dummies + 2;
 
-  // // Print cost matrix
-  // std::cout << std::endl;
-  // for (int agent = 0; agent < n_agents; agent++)
-  // {
-  //   for (int task = 0; task < n_tasks; task++)
-  //   {
-  //     std::cout << cost.at(agent).at(task) << " ";
-  //   }
-  //   std::cout << std::endl;
-  // }
-
   // std::chrono::system_clock::time_point start_time, end_time;
   // start_time = std::chrono::system_clock::now();
 
@@ -107,10 +134,10 @@ void SSP::maximizeLinearAssignment(
       adjacency_list.at(v).reserve(n_agents);
     } else if (v <= n_agents) {
       // Agents
-      adjacency_list.at(v).reserve(n_tasks + 1 + 1);
+      adjacency_list.at(v).reserve(n_agent_edges.at(v - 1) + 1 + 1);
     } else if (v <= n_agents + n_tasks) {
       // Tasks
-      adjacency_list.at(v).reserve(n_agents + 1);
+      adjacency_list.at(v).reserve(n_task_edges.at(v - n_agents - 1) + 1);
     } else if (v == sink) {
       // Sink
       adjacency_list.at(v).reserve(n_tasks + n_dummies);
@@ -130,21 +157,17 @@ void SSP::maximizeLinearAssignment(
   }
 
   // Add edges from agents
-  for (int agent = 0; agent < n_agents; ++agent) {
-    for (int task = 0; task < n_tasks; ++task) {
-      if (!sparse_cost || cost.at(agent).at(task) > EPS) {
-        // From agent to task
-        adjacency_list.at(agent + 1).emplace_back(
-          task + n_agents + 1, 1, MAX_COST - cost.at(agent).at(task), 0,
-          adjacency_list.at(task + n_agents + 1).size());
-
-        // From task to agent
-        adjacency_list.at(task + n_agents + 1)
-          .emplace_back(
-            agent + 1, 0, cost.at(agent).at(task) - MAX_COST, 0,
-            adjacency_list.at(agent + 1).size() - 1);
-      }
-    }
+  for (const auto & edge : edges) {
+    // From agent to task
+    adjacency_list.at(edge.agent + 1)
+      .emplace_back(
+        edge.task + n_agents + 1, 1, MAX_COST - edge.score, 0,
+        adjacency_list.at(edge.task + n_agents + 1).size());
+
+    // From task to agent
+    adjacency_list.at(edge.task + n_agents + 1)
+      .emplace_back(
+        edge.agent + 1, 0, edge.score - MAX_COST, 0, adjacency_list.at(edge.agent + 1).size() - 1);
   }
 
   // Add edges form tasks
@@ -17,6 +17,7 @@
 #include "multi_object_tracker/debugger.hpp"
 
 #include <memory>
+#include <string>
 
 TrackerDebugger::TrackerDebugger(rclcpp::Node & node) : diagnostic_updater_(&node), node_(node)
 {
@@ -167,3 +168,12 @@ void TrackerDebugger::endPublishTime(const rclcpp::Time & now, const rclcpp::Tim
   }
   stamp_publish_output_ = now;
 }
+
+void TrackerDebugger::publishStageTime(const std::string & stage, const double time_ms) const
+{
+  // processing time of each stage of the measurement processing, e.g. "debug/predict_time_ms"
+  if (debug_settings_.publish_processing_time) {
+    processing_time_publisher_->publish<tier4_debug_msgs::msg::Float64Stamped>(
+      "debug/" + stage + "_time_ms", time_ms);
+  }
+}
@@ -119,7 +119,8 @@ MultiObjectTracker::MultiObjectTracker(const rclcpp::NodeOptions & node_options)
     tracker_map.insert(std::make_pair(
       Label::MOTORCYCLE, this->declare_parameter<std::string>("motorcycle_tracker")));
 
-    processor_ = std::make_unique<TrackerProcessor>(tracker_map);
+    const int num_threads = this->declare_parameter<int>("num_threads");
+    processor_ = std::make_unique<TrackerProcessor>(tracker_map, num_threads);
   }
 
   // Data association initialization
@@ -139,6 +140,8 @@ MultiObjectTracker::MultiObjectTracker(const rclcpp::NodeOptions & node_options)
 
   // Debugger
   debugger_ = std::make_unique<TrackerDebugger>(*this);
+  stop_watch_ptr_ =
+    std::make_unique<tier4_autoware_utils::StopWatch<std::chrono::milliseconds>>();
   published_time_publisher_ = std::make_unique<tier4_autoware_utils::PublishedTimePublisher>(this);
 }
 
@@ -166,23 +169,33 @@ void MultiObjectTracker::onMeasurement(
   ////// Tracker Process
   //// Associate and update
   /* prediction */
+  stop_watch_ptr_->tic("predict");
   processor_->predict(measurement_time);
+  debugger_->publishStageTime("predict", stop_watch_ptr_->toc("predict"));
   /* object association */
+  stop_watch_ptr_->tic("associate");
   std::unordered_map<int, int> direct_assignment, reverse_assignment;
   {
     const auto & list_tracker = processor_->getListTracker();
     const auto & detected_objects = transformed_objects;
     // global nearest neighbor
-    Eigen::MatrixXd score_matrix = data_association_->calcScoreMatrix(
+    Eigen::SparseMatrix<double> score_matrix = data_association_->calcScoreMatrix(
       detected_objects, list_tracker);  // row : tracker, col : measurement
     data_association_->assign(score_matrix, direct_assignment, reverse_assignment);
   }
+  debugger_->publishStageTime("associate", stop_watch_ptr_->toc("associate"));
   /* tracker update */
+  stop_watch_ptr_->tic("update");
   processor_->update(transformed_objects, *self_transform, direct_assignment);
+  debugger_->publishStageTime("update", stop_watch_ptr_->toc("update"));
   /* tracker pruning */
+  stop_watch_ptr_->tic("prune");
   processor_->prune(measurement_time);
+  debugger_->publishStageTime("prune", stop_watch_ptr_->toc("prune"));
   /* spawn new tracker */
+  stop_watch_ptr_->tic("spawn");
   processor_->spawn(transformed_objects, *self_transform, reverse_assignment);
+  debugger_->publishStageTime("spawn", stop_watch_ptr_->toc("spawn"));
 
   // debugger time
   debugger_->endMeasurementTime(this->now());
@@ -17,16 +17,20 @@
 #include "multi_object_tracker/processor/processor.hpp"
 
 #include "multi_object_tracker/tracker/tracker.hpp"
+#include "multi_object_tracker/utils/utils.hpp"
 #include "object_recognition_utils/object_recognition_utils.hpp"
 
 #include <autoware_auto_perception_msgs/msg/tracked_objects.hpp>
 
-#include <iterator>
+#include <algorithm>
+#include <utility>
+#include <vector>
 
 using Label = autoware_auto_perception_msgs::msg::ObjectClassification;
 
-TrackerProcessor::TrackerProcessor(const std::map<std::uint8_t, std::string> & tracker_map)
-: tracker_map_(tracker_map)
+TrackerProcessor::TrackerProcessor(
+  const std::map<std::uint8_t, std::string> & tracker_map, const int num_threads)
+: tracker_map_(tracker_map), num_threads_(std::max(num_threads, 1))
 {
   // Set tracker lifetime parameters
   max_elapsed_time_ = 1.0;  // [s]
@@ -42,8 +46,10 @@ TrackerProcessor::TrackerProcessor(const std::map<std::uint8_t, std::string> & t
 
 void TrackerProcessor::predict(const rclcpp::Time & time)
 {
-  for (auto itr = list_tracker_.begin(); itr != list_tracker_.end(); ++itr) {
-    (*itr)->predict(time);
+  // The trackers are independent of each other, so they are processed in parallel
+#pragma omp parallel for num_threads(num_threads_) schedule(dynamic)
+  for (size_t tracker_idx = 0; tracker_idx < list_tracker_.size(); ++tracker_idx) {
+    list_tracker_.at(tracker_idx)->predict(time);
   }
 }
 
@@ -52,16 +58,16 @@ void TrackerProcessor::update(
   const geometry_msgs::msg::Transform & self_transform,
   const std::unordered_map<int, int> & direct_assignment)
 {
-  int tracker_idx = 0;
   const auto & time = detected_objects.header.stamp;
-  for (auto tracker_itr = list_tracker_.begin(); tracker_itr != list_tracker_.end();
-       ++tracker_itr, ++tracker_idx) {
-    if (direct_assignment.find(tracker_idx) != direct_assignment.end()) {  // found
-      const auto & associated_object =
-        detected_objects.objects.at(direct_assignment.find(tracker_idx)->second);
-      (*(tracker_itr))->updateWithMeasurement(associated_object, time, self_transform);
+#pragma omp parallel for num_threads(num_threads_) schedule(dynamic)
+  for (size_t tracker_idx = 0; tracker_idx < list_tracker_.size(); ++tracker_idx) {
+    const auto & tracker = list_tracker_.at(tracker_idx);
+    const auto assignment_itr = direct_assignment.find(tracker_idx);
+    if (assignment_itr != direct_assignment.end()) {  // found
+      const auto & associated_object = detected_objects.objects.at(assignment_itr->second);
+      tracker->updateWithMeasurement(associated_object, time, self_transform);
     } else {  // not found
-      (*(tracker_itr))->updateWithoutMeasurement();
+      tracker->updateWithoutMeasurement();
     }
   }
 }
@@ -118,29 +124,43 @@ void TrackerProcessor::prune(const rclcpp::Time & time)
 void TrackerProcessor::removeOldTracker(const rclcpp::Time & time)
 {
   // Check elapsed time from last update
-  for (auto itr = list_tracker_.begin(); itr != list_tracker_.end(); ++itr) {
-    const bool is_old = max_elapsed_time_ < (*itr)->getElapsedTimeFromLastUpdate(time);
-    // If the tracker is old, delete it
-    if (is_old) {
-      auto erase_itr = itr;
-      --itr;
-      list_tracker_.erase(erase_itr);
-    }
-  }
+  const auto is_old = [&](const std::shared_ptr<Tracker> & tracker) {
+    return max_elapsed_time_ < tracker->getElapsedTimeFromLastUpdate(time);
+  };
+  // If the tracker is old, delete it
+  list_tracker_.erase(
+    std::remove_if(list_tracker_.begin(), list_tracker_.end(), is_old), list_tracker_.end());
 }
 
 // This function removes overlapped trackers based on distance and IoU criteria
 void TrackerProcessor::removeOverlappedTracker(const rclcpp::Time & time)
 {
+  // Get the tracked objects once, and bucket them into a grid of the distance threshold, so that
+  // a tracker is only compared with the trackers in the 3x3 cells around it
+  std::vector<autoware_auto_perception_msgs::msg::TrackedObject> objects(list_tracker_.size());
+  std::vector<bool> is_valid(list_tracker_.size(), false);
+  utils::PositionGrid grid(distance_threshold_);
+  for (size_t i = 0; i < list_tracker_.size(); ++i) {
+    is_valid.at(i) = list_tracker_.at(i)->getTrackedObject(time, objects.at(i));
+    if (is_valid.at(i)) {
+      grid.insert(i, objects.at(i).kinematics.pose_with_covariance.pose.position);
+    }
+  }
+
   // Iterate through the list of trackers
-  for (auto itr1 = list_tracker_.begin(); itr1 != list_tracker_.end(); ++itr1) {
-    autoware_auto_perception_msgs::msg::TrackedObject object1;
-    if (!(*itr1)->getTrackedObject(time, object1)) continue;
+  std::vector<bool> is_deleted(list_tracker_.size(), false);
+  std::vector<size_t> neighbor_indices;
+  for (size_t i1 = 0; i1 < list_tracker_.size(); ++i1) {
+    if (!is_valid.at(i1) || is_deleted.at(i1)) continue;
+    const auto & tracker1 = list_tracker_.at(i1);
+    const auto & object1 = objects.at(i1);
 
     // Compare the current tracker with the remaining trackers
-    for (auto itr2 = std::next(itr1); itr2 != list_tracker_.end(); ++itr2) {
-      autoware_auto_perception_msgs::msg::TrackedObject object2;
-      if (!(*itr2)->getTrackedObject(time, object2)) continue;
+    grid.findNeighbors(object1.kinematics.pose_with_covariance.pose.position, neighbor_indices);
+    for (const size_t i2 : neighbor_indices) {
+      if (i2 <= i1 || is_deleted.at(i2)) continue;
+      const auto & tracker2 = list_tracker_.at(i2);
+      const auto & object2 = objects.at(i2);
 
       // Calculate the distance between the two objects
       const double distance = std::hypot(
@@ -157,8 +177,8 @@ void TrackerProcessor::removeOverlappedTracker(const rclcpp::Time & time)
       // Check the Intersection over Union (IoU) between the two objects
       const double min_union_iou_area = 1e-2;
       const auto iou = object_recognition_utils::get2dIoU(object1, object2, min_union_iou_area);
-      const auto & label1 = (*itr1)->getHighestProbLabel();
-      const auto & label2 = (*itr2)->getHighestProbLabel();
+      const auto & label1 = tracker1->getHighestProbLabel();
+      const auto & label2 = tracker2->getHighestProbLabel();
       bool should_delete_tracker1 = false;
       bool should_delete_tracker2 = false;
 
@@ -167,7 +187,7 @@ void TrackerProcessor::removeOverlappedTracker(const rclcpp::Time & time)
       if (label1 == Label::UNKNOWN || label2 == Label::UNKNOWN) {
         if (iou > min_iou_for_unknown_object_) {
           if (label1 == Label::UNKNOWN && label2 == Label::UNKNOWN) {
-            if ((*itr1)->getTotalMeasurementCount() < (*itr2)->getTotalMeasurementCount()) {
+            if (tracker1->getTotalMeasurementCount() < tracker2->getTotalMeasurementCount()) {
               should_delete_tracker1 = true;
             } else {
               should_delete_tracker2 = true;
@@ -180,7 +200,7 @@ void TrackerProcessor::removeOverlappedTracker(const rclcpp::Time & time)
         }
       } else {  // If neither object is UNKNOWN, delete the younger tracker
         if (iou > min_iou_) {
-          if ((*itr1)->getTotalMeasurementCount() < (*itr2)->getTotalMeasurementCount()) {
+          if (tracker1->getTotalMeasurementCount() < tracker2->getTotalMeasurementCount()) {
             should_delete_tracker1 = true;
           } else {
             should_delete_tracker2 = true;
@@ -190,16 +210,22 @@ void TrackerProcessor::removeOverlappedTracker(const rclcpp::Time & time)
 
       // Delete the tracker
       if (should_delete_tracker1) {
-        itr1 = list_tracker_.erase(itr1);
-        --itr1;
+        is_deleted.at(i1) = true;
         break;
       }
       if (should_delete_tracker2) {
-        itr2 = list_tracker_.erase(itr2);
-        --itr2;
+        is_deleted.at(i2) = true;
       }
     }
   }
+
+  size_t num_kept = 0;
+  for (size_t i = 0; i < list_tracker_.size(); ++i) {
+    if (!is_deleted.at(i)) {
+      list_tracker_.at(num_kept++) = std::move(list_tracker_.at(i));
+    }
+  }
+  list_tracker_.resize(num_kept);
 }
 
 bool TrackerProcessor::isConfidentTracker(const std::shared_ptr<Tracker> & tracker) const
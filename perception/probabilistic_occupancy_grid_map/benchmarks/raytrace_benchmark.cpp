@@ -0,0 +1,209 @@
+// Copyright 2024 TIER IV, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Compares the serial and the parallel raytracing of the pointcloud based occupancy grid maps.
+//
+// usage: raytrace_benchmark [-t <threads>] [<raw_pointcloud.pcd> ...]
+//
+// The PCD files are raw pointclouds in the base_link frame; the obstacle pointcloud is made of
+// their points higher than 0.3 [m]. Random scans are used when no file is given.
+
+#include "probabilistic_occupancy_grid_map/pointcloud_based_occupancy_grid_map/occupancy_grid_map_fixed.hpp"
+#include "probabilistic_occupancy_grid_map/pointcloud_based_occupancy_grid_map/occupancy_grid_map_projective.hpp"
+
+#include <pcl/io/pcd_io.h>
+#include <sensor_msgs/point_cloud2_iterator.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using costmap_2d::OccupancyGridMapFixedBlindSpot;
+using costmap_2d::OccupancyGridMapInterface;
+using costmap_2d::OccupancyGridMapProjectiveBlindSpot;
+using geometry_msgs::msg::Pose;
+using sensor_msgs::msg::PointCloud2;
+
+constexpr double map_length = 150.0;         // [m]
+constexpr double map_resolution = 0.5;       // [m]
+constexpr double sensor_height = 1.8;        // [m]
+constexpr float obstacle_min_height = 0.3f;  // [m]
+
+PointCloud2 make_cloud(const std::vector<std::array<float, 3>> & points)
+{
+  PointCloud2 cloud;
+  sensor_msgs::PointCloud2Modifier modifier(cloud);
+  modifier.setPointCloud2FieldsByString(1, "xyz");
+  modifier.resize(points.size());
+  sensor_msgs::PointCloud2Iterator<float> it(cloud, "x");
+  for (const auto & point : points) {
+    it[0] = point[0];
+    it[1] = point[1];
+    it[2] = point[2];
+    ++it;
+  }
+  return cloud;
+}
+
+// Ground rings and a random set of vertical obstacles around the sensor
+std::vector<std::array<float, 3>> random_scan(const size_t num_points)
+{
+  std::default_random_engine engine(0);
+  std::uniform_real_distribution<float> angle_dist(-M_PI, M_PI);
+  std::exponential_distribution<float> range_dist(0.04f);
+  std::uniform_real_distribution<float> height_dist(0.0f, 2.5f);
+  std::bernoulli_distribution is_obstacle_dist(0.3);
+
+  std::vector<std::array<float, 3>> points;
+  points.reserve(num_points);
+  for (size_t i = 0; i < num_points; ++i) {
+    const float angle = angle_dist(engine);
+    const float range = std::min(range_dist(engine), 120.0f) + 2.0f;
+    const float z = is_obstacle_dist(engine) ? height_dist(engine) : 0.0f;
+    points.push_back({range * std::cos(angle), range * std::sin(angle), z});
+  }
+  return points;
+}
+
+std::vector<std::array<float, 3>> load_scan(const std::string & file)
+{
+  pcl::PointCloud<pcl::PointXYZ> pcl_cloud;
+  if (pcl::io::loadPCDFile(file, pcl_cloud) != 0) {
+    return {};
+  }
+  std::vector<std::array<float, 3>> points;
+  for (const auto & point : pcl_cloud) {
+    if (std::isfinite(point.x) && std::isfinite(point.y) && std::isfinite(point.z)) {
+      points.push_back({point.x, point.y, point.z});
+    }
+  }
+  return points;
+}
+
+std::unique_ptr<OccupancyGridMapInterface> make_map(
+  const std::string & type, rclcpp::Node & node, const int num_threads)
+{
+  const auto cells_size = static_cast<unsigned int>(map_length / map_resolution);
+  std::unique_ptr<OccupancyGridMapInterface> map;
+  if (type == "OccupancyGridMapProjectiveBlindSpot") {
+    map = std::make_unique<OccupancyGridMapProjectiveBlindSpot>(
+      cells_size, cells_size, map_resolution);
+  } else {
+    map =
+      std::make_unique<OccupancyGridMapFixedBlindSpot>(cells_size, cells_size, map_resolution);
+  }
+  map->initRosParam(node);
+  map->setNumThreads(num_threads);
+  map->updateOrigin(-map_length / 2.0, -map_length / 2.0);
+  return map;
+}
+
+double run(
+  OccupancyGridMapInterface & map, const PointCloud2 & raw_pointcloud,
+  const PointCloud2 & obstacle_pointcloud, const int iterations)
+{
+  Pose robot_pose;
+  robot_pose.orientation.w = 1.0;
+  Pose scan_origin = robot_pose;
+  scan_origin.position.z = sensor_height;
+
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; ++i) {
+    map.resetMaps();
+    map.updateWithPointCloud(raw_pointcloud, obstacle_pointcloud, robot_pose, scan_origin);
+  }
+  const auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count() / iterations;
+}
+
+int main(int argc, char * argv[])
+{
+  rclcpp::init(argc, argv);
+
+  int num_threads = static_cast<int>(std::max(std::thread::hardware_concurrency(), 2u));
+  std::vector<std::string> pcd_files;
+  for (int i = 1; i < argc; ++i) {
+    const auto arg = std::string(argv[i]);
+    if ((arg == "-t" || arg == "--threads") && i + 1 < argc) {
+      num_threads = std::stoi(argv[++i]);
+    } else if (arg.rfind("--", 0) != 0) {
+      pcd_files.push_back(arg);
+    }
+  }
+
+  std::vector<std::pair<std::string, std::vector<std::array<float, 3>>>> scans;
+  for (const auto & file : pcd_files) {
+    auto points = load_scan(file);
+    if (points.empty()) {
+      std::fprintf(stderr, "failed to load %s\n", file.c_str());
+      return 1;
+    }
+    scans.emplace_back(file, std::move(points));
+  }
+  if (scans.empty()) {
+    for (const size_t num_points : {50000lu, 150000lu, 300000lu}) {
+      scans.emplace_back("random_" + std::to_string(num_points), random_scan(num_points));
+    }
+  }
+
+  rclcpp::NodeOptions node_options;
+  node_options.parameter_overrides({
+    {"OccupancyGridMapFixedBlindSpot.distance_margin", 1.0},
+    {"OccupancyGridMapProjectiveBlindSpot.projection_dz_threshold", 0.01},
+    {"OccupancyGridMapProjectiveBlindSpot.obstacle_separation_threshold", 1.0},
+    {"OccupancyGridMapProjectiveBlindSpot.pub_debug_grid", false},
+  });
+
+  constexpr auto iterations = 20;
+  std::printf("#Cloud Points GridMapType Threads SerialMs ParallelMs Identical\n");
+  for (const auto & [name, points] : scans) {
+    std::vector<std::array<float, 3>> obstacle_points;
+    std::copy_if(
+      points.begin(), points.end(), std::back_inserter(obstacle_points),
+      [](const auto & point) { return point[2] > obstacle_min_height; });
+    const PointCloud2 raw_pointcloud = make_cloud(points);
+    const PointCloud2 obstacle_pointcloud = make_cloud(obstacle_points);
+
+    for (const std::string type :
+         {"OccupancyGridMapFixedBlindSpot", "OccupancyGridMapProjectiveBlindSpot"}) {
+      // The maps declare their parameters, so each pair of maps gets its own node
+      auto serial_node = std::make_shared<rclcpp::Node>("serial_raytrace", node_options);
+      auto parallel_node = std::make_shared<rclcpp::Node>("parallel_raytrace", node_options);
+      auto serial_map = make_map(type, *serial_node, 1);
+      auto parallel_map = make_map(type, *parallel_node, num_threads);
+
+      const double serial_ms = run(*serial_map, raw_pointcloud, obstacle_pointcloud, iterations);
+      const double parallel_ms =
+        run(*parallel_map, raw_pointcloud, obstacle_pointcloud, iterations);
+      const size_t cell_num = serial_map->getSizeInCellsX() * serial_map->getSizeInCellsY();
+      const bool identical =
+        std::memcmp(serial_map->getCharMap(), parallel_map->getCharMap(), cell_num) == 0;
+      std::printf(
+        "%s %zu %s %d %.3f %.3f %s\n", name.c_str(), points.size(), type.c_str(), num_threads,
+        serial_ms, parallel_ms, identical ? "yes" : "no");
+    }
+  }
+
+  rclcpp::shutdown();
+  return 0;
+}
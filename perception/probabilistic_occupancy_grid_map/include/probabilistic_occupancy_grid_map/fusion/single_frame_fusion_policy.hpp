@@ -61,6 +61,13 @@ unsigned char singleFrameOccupancyFusion(
 unsigned char singleFrameOccupancyFusion(
   const std::vector<unsigned char> & occupancy, FusionMethod method,
   const std::vector<double> & reliability);
+
+// Fuse whole grids of `cell_num` cells into `fused_grid`, with the same result as
+// singleFrameOccupancyFusion() for every cell. The log-odds and the Dempster-Shafer masses of each
+// grid are precomputed for the 256 cost values, and the cells are fused block by block.
+void singleFrameOccupancyFusion(
+  const std::vector<const unsigned char *> & grids, const size_t cell_num, FusionMethod method,
+  const std::vector<double> & reliability, unsigned char * fused_grid);
 }  // namespace fusion_policy
 
 #endif  // PROBABILISTIC_OCCUPANCY_GRID_MAP__FUSION__SINGLE_FRAME_FUSION_POLICY_HPP_
@@ -59,6 +59,10 @@
 #include <sensor_msgs/msg/laser_scan.hpp>
 #include <sensor_msgs/msg/point_cloud2.hpp>
 
+#include <atomic>
+#include <cstdint>
+#include <functional>
+
 namespace costmap_2d
 {
 using geometry_msgs::msg::Pose;
@@ -83,11 +87,62 @@ public:
 
   virtual void initRosParam(rclcpp::Node & node) = 0;
 
+  // Number of threads raytracing the angle bins, 1 for serial raytracing
+  void setNumThreads(const int num_threads) { num_threads_ = num_threads; }
+  int getNumThreads() const { return num_threads_; }
+
+protected:
+  // Writes the costs of the cells of a raytracing step, either directly to the costmap, or, while
+  // the angle bins are processed in parallel, to a costmap stamped with the rank of the chunk of
+  // bins the cost comes from. A cell keeps the cost of the highest rank, which is the one that
+  // the serial processing of the bins would have written last.
+  class CellWriter
+  {
+  public:
+    explicit CellWriter(unsigned char * costmap) : costmap_(costmap) {}
+    CellWriter(std::atomic<uint16_t> * stamped_costmap, const uint16_t rank)
+    : stamped_costmap_(stamped_costmap), rank_(rank)
+    {
+    }
+
+    void operator()(const unsigned int index, const unsigned char cost) const
+    {
+      if (stamped_costmap_ == nullptr) {
+        costmap_[index] = cost;
+        return;
+      }
+      const uint16_t stamped_cost = static_cast<uint16_t>(rank_ << 8) | cost;
+      auto & cell = stamped_costmap_[index];
+      uint16_t current = cell.load(std::memory_order_relaxed);
+      while ((current >> 8) <= rank_ &&
+             !cell.compare_exchange_weak(current, stamped_cost, std::memory_order_relaxed)) {
+      }
+    }
+
+  private:
+    unsigned char * costmap_{nullptr};
+    std::atomic<uint16_t> * stamped_costmap_{nullptr};
+    uint16_t rank_{0};
+  };
+
+  void raytrace(
+    const double source_x, const double source_y, const double target_x, const double target_y,
+    const unsigned char cost, const CellWriter & writer);
+  void setCellValue(
+    const double wx, const double wy, const unsigned char cost, const CellWriter & writer);
+
+  // Call func(bin_index, writer) for every angle bin and write the cells to the costmap. The bins
+  // are processed on num_threads_ threads in chunks of consecutive bins; the costmap ends up the
+  // same as when the bins are processed one after the other.
+  void forEachAngleBin(
+    const size_t angle_bin_size, const std::function<void(size_t, const CellWriter &)> & func);
+
 private:
   bool worldToMap(double wx, double wy, unsigned int & mx, unsigned int & my) const;
 
   rclcpp::Logger logger_{rclcpp::get_logger("pointcloud_based_occupancy_grid_map")};
   rclcpp::Clock clock_{RCL_ROS_TIME};
+  int num_threads_{1};
 };
 
 }  // namespace costmap_2d
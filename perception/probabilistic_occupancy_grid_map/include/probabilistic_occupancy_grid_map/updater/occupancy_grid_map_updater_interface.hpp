@@ -22,6 +22,11 @@
 
 namespace costmap_2d
 {
+// The cells of the updater are stored in costmap_ as a ring buffer (toroidal grid): the cell
+// (mx, my) is at getRingIndex(mx, my), not at getIndex(mx, my). Moving the origin shifts the start
+// of the ring and only resets the cells that scrolled into the map, so the map is neither copied
+// nor reallocated. Read the cells with getCost(), getRingIndex() or forEachCellRun(). The accessors
+// of Costmap2D which take an index of getCharMap() in the row-major order are hidden.
 class OccupancyGridMapUpdaterInterface : public nav2_costmap_2d::Costmap2D
 {
 public:
@@ -34,6 +39,65 @@ public:
   virtual ~OccupancyGridMapUpdaterInterface() = default;
   virtual bool update(const Costmap2D & single_frame_occupancy_grid_map) = 0;
   virtual void initRosParam(rclcpp::Node & node) = 0;
+
+  void updateOrigin(double new_origin_x, double new_origin_y) override;
+
+  // Index in getCharMap() of the cell (mx, my)
+  unsigned int getRingIndex(const unsigned int mx, const unsigned int my) const
+  {
+    const unsigned int rx = mx + ring_x_ < size_x_ ? mx + ring_x_ : mx + ring_x_ - size_x_;
+    return getRingRowIndex(my) + rx;
+  }
+
+  unsigned char getCost(const unsigned int mx, const unsigned int my) const
+  {
+    return costmap_[getRingIndex(mx, my)];
+  }
+
+  void setCost(const unsigned int mx, const unsigned int my, const unsigned char cost)
+  {
+    costmap_[getRingIndex(mx, my)] = cost;
+  }
+
+  // The cell (mx, my) of the map, which is not moved by the ring, to pass to getCost() or
+  // getRingIndex()
+  bool worldToMap(double wx, double wy, unsigned int & mx, unsigned int & my) const
+  {
+    return Costmap2D::worldToMap(wx, wy, mx, my);
+  }
+
+  // The row-major index does not point to the cell in getCharMap()
+  unsigned int getIndex(unsigned int mx, unsigned int my) const = delete;
+  void indexToCells(unsigned int index, unsigned int & mx, unsigned int & my) const = delete;
+  unsigned char getCost(unsigned int index) const = delete;
+
+  // Call func(cells, length) for the runs of consecutive cells of getCharMap(), in the row-major
+  // order of the map from the cell (0, 0), like the cells of a Costmap2D
+  template <typename Func>
+  void forEachCellRun(Func && func) const
+  {
+    for (unsigned int my = 0; my < size_y_; ++my) {
+      const unsigned char * row = costmap_ + getRingRowIndex(my);
+      func(row + ring_x_, size_x_ - ring_x_);
+      if (ring_x_ > 0) {
+        func(row, ring_x_);
+      }
+    }
+  }
+
+private:
+  // Index in getCharMap() of the first cell of the row my, the rows being contiguous
+  unsigned int getRingRowIndex(const unsigned int my) const
+  {
+    return (my + ring_y_ < size_y_ ? my + ring_y_ : my + ring_y_ - size_y_) * size_x_;
+  }
+
+  void resetColumns(const unsigned int mx_begin, const unsigned int mx_end);
+  void resetRows(const unsigned int my_begin, const unsigned int my_end);
+
+  // Position in getCharMap() of the cell (0, 0)
+  unsigned int ring_x_{0};
+  unsigned int ring_y_{0};
 };
 
 }  // namespace costmap_2d
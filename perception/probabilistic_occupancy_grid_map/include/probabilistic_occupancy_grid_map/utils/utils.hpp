@@ -16,6 +16,7 @@
 #define PROBABILISTIC_OCCUPANCY_GRID_MAP__UTILS__UTILS_HPP_
 
 #include "probabilistic_occupancy_grid_map/cost_value.hpp"
+#include "probabilistic_occupancy_grid_map/updater/occupancy_grid_map_updater_interface.hpp"
 
 #include <builtin_interfaces/msg/time.hpp>
 #include <pcl_ros/transforms.hpp>
@@ -43,6 +44,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <string>
 #include <vector>
 
 namespace utils
@@ -117,6 +119,12 @@ bool extractCommonPointCloud(
   sensor_msgs::msg::PointCloud2 & output_obstacle_pc);
 
 unsigned char getApproximateOccupancyState(const unsigned char & value);
+
+// convert the occupancy grid map of an updater, whose cells are stored in a ring buffer
+nav_msgs::msg::OccupancyGrid::UniquePtr occupancyGridMapUpdaterToMsgPtr(
+  const std::string & frame_id, const builtin_interfaces::msg::Time & stamp,
+  const float & robot_pose_z,
+  const costmap_2d::OccupancyGridMapUpdaterInterface & occupancy_grid_map);
 }  // namespace utils
 
 #endif  // PROBABILISTIC_OCCUPANCY_GRID_MAP__UTILS__UTILS_HPP_
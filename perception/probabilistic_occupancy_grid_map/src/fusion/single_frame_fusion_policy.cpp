@@ -14,6 +14,9 @@
 
 #include "probabilistic_occupancy_grid_map/fusion/single_frame_fusion_policy.hpp"
 
+#include <algorithm>
+#include <array>
+
 namespace fusion_policy
 {
 
@@ -319,4 +322,85 @@ unsigned char singleFrameOccupancyFusion(
   }
 }
 
+void singleFrameOccupancyFusion(
+  const std::vector<const unsigned char *> & grids, const size_t cell_num, FusionMethod method,
+  const std::vector<double> & reliability, unsigned char * fused_grid)
+{
+  // the reliability is ignored if it does not match the grids, as in the cell-wise fusion
+  const bool use_reliability = reliability.size() == grids.size();
+  if (!use_reliability && method != FusionMethod::OVERWRITE) {
+    std::cout << "The size of probabilities and reliability are not the same. Fuse without "
+                 "reliability."
+              << std::endl;
+  }
+  constexpr size_t block_size = 256;
+
+  if (method == FusionMethod::OVERWRITE) {
+    std::vector<unsigned char> occupancies(grids.size());
+    for (size_t cell = 0; cell < cell_num; ++cell) {
+      for (size_t i = 0; i < grids.size(); ++i) {
+        occupancies[i] = grids[i][cell];
+      }
+      fused_grid[cell] = overwrite_fusion::overwriteFusion(occupancies);
+    }
+  } else if (method == FusionMethod::LOG_ODDS) {
+    // weighted log-odds of each cost value, for each grid
+    std::vector<std::array<double, 256>> log_odds_tables(grids.size());
+    for (size_t i = 0; i < grids.size(); ++i) {
+      for (int cost = 0; cost < 256; ++cost) {
+        const double probability = convertCharToProbability(static_cast<unsigned char>(cost));
+        const double p = std::max(EPSILON_PROB, std::min(1.0 - EPSILON_PROB, probability));
+        const double log_odds = std::log(p / (1.0 - p));
+        log_odds_tables[i][cost] = use_reliability ? reliability[i] * log_odds : log_odds;
+      }
+    }
+    std::array<double, block_size> log_odds;
+    for (size_t block_begin = 0; block_begin < cell_num; block_begin += block_size) {
+      const size_t block_cell_num = std::min(block_size, cell_num - block_begin);
+      std::fill(log_odds.begin(), log_odds.end(), 0.0);
+      for (size_t i = 0; i < grids.size(); ++i) {
+        const auto & table = log_odds_tables[i];
+        const unsigned char * cells = grids[i] + block_begin;
+        for (size_t j = 0; j < block_cell_num; ++j) {
+          log_odds[j] += table[cells[j]];
+        }
+      }
+      for (size_t j = 0; j < block_cell_num; ++j) {
+        fused_grid[block_begin + j] =
+          convertProbabilityToChar(1.0 / (1.0 + std::exp(-log_odds[j])));
+      }
+    }
+  } else if (method == FusionMethod::DEMPSTER_SHAFER) {
+    using dempster_shafer_fusion::dempsterShaferOccupancy;
+    // mass of each cost value, for each grid
+    std::vector<std::array<dempsterShaferOccupancy, 256>> mass_tables(grids.size());
+    for (size_t i = 0; i < grids.size(); ++i) {
+      for (int cost = 0; cost < 256; ++cost) {
+        const double probability = convertCharToProbability(static_cast<unsigned char>(cost));
+        mass_tables[i][cost] = use_reliability
+                                 ? dempsterShaferOccupancy(probability, reliability[i])
+                                 : dempsterShaferOccupancy(probability);
+      }
+    }
+    std::array<dempsterShaferOccupancy, block_size> masses;
+    for (size_t block_begin = 0; block_begin < cell_num; block_begin += block_size) {
+      const size_t block_cell_num = std::min(block_size, cell_num - block_begin);
+      std::fill(masses.begin(), masses.end(), dempsterShaferOccupancy());  // init with unknown
+      for (size_t i = 0; i < grids.size(); ++i) {
+        const auto & table = mass_tables[i];
+        const unsigned char * cells = grids[i] + block_begin;
+        for (size_t j = 0; j < block_cell_num; ++j) {
+          masses[j] = masses[j] + table[cells[j]];
+        }
+      }
+      for (size_t j = 0; j < block_cell_num; ++j) {
+        fused_grid[block_begin + j] = convertProbabilityToChar(masses[j].getPignisticProbability());
+      }
+    }
+  } else {
+    std::cout << "Unknown fusion method: " << std::endl;
+    std::fill(fused_grid, fused_grid + cell_num, 128);
+  }
+}
+
 }  // namespace fusion_policy
@@ -297,8 +297,8 @@ void GridMapFusionNode::publish()
   occupancy_grid_map_updater_ptr_->update(fused_map);
 
   // publish
-  fused_map_pub_->publish(
-    OccupancyGridMapToMsgPtr(map_frame_, latest_stamp, height, *occupancy_grid_map_updater_ptr_));
+  fused_map_pub_->publish(utils::occupancyGridMapUpdaterToMsgPtr(
+    map_frame_, latest_stamp, height, *occupancy_grid_map_updater_ptr_));
   single_frame_pub_->publish(OccupancyGridMapToMsgPtr(map_frame_, latest_stamp, height, fused_map));
 
   // copy 2nd temp to temp buffer
@@ -356,21 +356,13 @@ OccupancyGridMapFixedBlindSpot GridMapFusionNode::SingleFrameOccupancyFusion(
   }
 
   // assume map is same size and resolutions
-  for (unsigned int x = 0; x < fused_map.getSizeInCellsX(); x++) {
-    for (unsigned int y = 0; y < fused_map.getSizeInCellsY(); y++) {
-      // get cost of each map
-      std::vector<unsigned char> costs;
-      for (auto & map : occupancy_grid_maps) {
-        costs.push_back(map.getCost(x, y));
-      }
-
-      // set fusion policy
-      auto fused_cost = fusion_policy::singleFrameOccupancyFusion(costs, fusion_method_, weights);
-
-      // set max cost to fused map
-      fused_map.setCost(x, y, fused_cost);
-    }
+  std::vector<const unsigned char *> grids;
+  for (const auto & map : occupancy_grid_maps) {
+    grids.push_back(map.getCharMap());
   }
+  fusion_policy::singleFrameOccupancyFusion(
+    grids, fused_map.getSizeInCellsX() * fused_map.getSizeInCellsY(), fusion_method_, weights,
+    fused_map.getCharMap());
 
   return fused_map;
 }
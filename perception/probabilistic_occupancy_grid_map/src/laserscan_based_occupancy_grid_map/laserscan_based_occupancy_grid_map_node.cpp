@@ -32,6 +32,7 @@
 #include <tf2_sensor_msgs/tf2_sensor_msgs.hpp>
 #endif
 
+#include <algorithm>
 #include <memory>
 #include <string>
 
@@ -198,7 +199,7 @@ void LaserscanBasedOccupancyGridMapNode::onLaserscanPointCloud2WithObstacleAndRa
     occupancy_grid_map_updater_ptr_->update(single_frame_occupancy_grid_map);
 
     // publish
-    occupancy_grid_map_pub_->publish(OccupancyGridMapToMsgPtr(
+    occupancy_grid_map_pub_->publish(utils::occupancyGridMapUpdaterToMsgPtr(
       map_frame_, laserscan_pc_ptr->header.stamp, gridmap_origin.position.z,
       *occupancy_grid_map_updater_ptr_));
   }
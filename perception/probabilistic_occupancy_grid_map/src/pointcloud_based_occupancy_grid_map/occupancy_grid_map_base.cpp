@@ -69,6 +69,7 @@
 #endif
 
 #include <algorithm>
+#include <memory>
 namespace costmap_2d
 {
 using sensor_msgs::PointCloud2ConstIterator;
@@ -150,7 +151,12 @@ void OccupancyGridMapInterface::updateOrigin(double new_origin_x, double new_ori
 void OccupancyGridMapInterface::setCellValue(
   const double wx, const double wy, const unsigned char cost)
 {
-  MarkCell marker(costmap_, cost);
+  setCellValue(wx, wy, cost, CellWriter(costmap_));
+}
+
+void OccupancyGridMapInterface::setCellValue(
+  const double wx, const double wy, const unsigned char cost, const CellWriter & writer)
+{
   unsigned int mx{};
   unsigned int my{};
   if (!worldToMap(wx, wy, mx, my)) {
@@ -158,12 +164,19 @@ void OccupancyGridMapInterface::setCellValue(
     return;
   }
   const unsigned int index = getIndex(mx, my);
-  marker(index);
+  writer(index, cost);
 }
 
 void OccupancyGridMapInterface::raytrace(
   const double source_x, const double source_y, const double target_x, const double target_y,
   const unsigned char cost)
+{
+  raytrace(source_x, source_y, target_x, target_y, cost, CellWriter(costmap_));
+}
+
+void OccupancyGridMapInterface::raytrace(
+  const double source_x, const double source_y, const double target_x, const double target_y,
+  const unsigned char cost, const CellWriter & writer)
 {
   unsigned int x0{};
   unsigned int y0{};
@@ -225,8 +238,47 @@ void OccupancyGridMapInterface::raytrace(
   }
 
   constexpr unsigned int cell_raytrace_range = 10000;  // large number to ignore range threshold
-  MarkCell marker(costmap_, cost);
+  const auto marker = [&writer, cost](const unsigned int offset) { writer(offset, cost); };
   raytraceLine(marker, x0, y0, x1, y1, cell_raytrace_range);
 }
 
+void OccupancyGridMapInterface::forEachAngleBin(
+  const size_t angle_bin_size, const std::function<void(size_t, const CellWriter &)> & func)
+{
+  const int num_threads = std::max(num_threads_, 1);
+  if (num_threads == 1) {
+    const CellWriter writer(costmap_);
+    for (size_t bin_index = 0; bin_index < angle_bin_size; ++bin_index) {
+      func(bin_index, writer);
+    }
+    return;
+  }
+
+  // The rank of a chunk is stored in the upper byte of the stamped cost, 0 meaning not written.
+  // Several chunks per thread balance the load between the dense and the sparse directions.
+  constexpr size_t max_chunk_num = 255;
+  const size_t chunk_num =
+    std::min({static_cast<size_t>(num_threads) * 4, max_chunk_num, angle_bin_size});
+  const size_t cell_num = static_cast<size_t>(size_x_) * size_y_;
+  const auto stamped_costmap = std::make_unique<std::atomic<uint16_t>[]>(cell_num);
+
+#pragma omp parallel for num_threads(num_threads) schedule(dynamic)
+  for (size_t chunk_index = 0; chunk_index < chunk_num; ++chunk_index) {
+    const CellWriter writer(stamped_costmap.get(), static_cast<uint16_t>(chunk_index + 1));
+    const size_t begin = angle_bin_size * chunk_index / chunk_num;
+    const size_t end = angle_bin_size * (chunk_index + 1) / chunk_num;
+    for (size_t bin_index = begin; bin_index < end; ++bin_index) {
+      func(bin_index, writer);
+    }
+  }
+
+#pragma omp parallel for num_threads(num_threads)
+  for (size_t index = 0; index < cell_num; ++index) {
+    const uint16_t stamped_cost = stamped_costmap[index].load(std::memory_order_relaxed);
+    if (stamped_cost != 0) {
+      costmap_[index] = static_cast<unsigned char>(stamped_cost & 0xff);
+    }
+  }
+}
+
 }  // namespace costmap_2d
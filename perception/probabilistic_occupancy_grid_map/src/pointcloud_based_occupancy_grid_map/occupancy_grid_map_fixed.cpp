@@ -106,26 +106,22 @@ void OccupancyGridMapFixedBlindSpot::updateWithPointCloud(
       .push_back(BinInfo(std::hypot(*iter_y, *iter_x), *iter_wx, *iter_wy));
   }
 
-  // Sort by distance
-  for (auto & obstacle_pointcloud_angle_bin : obstacle_pointcloud_angle_bins) {
+  // First step: Initialize cells to the final point with freespace
+  forEachAngleBin(angle_bin_size, [&](const size_t bin_index, const CellWriter & writer) {
+    auto & obstacle_pointcloud_angle_bin = obstacle_pointcloud_angle_bins.at(bin_index);
+    auto & raw_pointcloud_angle_bin = raw_pointcloud_angle_bins.at(bin_index);
+
+    // Sort by distance
     std::sort(
       obstacle_pointcloud_angle_bin.begin(), obstacle_pointcloud_angle_bin.end(),
       [](auto a, auto b) { return a.range < b.range; });
-  }
-  for (auto & raw_pointcloud_angle_bin : raw_pointcloud_angle_bins) {
     std::sort(raw_pointcloud_angle_bin.begin(), raw_pointcloud_angle_bin.end(), [](auto a, auto b) {
       return a.range < b.range;
     });
-  }
-
-  // First step: Initialize cells to the final point with freespace
-  for (size_t bin_index = 0; bin_index < obstacle_pointcloud_angle_bins.size(); ++bin_index) {
-    auto & obstacle_pointcloud_angle_bin = obstacle_pointcloud_angle_bins.at(bin_index);
-    auto & raw_pointcloud_angle_bin = raw_pointcloud_angle_bins.at(bin_index);
 
     BinInfo end_distance;
     if (raw_pointcloud_angle_bin.empty() && obstacle_pointcloud_angle_bin.empty()) {
-      continue;
+      return;
     } else if (raw_pointcloud_angle_bin.empty()) {
       end_distance = obstacle_pointcloud_angle_bin.back();
     } else if (obstacle_pointcloud_angle_bin.empty()) {
@@ -138,11 +134,11 @@ void OccupancyGridMapFixedBlindSpot::updateWithPointCloud(
     }
     raytrace(
       scan_origin.position.x, scan_origin.position.y, end_distance.wx, end_distance.wy,
-      occupancy_cost_value::FREE_SPACE);
-  }
+      occupancy_cost_value::FREE_SPACE, writer);
+  });
 
   // Second step: Add unknown cell
-  for (size_t bin_index = 0; bin_index < obstacle_pointcloud_angle_bins.size(); ++bin_index) {
+  forEachAngleBin(angle_bin_size, [&](const size_t bin_index, const CellWriter & writer) {
     auto & obstacle_pointcloud_angle_bin = obstacle_pointcloud_angle_bins.at(bin_index);
     auto & raw_pointcloud_angle_bin = raw_pointcloud_angle_bins.at(bin_index);
     auto raw_distance_iter = raw_pointcloud_angle_bin.begin();
@@ -165,8 +161,9 @@ void OccupancyGridMapFixedBlindSpot::updateWithPointCloud(
         if (!no_freespace_point) {
           const auto & target = *raw_distance_iter;
           raytrace(
-            source.wx, source.wy, target.wx, target.wy, occupancy_cost_value::NO_INFORMATION);
-          setCellValue(target.wx, target.wy, occupancy_cost_value::FREE_SPACE);
+            source.wx, source.wy, target.wx, target.wy, occupancy_cost_value::NO_INFORMATION,
+            writer);
+          setCellValue(target.wx, target.wy, occupancy_cost_value::FREE_SPACE, writer);
         }
         continue;
       }
@@ -179,7 +176,8 @@ void OccupancyGridMapFixedBlindSpot::updateWithPointCloud(
       } else if (no_freespace_point) {
         const auto & source = obstacle_pointcloud_angle_bin.at(dist_index);
         const auto & target = obstacle_pointcloud_angle_bin.at(dist_index + 1);
-        raytrace(source.wx, source.wy, target.wx, target.wy, occupancy_cost_value::NO_INFORMATION);
+        raytrace(
+          source.wx, source.wy, target.wx, target.wy, occupancy_cost_value::NO_INFORMATION, writer);
         continue;
       }
 
@@ -188,24 +186,26 @@ void OccupancyGridMapFixedBlindSpot::updateWithPointCloud(
       if (next_raw_distance < next_obstacle_point_distance) {
         const auto & source = obstacle_pointcloud_angle_bin.at(dist_index);
         const auto & target = *raw_distance_iter;
-        raytrace(source.wx, source.wy, target.wx, target.wy, occupancy_cost_value::NO_INFORMATION);
-        setCellValue(target.wx, target.wy, occupancy_cost_value::FREE_SPACE);
+        raytrace(
+          source.wx, source.wy, target.wx, target.wy, occupancy_cost_value::NO_INFORMATION, writer);
+        setCellValue(target.wx, target.wy, occupancy_cost_value::FREE_SPACE, writer);
         continue;
       } else {
         const auto & source = obstacle_pointcloud_angle_bin.at(dist_index);
         const auto & target = obstacle_pointcloud_angle_bin.at(dist_index + 1);
-        raytrace(source.wx, source.wy, target.wx, target.wy, occupancy_cost_value::NO_INFORMATION);
+        raytrace(
+          source.wx, source.wy, target.wx, target.wy, occupancy_cost_value::NO_INFORMATION, writer);
         continue;
       }
     }
-  }
+  });
 
   // Third step: Overwrite occupied cell
-  for (size_t bin_index = 0; bin_index < obstacle_pointcloud_angle_bins.size(); ++bin_index) {
+  forEachAngleBin(angle_bin_size, [&](const size_t bin_index, const CellWriter & writer) {
     auto & obstacle_pointcloud_angle_bin = obstacle_pointcloud_angle_bins.at(bin_index);
     for (size_t dist_index = 0; dist_index < obstacle_pointcloud_angle_bin.size(); ++dist_index) {
       const auto & source = obstacle_pointcloud_angle_bin.at(dist_index);
-      setCellValue(source.wx, source.wy, occupancy_cost_value::LETHAL_OBSTACLE);
+      setCellValue(source.wx, source.wy, occupancy_cost_value::LETHAL_OBSTACLE, writer);
 
       if (dist_index + 1 == obstacle_pointcloud_angle_bin.size()) {
         continue;
@@ -217,11 +217,13 @@ void OccupancyGridMapFixedBlindSpot::updateWithPointCloud(
       if (next_obstacle_point_distance <= distance_margin_) {
         const auto & source = obstacle_pointcloud_angle_bin.at(dist_index);
         const auto & target = obstacle_pointcloud_angle_bin.at(dist_index + 1);
-        raytrace(source.wx, source.wy, target.wx, target.wy, occupancy_cost_value::LETHAL_OBSTACLE);
+        raytrace(
+          source.wx, source.wy, target.wx, target.wy, occupancy_cost_value::LETHAL_OBSTACLE,
+          writer);
         continue;
       }
     }
-  }
+  });
 }
 
 void OccupancyGridMapFixedBlindSpot::initRosParam(rclcpp::Node & node)
@@ -137,18 +137,6 @@ void OccupancyGridMapProjectiveBlindSpot::updateWithPointCloud(
     }
   }
 
-  // Sort by distance
-  for (auto & obstacle_pointcloud_angle_bin : obstacle_pointcloud_angle_bins) {
-    std::sort(
-      obstacle_pointcloud_angle_bin.begin(), obstacle_pointcloud_angle_bin.end(),
-      [](auto a, auto b) { return a.range < b.range; });
-  }
-  for (auto & raw_pointcloud_angle_bin : raw_pointcloud_angle_bins) {
-    std::sort(raw_pointcloud_angle_bin.begin(), raw_pointcloud_angle_bin.end(), [](auto a, auto b) {
-      return a.range < b.range;
-    });
-  }
-
   grid_map::Costmap2DConverter<grid_map::GridMap> converter;
   if (pub_debug_grid_) {
     debug_grid_.clearAll();
@@ -176,13 +164,21 @@ void OccupancyGridMapProjectiveBlindSpot::updateWithPointCloud(
   };
 
   // First step: Initialize cells to the final point with freespace
-  for (size_t bin_index = 0; bin_index < obstacle_pointcloud_angle_bins.size(); ++bin_index) {
-    const auto & obstacle_pointcloud_angle_bin = obstacle_pointcloud_angle_bins.at(bin_index);
-    const auto & raw_pointcloud_angle_bin = raw_pointcloud_angle_bins.at(bin_index);
+  forEachAngleBin(angle_bin_size, [&](const size_t bin_index, const CellWriter & writer) {
+    auto & obstacle_pointcloud_angle_bin = obstacle_pointcloud_angle_bins.at(bin_index);
+    auto & raw_pointcloud_angle_bin = raw_pointcloud_angle_bins.at(bin_index);
+
+    // Sort by distance
+    std::sort(
+      obstacle_pointcloud_angle_bin.begin(), obstacle_pointcloud_angle_bin.end(),
+      [](auto a, auto b) { return a.range < b.range; });
+    std::sort(raw_pointcloud_angle_bin.begin(), raw_pointcloud_angle_bin.end(), [](auto a, auto b) {
+      return a.range < b.range;
+    });
 
     BinInfo3D ray_end;
     if (raw_pointcloud_angle_bin.empty() && obstacle_pointcloud_angle_bin.empty()) {
-      continue;
+      return;
     } else if (raw_pointcloud_angle_bin.empty()) {
       ray_end = obstacle_pointcloud_angle_bin.back();
     } else if (obstacle_pointcloud_angle_bin.empty()) {
@@ -196,14 +192,14 @@ void OccupancyGridMapProjectiveBlindSpot::updateWithPointCloud(
     }
     raytrace(
       scan_origin.position.x, scan_origin.position.y, ray_end.wx, ray_end.wy,
-      occupancy_cost_value::FREE_SPACE);
-  }
+      occupancy_cost_value::FREE_SPACE, writer);
+  });
 
   if (pub_debug_grid_)
     converter.addLayerFromCostmap2D(*this, "filled_free_to_farthest", debug_grid_);
 
   // Second step: Add unknown cell
-  for (size_t bin_index = 0; bin_index < obstacle_pointcloud_angle_bins.size(); ++bin_index) {
+  forEachAngleBin(angle_bin_size, [&](const size_t bin_index, const CellWriter & writer) {
     const auto & obstacle_pointcloud_angle_bin = obstacle_pointcloud_angle_bins.at(bin_index);
     const auto & raw_pointcloud_angle_bin = raw_pointcloud_angle_bins.at(bin_index);
     auto raw_distance_iter = raw_pointcloud_angle_bin.begin();
@@ -223,7 +219,7 @@ void OccupancyGridMapProjectiveBlindSpot::updateWithPointCloud(
         const auto & source = obstacle_pointcloud_angle_bin.at(dist_index);
         raytrace(
           source.wx, source.wy, source.projected_wx, source.projected_wy,
-          occupancy_cost_value::NO_INFORMATION);
+          occupancy_cost_value::NO_INFORMATION, writer);
         break;
       }
 
@@ -232,7 +228,7 @@ void OccupancyGridMapProjectiveBlindSpot::updateWithPointCloud(
         if (!no_visible_point_beyond) {
           raytrace(
             source.wx, source.wy, source.projected_wx, source.projected_wy,
-            occupancy_cost_value::NO_INFORMATION);
+            occupancy_cost_value::NO_INFORMATION, writer);
         }
         continue;
       }
@@ -245,7 +241,8 @@ void OccupancyGridMapProjectiveBlindSpot::updateWithPointCloud(
       } else if (no_visible_point_beyond) {
         const auto & source = obstacle_pointcloud_angle_bin.at(dist_index);
         const auto & target = obstacle_pointcloud_angle_bin.at(dist_index + 1);
-        raytrace(source.wx, source.wy, target.wx, target.wy, occupancy_cost_value::NO_INFORMATION);
+        raytrace(
+          source.wx, source.wy, target.wx, target.wy, occupancy_cost_value::NO_INFORMATION, writer);
         continue;
       }
 
@@ -254,26 +251,28 @@ void OccupancyGridMapProjectiveBlindSpot::updateWithPointCloud(
       if (next_raw_distance < next_obstacle_point_distance) {
         const auto & source = obstacle_pointcloud_angle_bin.at(dist_index);
         const auto & target = *raw_distance_iter;
-        raytrace(source.wx, source.wy, target.wx, target.wy, occupancy_cost_value::NO_INFORMATION);
-        setCellValue(target.wx, target.wy, occupancy_cost_value::FREE_SPACE);
+        raytrace(
+          source.wx, source.wy, target.wx, target.wy, occupancy_cost_value::NO_INFORMATION, writer);
+        setCellValue(target.wx, target.wy, occupancy_cost_value::FREE_SPACE, writer);
         continue;
       } else {
         const auto & source = obstacle_pointcloud_angle_bin.at(dist_index);
         const auto & target = obstacle_pointcloud_angle_bin.at(dist_index + 1);
-        raytrace(source.wx, source.wy, target.wx, target.wy, occupancy_cost_value::NO_INFORMATION);
+        raytrace(
+          source.wx, source.wy, target.wx, target.wy, occupancy_cost_value::NO_INFORMATION, writer);
         continue;
       }
     }
-  }
+  });
 
   if (pub_debug_grid_) converter.addLayerFromCostmap2D(*this, "added_unknown", debug_grid_);
 
   // Third step: Overwrite occupied cell
-  for (size_t bin_index = 0; bin_index < obstacle_pointcloud_angle_bins.size(); ++bin_index) {
+  forEachAngleBin(angle_bin_size, [&](const size_t bin_index, const CellWriter & writer) {
     auto & obstacle_pointcloud_angle_bin = obstacle_pointcloud_angle_bins.at(bin_index);
     for (size_t dist_index = 0; dist_index < obstacle_pointcloud_angle_bin.size(); ++dist_index) {
       const auto & source = obstacle_pointcloud_angle_bin.at(dist_index);
-      setCellValue(source.wx, source.wy, occupancy_cost_value::LETHAL_OBSTACLE);
+      setCellValue(source.wx, source.wy, occupancy_cost_value::LETHAL_OBSTACLE, writer);
 
       if (dist_index + 1 == obstacle_pointcloud_angle_bin.size()) {
         continue;
@@ -285,11 +284,13 @@ void OccupancyGridMapProjectiveBlindSpot::updateWithPointCloud(
       if (next_obstacle_point_distance <= obstacle_separation_threshold_) {
         const auto & source = obstacle_pointcloud_angle_bin.at(dist_index);
         const auto & target = obstacle_pointcloud_angle_bin.at(dist_index + 1);
-        raytrace(source.wx, source.wy, target.wx, target.wy, occupancy_cost_value::LETHAL_OBSTACLE);
+        raytrace(
+          source.wx, source.wy, target.wx, target.wy, occupancy_cost_value::LETHAL_OBSTACLE,
+          writer);
         continue;
       }
     }
-  }
+  });
 
   if (pub_debug_grid_) converter.addLayerFromCostmap2D(*this, "added_obstacle", debug_grid_);
   if (pub_debug_grid_) {
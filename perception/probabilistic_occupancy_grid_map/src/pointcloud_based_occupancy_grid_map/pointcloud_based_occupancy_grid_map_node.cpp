@@ -116,6 +116,7 @@ PointcloudBasedOccupancyGridMapNode::PointcloudBasedOccupancyGridMapNode(
       occupancy_grid_map_updater_ptr_->getResolution());
   }
   occupancy_grid_map_ptr_->initRosParam(*this);
+  occupancy_grid_map_ptr_->setNumThreads(this->declare_parameter<int>("num_threads"));
 
   // initialize debug tool
   {
@@ -203,7 +204,7 @@ void PointcloudBasedOccupancyGridMapNode::onPointcloudWithObstacleAndRaw(
     occupancy_grid_map_updater_ptr_->update(*occupancy_grid_map_ptr_);
 
     // publish
-    occupancy_grid_map_pub_->publish(OccupancyGridMapToMsgPtr(
+    occupancy_grid_map_pub_->publish(utils::occupancyGridMapUpdaterToMsgPtr(
       map_frame_, input_raw_msg->header.stamp, robot_pose.position.z,
       *occupancy_grid_map_updater_ptr_));
   }
@@ -69,9 +69,10 @@ bool OccupancyGridMapBBFUpdater::update(const Costmap2D & single_frame_occupancy
 {
   updateOrigin(
     single_frame_occupancy_grid_map.getOriginX(), single_frame_occupancy_grid_map.getOriginY());
-  for (unsigned int x = 0; x < getSizeInCellsX(); x++) {
-    for (unsigned int y = 0; y < getSizeInCellsY(); y++) {
-      unsigned int index = getIndex(x, y);
+  // update the ring buffer in place
+  for (unsigned int y = 0; y < getSizeInCellsY(); y++) {
+    for (unsigned int x = 0; x < getSizeInCellsX(); x++) {
+      const unsigned int index = getRingIndex(x, y);
       costmap_[index] = applyBBF(single_frame_occupancy_grid_map.getCost(x, y), costmap_[index]);
     }
   }
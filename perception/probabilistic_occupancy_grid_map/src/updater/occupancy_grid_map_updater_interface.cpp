@@ -0,0 +1,76 @@
+// Copyright 2024 TIER IV, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "probabilistic_occupancy_grid_map/updater/occupancy_grid_map_updater_interface.hpp"
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+namespace costmap_2d
+{
+
+void OccupancyGridMapUpdaterInterface::updateOrigin(double new_origin_x, double new_origin_y)
+{
+  // project the new origin into the grid, keeping things grid-aligned
+  const int cell_ox{static_cast<int>(std::floor((new_origin_x - origin_x_) / resolution_))};
+  const int cell_oy{static_cast<int>(std::floor((new_origin_y - origin_y_) / resolution_))};
+  origin_x_ += cell_ox * resolution_;
+  origin_y_ += cell_oy * resolution_;
+
+  const int size_x{static_cast<int>(size_x_)};
+  const int size_y{static_cast<int>(size_y_)};
+  if (std::abs(cell_ox) >= size_x || std::abs(cell_oy) >= size_y) {
+    resetMaps();
+    ring_x_ = 0;
+    ring_y_ = 0;
+    return;
+  }
+
+  // the cell (mx, my) of the new map is the cell (mx + cell_ox, my + cell_oy) of the old one
+  ring_x_ = static_cast<unsigned int>((static_cast<int>(ring_x_) + cell_ox + size_x) % size_x);
+  ring_y_ = static_cast<unsigned int>((static_cast<int>(ring_y_) + cell_oy + size_y) % size_y);
+
+  // reset the cells that were not in the old map
+  if (cell_ox > 0) {
+    resetColumns(size_x_ - cell_ox, size_x_);
+  } else if (cell_ox < 0) {
+    resetColumns(0, -cell_ox);
+  }
+  if (cell_oy > 0) {
+    resetRows(size_y_ - cell_oy, size_y_);
+  } else if (cell_oy < 0) {
+    resetRows(0, -cell_oy);
+  }
+}
+
+void OccupancyGridMapUpdaterInterface::resetColumns(
+  const unsigned int mx_begin, const unsigned int mx_end)
+{
+  for (unsigned int my = 0; my < size_y_; ++my) {
+    for (unsigned int mx = mx_begin; mx < mx_end; ++mx) {
+      costmap_[getRingIndex(mx, my)] = default_value_;
+    }
+  }
+}
+
+void OccupancyGridMapUpdaterInterface::resetRows(
+  const unsigned int my_begin, const unsigned int my_end)
+{
+  for (unsigned int my = my_begin; my < my_end; ++my) {
+    std::memset(costmap_ + getRingRowIndex(my), default_value_, size_x_);
+  }
+}
+
+}  // namespace costmap_2d
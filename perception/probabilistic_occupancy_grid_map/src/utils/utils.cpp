@@ -16,6 +16,8 @@
 
 #include <tier4_autoware_utils/geometry/geometry.hpp>
 
+#include <algorithm>
+#include <memory>
 #include <string>
 
 namespace utils
@@ -198,4 +200,34 @@ unsigned char getApproximateOccupancyState(const unsigned char & value)
   }
 }
 
+nav_msgs::msg::OccupancyGrid::UniquePtr occupancyGridMapUpdaterToMsgPtr(
+  const std::string & frame_id, const builtin_interfaces::msg::Time & stamp,
+  const float & robot_pose_z,
+  const costmap_2d::OccupancyGridMapUpdaterInterface & occupancy_grid_map)
+{
+  auto msg_ptr = std::make_unique<nav_msgs::msg::OccupancyGrid>();
+
+  msg_ptr->header.frame_id = frame_id;
+  msg_ptr->header.stamp = stamp;
+  msg_ptr->info.resolution = occupancy_grid_map.getResolution();
+
+  msg_ptr->info.width = occupancy_grid_map.getSizeInCellsX();
+  msg_ptr->info.height = occupancy_grid_map.getSizeInCellsY();
+
+  msg_ptr->info.origin.position.x = occupancy_grid_map.getOriginX();
+  msg_ptr->info.origin.position.y = occupancy_grid_map.getOriginY();
+  msg_ptr->info.origin.position.z = robot_pose_z;
+  msg_ptr->info.origin.orientation.w = 1.0;
+
+  msg_ptr->data.resize(msg_ptr->info.width * msg_ptr->info.height);
+
+  auto data = msg_ptr->data.begin();
+  occupancy_grid_map.forEachCellRun([&data](const unsigned char * cells, const size_t length) {
+    data = std::transform(cells, cells + length, data, [](const unsigned char cost) {
+      return occupancy_cost_value::cost_translation_table[cost];
+    });
+  });
+  return msg_ptr;
+}
+
 }  // namespace utils
@@ -74,3 +74,53 @@ TEST(FusionPolicyTest, TestDempsterShaferUpdateRule)
   std::vector<double> case3_1 = {OCCUPIED, FREE};
   EXPECT_NEAR(dempsterShaferFusion(case3_1), UNKNOWN, EPSILON);
 }
+
+// Test the whole grid fusion against the cell-wise fusion
+TEST(FusionPolicyTest, TestGridFusionMatchesCellFusion)
+{
+  using fusion_policy::FusionMethod;
+  using fusion_policy::singleFrameOccupancyFusion;
+  constexpr size_t num_grids = 5;
+  constexpr size_t cell_num = 1000;  // not a multiple of the block size
+
+  std::vector<std::vector<unsigned char>> grids(num_grids, std::vector<unsigned char>(cell_num));
+  for (size_t i = 0; i < num_grids; ++i) {
+    for (size_t cell = 0; cell < cell_num; ++cell) {
+      grids[i][cell] = static_cast<unsigned char>((cell * (7 + 2 * i) + 31 * i) % 256);
+    }
+  }
+  std::vector<const unsigned char *> grid_ptrs;
+  for (const auto & grid : grids) {
+    grid_ptrs.push_back(grid.data());
+  }
+
+  for (const auto method :
+       {FusionMethod::OVERWRITE, FusionMethod::LOG_ODDS, FusionMethod::DEMPSTER_SHAFER}) {
+    for (const auto & reliability :
+         {std::vector<double>{0.2, 0.4, 0.6, 0.8, 1.0}, std::vector<double>(num_grids, 0.2)}) {
+      std::vector<unsigned char> fused_grid(cell_num);
+      singleFrameOccupancyFusion(grid_ptrs, cell_num, method, reliability, fused_grid.data());
+      for (size_t cell = 0; cell < cell_num; ++cell) {
+        std::vector<unsigned char> costs;
+        for (const auto & grid : grids) {
+          costs.push_back(grid[cell]);
+        }
+        ASSERT_EQ(fused_grid[cell], singleFrameOccupancyFusion(costs, method, reliability));
+      }
+    }
+
+    // the reliability which does not match the grids is ignored
+    for (const auto & reliability :
+         {std::vector<double>{0.2, 0.4, 0.6}, std::vector<double>(num_grids + 1, 0.2)}) {
+      std::vector<unsigned char> fused_grid(cell_num);
+      singleFrameOccupancyFusion(grid_ptrs, cell_num, method, reliability, fused_grid.data());
+      for (size_t cell = 0; cell < cell_num; ++cell) {
+        std::vector<unsigned char> costs;
+        for (const auto & grid : grids) {
+          costs.push_back(grid[cell]);
+        }
+        ASSERT_EQ(fused_grid[cell], singleFrameOccupancyFusion(costs, method));
+      }
+    }
+  }
+}
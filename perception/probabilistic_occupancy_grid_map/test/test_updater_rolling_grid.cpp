@@ -0,0 +1,113 @@
+// Copyright 2024 TIER IV, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "probabilistic_occupancy_grid_map/cost_value.hpp"
+#include "probabilistic_occupancy_grid_map/updater/occupancy_grid_map_updater_interface.hpp"
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+using costmap_2d::OccupancyGridMapUpdaterInterface;
+using nav2_costmap_2d::Costmap2D;
+
+// Updater writing the single frame map over the updater map, to check the ring buffer alone
+class CopyUpdater : public OccupancyGridMapUpdaterInterface
+{
+public:
+  using OccupancyGridMapUpdaterInterface::OccupancyGridMapUpdaterInterface;
+  bool update(const Costmap2D & single_frame_occupancy_grid_map) override
+  {
+    updateOrigin(
+      single_frame_occupancy_grid_map.getOriginX(), single_frame_occupancy_grid_map.getOriginY());
+    for (unsigned int y = 0; y < getSizeInCellsY(); y++) {
+      for (unsigned int x = 0; x < getSizeInCellsX(); x++) {
+        const unsigned char cost = single_frame_occupancy_grid_map.getCost(x, y);
+        if (cost != occupancy_cost_value::NO_INFORMATION) {
+          setCost(x, y, cost);
+        }
+      }
+    }
+    return true;
+  }
+  void initRosParam(rclcpp::Node & /*node*/) override {}
+};
+
+std::vector<unsigned char> unrolled(const OccupancyGridMapUpdaterInterface & map)
+{
+  std::vector<unsigned char> cells;
+  map.forEachCellRun([&cells](const unsigned char * run, const size_t length) {
+    cells.insert(cells.end(), run, run + length);
+  });
+  return cells;
+}
+
+TEST(OccupancyGridMapUpdaterInterfaceTest, RollingGridMatchesCopiedGrid)
+{
+  constexpr unsigned int size_x = 40;
+  constexpr unsigned int size_y = 30;
+  constexpr double resolution = 0.5;
+  CopyUpdater updater(size_x, size_y, resolution);
+  // reference: the map copied into its new origin by Costmap2D
+  Costmap2D reference(
+    size_x, size_y, resolution, 0.0, 0.0, occupancy_cost_value::NO_INFORMATION);
+
+  std::default_random_engine engine(0);
+  std::uniform_real_distribution<double> step_dist(-4.0, 4.0);
+  std::uniform_int_distribution<unsigned int> x_dist(0, size_x - 1);
+  std::uniform_int_distribution<unsigned int> y_dist(0, size_y - 1);
+  double origin_x = 0.0;
+  double origin_y = 0.0;
+  for (int frame = 0; frame < 200; ++frame) {
+    // some jumps are larger than the map
+    const double scale = frame % 50 == 49 ? 10.0 : 1.0;
+    origin_x += scale * step_dist(engine);
+    origin_y += scale * step_dist(engine);
+    Costmap2D single_frame(
+      size_x, size_y, resolution, origin_x, origin_y, occupancy_cost_value::NO_INFORMATION);
+    for (int i = 0; i < 50; ++i) {
+      single_frame.setCost(
+        x_dist(engine), y_dist(engine),
+        i % 2 ? occupancy_cost_value::LETHAL_OBSTACLE : occupancy_cost_value::FREE_SPACE);
+    }
+
+    updater.update(single_frame);
+    reference.updateOrigin(origin_x, origin_y);
+    for (unsigned int y = 0; y < size_y; y++) {
+      for (unsigned int x = 0; x < size_x; x++) {
+        const unsigned char cost = single_frame.getCost(x, y);
+        if (cost != occupancy_cost_value::NO_INFORMATION) {
+          reference.setCost(x, y, cost);
+        }
+      }
+    }
+
+    ASSERT_DOUBLE_EQ(updater.getOriginX(), reference.getOriginX());
+    ASSERT_DOUBLE_EQ(updater.getOriginY(), reference.getOriginY());
+    const std::vector<unsigned char> expected(
+      reference.getCharMap(), reference.getCharMap() + size_x * size_y);
+    ASSERT_EQ(unrolled(updater), expected) << "frame " << frame;
+    for (unsigned int y = 0; y < size_y; y++) {
+      for (unsigned int x = 0; x < size_x; x++) {
+        ASSERT_EQ(updater.getCharMap()[updater.getRingIndex(x, y)], reference.getCost(x, y));
+        double wx, wy;
+        reference.mapToWorld(x, y, wx, wy);
+        unsigned int mx, my;
+        ASSERT_TRUE(updater.worldToMap(wx, wy, mx, my));
+        ASSERT_EQ(updater.getCost(mx, my), reference.getCost(x, y));
+      }
+    }
+  }
+}
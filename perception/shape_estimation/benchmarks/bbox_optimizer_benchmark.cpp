@@ -0,0 +1,144 @@
+// Copyright 2024 TIER IV, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Compares the L-shape fitting optimizers of the bounding box model on synthetic clusters.
+//
+// usage: bbox_optimizer_benchmark [-r <repeats>]
+//
+// The clusters are the two visible sides of a 12 [m] x 2.5 [m] vehicle with a random pose, with
+// noise on the points, as seen by a lidar from one corner.
+
+#include "shape_estimation/model/bounding_box.hpp"
+
+#include <tf2/utils.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+constexpr float vehicle_length = 12.0;  // [m]
+constexpr float vehicle_width = 2.5;    // [m]
+constexpr float point_noise = 0.05;     // [m]
+
+pcl::PointCloud<pcl::PointXYZ> make_cluster(const size_t point_num, std::mt19937 & engine)
+{
+  std::uniform_real_distribution<float> unit_distribution(0.0, 1.0);
+  std::uniform_real_distribution<float> yaw_distribution(-M_PI, M_PI);
+  std::uniform_real_distribution<float> position_distribution(-30.0, 30.0);
+  std::normal_distribution<float> noise_distribution(0.0, point_noise);
+
+  const float yaw = yaw_distribution(engine);
+  const float center_x = position_distribution(engine);
+  const float center_y = position_distribution(engine);
+  pcl::PointCloud<pcl::PointXYZ> cluster;
+  for (size_t i = 0; i < point_num; ++i) {
+    // points on the long side and on the short side in proportion to their length
+    float x, y;
+    if (unit_distribution(engine) * (vehicle_length + vehicle_width) < vehicle_length) {
+      x = unit_distribution(engine) * vehicle_length;
+      y = 0.0;
+    } else {
+      x = 0.0;
+      y = unit_distribution(engine) * vehicle_width;
+    }
+    x += noise_distribution(engine);
+    y += noise_distribution(engine);
+    const float z = unit_distribution(engine) * 3.0;
+    cluster.push_back(pcl::PointXYZ(
+      center_x + x * std::cos(yaw) - y * std::sin(yaw),
+      center_y + x * std::sin(yaw) + y * std::cos(yaw), z));
+  }
+  return cluster;
+}
+
+struct Result
+{
+  double time_ms{0.0};
+  std::vector<double> yaws;
+};
+
+Result run(
+  const std::vector<pcl::PointCloud<pcl::PointXYZ>> & clusters, const bool use_boost,
+  const bool use_batched, const int repeats)
+{
+  Result result;
+  const auto start = std::chrono::steady_clock::now();
+  for (int r = 0; r < repeats; ++r) {
+    result.yaws.clear();
+    for (const auto & cluster : clusters) {
+      BoundingBoxShapeModel model(boost::none, use_boost, use_batched);
+      autoware_auto_perception_msgs::msg::Shape shape;
+      geometry_msgs::msg::Pose pose;
+      model.estimate(cluster, shape, pose);
+      result.yaws.push_back(tf2::getYaw(pose.orientation));
+    }
+  }
+  const auto end = std::chrono::steady_clock::now();
+  result.time_ms =
+    std::chrono::duration<double, std::milli>(end - start).count() / repeats / clusters.size();
+  return result;
+}
+
+// Largest yaw difference to the reference, modulo the 90 [deg] symmetry of the box
+double max_yaw_diff(const std::vector<double> & yaws, const std::vector<double> & reference_yaws)
+{
+  double max_diff = 0.0;
+  for (size_t i = 0; i < yaws.size(); ++i) {
+    double diff = std::fmod(std::fabs(yaws.at(i) - reference_yaws.at(i)), M_PI_2);
+    diff = std::min(diff, M_PI_2 - diff);
+    max_diff = std::max(max_diff, diff);
+  }
+  return max_diff;
+}
+
+int main(int argc, char ** argv)
+{
+  int repeats = 5;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+      repeats = std::max(std::atoi(argv[++i]), 1);
+    } else {
+      std::fprintf(stderr, "usage: %s [-r <repeats>]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  constexpr size_t cluster_num = 20;
+  std::mt19937 engine(0);
+  std::printf(
+    "%7s  %14s  %14s  %14s  %s\n", "points", "search [ms]", "boost [ms]", "batched [ms]",
+    "max yaw diff to search [deg] (boost / batched)");
+  for (const size_t point_num : {50, 200, 1000, 5000, 20000}) {
+    std::vector<pcl::PointCloud<pcl::PointXYZ>> clusters;
+    for (size_t i = 0; i < cluster_num; ++i) {
+      clusters.push_back(make_cluster(point_num, engine));
+    }
+
+    const auto search_result = run(clusters, false, false, repeats);
+    const auto boost_result = run(clusters, true, false, repeats);
+    const auto batched_result = run(clusters, false, true, repeats);
+    std::printf(
+      "%7zu  %14.3f  %14.3f  %14.3f  %.2f / %.2f\n", point_num, search_result.time_ms,
+      boost_result.time_ms, batched_result.time_ms,
+      max_yaw_diff(boost_result.yaws, search_result.yaws) * 180.0 / M_PI,
+      max_yaw_diff(batched_result.yaws, search_result.yaws) * 180.0 / M_PI);
+  }
+  return 0;
+}
@@ -32,13 +32,17 @@ private:
     const pcl::PointCloud<pcl::PointXYZ> & cluster, const float min_angle, const float max_angle);
   float boostOptimize(
     const pcl::PointCloud<pcl::PointXYZ> & cluster, const float min_angle, const float max_angle);
+  float batchedOptimize(
+    const pcl::PointCloud<pcl::PointXYZ> & cluster, const float min_angle, const float max_angle);
 
 public:
   BoundingBoxShapeModel();
   explicit BoundingBoxShapeModel(
-    const boost::optional<ReferenceYawInfo> & ref_yaw_info, bool use_boost_bbox_optimizer = false);
+    const boost::optional<ReferenceYawInfo> & ref_yaw_info, bool use_boost_bbox_optimizer = false,
+    bool use_batched_bbox_optimizer = false);
   boost::optional<ReferenceYawInfo> ref_yaw_info_;
   bool use_boost_bbox_optimizer_;
+  bool use_batched_bbox_optimizer_;
 
   ~BoundingBoxShapeModel() {}
 
@@ -64,9 +64,12 @@ private:
   bool use_corrector_;
   bool use_filter_;
   bool use_boost_bbox_optimizer_;
+  bool use_batched_bbox_optimizer_;
 
 public:
-  ShapeEstimator(bool use_corrector, bool use_filter, bool use_boost_bbox_optimizer = false);
+  ShapeEstimator(
+    bool use_corrector, bool use_filter, bool use_boost_bbox_optimizer = false,
+    bool use_batched_bbox_optimizer = false);
 
   virtual ~ShapeEstimator() = default;
 
@@ -35,6 +35,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <limits>
 #include <utility>
 #include <vector>
 
@@ -45,13 +46,16 @@
 constexpr float epsilon = 0.001;
 
 BoundingBoxShapeModel::BoundingBoxShapeModel()
-: ref_yaw_info_(boost::none), use_boost_bbox_optimizer_(false)
+: ref_yaw_info_(boost::none), use_boost_bbox_optimizer_(false), use_batched_bbox_optimizer_(false)
 {
 }
 
 BoundingBoxShapeModel::BoundingBoxShapeModel(
-  const boost::optional<ReferenceYawInfo> & ref_yaw_info, bool use_boost_bbox_optimizer)
-: ref_yaw_info_(ref_yaw_info), use_boost_bbox_optimizer_(use_boost_bbox_optimizer)
+  const boost::optional<ReferenceYawInfo> & ref_yaw_info, bool use_boost_bbox_optimizer,
+  bool use_batched_bbox_optimizer)
+: ref_yaw_info_(ref_yaw_info),
+  use_boost_bbox_optimizer_(use_boost_bbox_optimizer),
+  use_batched_bbox_optimizer_(use_batched_bbox_optimizer)
 {
 }
 
@@ -91,6 +95,8 @@ bool BoundingBoxShapeModel::fitLShape(
   double theta_star;
   if (use_boost_bbox_optimizer_) {
     theta_star = boostOptimize(cluster, min_angle, max_angle);
+  } else if (use_batched_bbox_optimizer_) {
+    theta_star = batchedOptimize(cluster, min_angle, max_angle);
   } else {
     theta_star = optimize(cluster, min_angle, max_angle);
   }
@@ -190,7 +196,7 @@ float BoundingBoxShapeModel::calcClosenessCriterion(
       continue;
     }
     const float d = std::max(std::min(D_1.at(i), D_2.at(i)), d_min);
-    beta += 1.0 / d;
+    beta += 1.0f / d;
   }
   return beta;
 }
@@ -252,3 +258,78 @@ float BoundingBoxShapeModel::boostOptimize(
   float theta_star = min.first;
   return theta_star;
 }
+
+float BoundingBoxShapeModel::batchedOptimize(
+  const pcl::PointCloud<pcl::PointXYZ> & cluster, const float min_angle, const float max_angle)
+{
+  // Same search and criterion as optimize(), but the extents and the closeness criterion of all
+  // the candidate angles are each accumulated in a single pass over the points
+  std::vector<float> thetas;
+  std::vector<float> cos_thetas;
+  std::vector<float> sin_thetas;
+  constexpr float angle_resolution = M_PI / 180.0;
+  for (float theta = min_angle; theta <= max_angle + epsilon; theta += angle_resolution) {
+    thetas.push_back(theta);
+    cos_thetas.push_back(std::cos(theta));
+    sin_thetas.push_back(std::sin(theta));
+  }
+  if (cluster.empty() || thetas.empty()) {
+    return min_angle;
+  }
+  const size_t angle_num = thetas.size();
+
+  // structure of arrays copy of the cluster
+  std::vector<float> xs(cluster.size());
+  std::vector<float> ys(cluster.size());
+  for (size_t i = 0; i < cluster.size(); ++i) {
+    xs[i] = cluster.at(i).x;
+    ys[i] = cluster.at(i).y;
+  }
+
+  // col.2-3, Algo.4, from every point, since the projections of the points which are not on the
+  // convex hull can still round beyond the ones of the hull
+  std::vector<float> min_c_1(angle_num, std::numeric_limits<float>::max());
+  std::vector<float> max_c_1(angle_num, std::numeric_limits<float>::lowest());
+  std::vector<float> min_c_2(angle_num, std::numeric_limits<float>::max());
+  std::vector<float> max_c_2(angle_num, std::numeric_limits<float>::lowest());
+  for (size_t i = 0; i < xs.size(); ++i) {
+    const float x = xs[i];
+    const float y = ys[i];
+    for (size_t k = 0; k < angle_num; ++k) {
+      const float c_1 = x * cos_thetas[k] + y * sin_thetas[k];
+      const float c_2 = x * -sin_thetas[k] + y * cos_thetas[k];
+      min_c_1[k] = std::min(min_c_1[k], c_1);
+      max_c_1[k] = std::max(max_c_1[k], c_1);
+      min_c_2[k] = std::min(min_c_2[k], c_2);
+      max_c_2[k] = std::max(max_c_2[k], c_2);
+    }
+  }
+
+  // col.4-6, Algo.4, the inner loop over the angles is vectorizable
+  constexpr float d_min = 0.1 * 0.1;
+  constexpr float d_max = 0.4 * 0.4;
+  std::vector<float> Q(angle_num, 0.0f);
+  for (size_t i = 0; i < xs.size(); ++i) {
+    const float x = xs[i];
+    const float y = ys[i];
+    for (size_t k = 0; k < angle_num; ++k) {
+      const float c_1 = x * cos_thetas[k] + y * sin_thetas[k];
+      const float c_2 = x * -sin_thetas[k] + y * cos_thetas[k];
+      const float v_1 = std::min(max_c_1[k] - c_1, c_1 - min_c_1[k]);
+      const float v_2 = std::min(max_c_2[k] - c_2, c_2 - min_c_2[k]);
+      const float d = std::min(v_1 * v_1, v_2 * v_2);
+      Q[k] += d_max < d ? 0.0f : 1.0f / std::max(d, d_min);
+    }
+  }
+
+  float theta_star{0.0};  // col.10, Algo.2
+  float max_q = 0.0;
+  for (size_t k = 0; k < angle_num; ++k) {
+    if (max_q < Q[k] || k == 0) {
+      max_q = Q[k];
+      theta_star = thetas[k];
+    }
+  }
+
+  return theta_star;
+}
@@ -23,10 +23,13 @@
 
 using Label = autoware_auto_perception_msgs::msg::ObjectClassification;
 
-ShapeEstimator::ShapeEstimator(bool use_corrector, bool use_filter, bool use_boost_bbox_optimizer)
+ShapeEstimator::ShapeEstimator(
+  bool use_corrector, bool use_filter, bool use_boost_bbox_optimizer,
+  bool use_batched_bbox_optimizer)
 : use_corrector_(use_corrector),
   use_filter_(use_filter),
-  use_boost_bbox_optimizer_(use_boost_bbox_optimizer)
+  use_boost_bbox_optimizer_(use_boost_bbox_optimizer),
+  use_batched_bbox_optimizer_(use_batched_bbox_optimizer)
 {
 }
 
@@ -79,7 +82,8 @@ bool ShapeEstimator::estimateOriginalShapeAndPose(
   if (
     label == Label::CAR || label == Label::TRUCK || label == Label::BUS ||
     label == Label::TRAILER || label == Label::MOTORCYCLE || label == Label::BICYCLE) {
-    model_ptr.reset(new BoundingBoxShapeModel(ref_yaw_info, use_boost_bbox_optimizer_));
+    model_ptr.reset(new BoundingBoxShapeModel(
+      ref_yaw_info, use_boost_bbox_optimizer_, use_batched_bbox_optimizer_));
   } else if (label == Label::PEDESTRIAN) {
     model_ptr.reset(new CylinderShapeModel());
   } else {
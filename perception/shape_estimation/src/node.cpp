@@ -47,11 +47,14 @@ ShapeEstimationNode::ShapeEstimationNode(const rclcpp::NodeOptions & node_option
   use_vehicle_reference_yaw_ = declare_parameter<bool>("use_vehicle_reference_yaw");
   use_vehicle_reference_shape_size_ = declare_parameter<bool>("use_vehicle_reference_shape_size");
   bool use_boost_bbox_optimizer = declare_parameter<bool>("use_boost_bbox_optimizer");
+  bool use_batched_bbox_optimizer = declare_parameter<bool>("use_batched_bbox_optimizer");
   fix_filtered_objects_label_to_unknown_ =
     declare_parameter<bool>("fix_filtered_objects_label_to_unknown");
   RCLCPP_INFO(this->get_logger(), "using boost shape estimation : %d", use_boost_bbox_optimizer);
-  estimator_ =
-    std::make_unique<ShapeEstimator>(use_corrector, use_filter, use_boost_bbox_optimizer);
+  RCLCPP_INFO(
+    this->get_logger(), "using batched shape estimation : %d", use_batched_bbox_optimizer);
+  estimator_ = std::make_unique<ShapeEstimator>(
+    use_corrector, use_filter, use_boost_bbox_optimizer, use_batched_bbox_optimizer);
 
   processing_time_publisher_ =
     std::make_unique<tier4_autoware_utils::DebugPublisher>(this, "shape_estimation");
@@ -0,0 +1,120 @@
+// Copyright 2024 TIER IV, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "shape_estimation/model/bounding_box.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+// the two visible sides of a box with a random pose, as seen by a lidar from one corner
+pcl::PointCloud<pcl::PointXYZ> make_l_shaped_cluster(
+  const size_t point_num, const float length, const float width, const float noise,
+  std::mt19937 & engine)
+{
+  std::uniform_real_distribution<float> unit_distribution(0.0, 1.0);
+  std::uniform_real_distribution<float> yaw_distribution(-M_PI, M_PI);
+  std::uniform_real_distribution<float> position_distribution(-50.0, 50.0);
+  std::normal_distribution<float> noise_distribution(0.0, noise);
+
+  const float yaw = yaw_distribution(engine);
+  const float center_x = position_distribution(engine);
+  const float center_y = position_distribution(engine);
+  pcl::PointCloud<pcl::PointXYZ> cluster;
+  for (size_t i = 0; i < point_num; ++i) {
+    float x = 0.0;
+    float y = 0.0;
+    if (unit_distribution(engine) * (length + width) < length) {
+      x = unit_distribution(engine) * length;
+    } else {
+      y = unit_distribution(engine) * width;
+    }
+    if (noise > 0.0) {
+      x += noise_distribution(engine);
+      y += noise_distribution(engine);
+    }
+    cluster.push_back(pcl::PointXYZ(
+      center_x + x * std::cos(yaw) - y * std::sin(yaw),
+      center_y + x * std::sin(yaw) + y * std::cos(yaw), unit_distribution(engine) * 2.0));
+  }
+  return cluster;
+}
+
+void expect_same_box(
+  const pcl::PointCloud<pcl::PointXYZ> & cluster,
+  const boost::optional<ReferenceYawInfo> & ref_yaw_info)
+{
+  autoware_auto_perception_msgs::msg::Shape search_shape;
+  geometry_msgs::msg::Pose search_pose;
+  BoundingBoxShapeModel search_model(ref_yaw_info, false, false);
+  ASSERT_TRUE(search_model.estimate(cluster, search_shape, search_pose));
+
+  autoware_auto_perception_msgs::msg::Shape batched_shape;
+  geometry_msgs::msg::Pose batched_pose;
+  BoundingBoxShapeModel batched_model(ref_yaw_info, false, true);
+  ASSERT_TRUE(batched_model.estimate(cluster, batched_shape, batched_pose));
+
+  // the same angle is selected, so the box is computed from the same values
+  EXPECT_EQ(batched_pose.orientation.z, search_pose.orientation.z);
+  EXPECT_EQ(batched_pose.orientation.w, search_pose.orientation.w);
+  EXPECT_EQ(batched_pose.position.x, search_pose.position.x);
+  EXPECT_EQ(batched_pose.position.y, search_pose.position.y);
+  EXPECT_EQ(batched_shape.dimensions.x, search_shape.dimensions.x);
+  EXPECT_EQ(batched_shape.dimensions.y, search_shape.dimensions.y);
+}
+
+TEST(BoundingBoxShapeModelTest, BatchedOptimizerMatchesSearchOnLShapedClusters)
+{
+  std::mt19937 engine(0);
+  for (const size_t point_num : {5, 50, 500, 3000}) {
+    for (const float noise : {0.0, 0.02, 0.2}) {
+      for (int i = 0; i < 10; ++i) {
+        const auto cluster = make_l_shaped_cluster(point_num, 12.0, 2.5, noise, engine);
+        expect_same_box(cluster, boost::none);
+        expect_same_box(cluster, ReferenceYawInfo{static_cast<float>(i * 0.3), 0.3});
+      }
+    }
+  }
+}
+
+TEST(BoundingBoxShapeModelTest, BatchedOptimizerMatchesSearchOnTies)
+{
+  // a square seen from a corner has the same criterion at 0 and 90 degrees
+  pcl::PointCloud<pcl::PointXYZ> square;
+  for (int i = 0; i <= 20; ++i) {
+    square.push_back(pcl::PointXYZ(0.1 * i, 0.0, 0.0));
+    square.push_back(pcl::PointXYZ(0.0, 0.1 * i, 0.0));
+  }
+  expect_same_box(square, boost::none);
+
+  // dense points along straight sides far from the origin, most of them between the corners of the
+  // convex hull, whose projections round to just beyond the ones of the corners
+  std::mt19937 engine(1);
+  for (int i = 0; i < 20; ++i) {
+    const auto cluster = make_l_shaped_cluster(2000, 4.5, 4.5, 0.0, engine);
+    expect_same_box(cluster, boost::none);
+  }
+
+  // a single point, and points on a line, whose criterion is the same for many angles
+  pcl::PointCloud<pcl::PointXYZ> point;
+  point.push_back(pcl::PointXYZ(10.0, -3.0, 0.0));
+  expect_same_box(point, boost::none);
+  pcl::PointCloud<pcl::PointXYZ> line;
+  for (int i = 0; i < 100; ++i) {
+    line.push_back(pcl::PointXYZ(30.0 + 0.05 * i, 20.0 + 0.05 * i, 0.0));
+  }
+  expect_same_box(line, boost::none);
+}
@@ -0,0 +1,138 @@
+// Copyright 2024 TIER IV, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "pointcloud_preprocessor/downsample_filter/faster_voxel_grid_downsample_filter.hpp"
+
+#include <pcl/io/pcd_io.h>
+#include <pcl_conversions/pcl_conversions.h>
+#include <sensor_msgs/point_cloud2_iterator.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using pointcloud_preprocessor::FasterVoxelGridDownsampleFilter;
+using pointcloud_preprocessor::TransformInfo;
+using sensor_msgs::msg::PointCloud2;
+
+PointCloud2 random_cloud(const size_t num_points)
+{
+  std::default_random_engine engine(0);
+  // Denser close to the sensor, like a real scan
+  std::exponential_distribution<float> range_dist(0.05f);
+  std::uniform_real_distribution<float> angle_dist(-M_PI, M_PI);
+  std::uniform_real_distribution<float> z_dist(-2.0f, 3.0f);
+
+  PointCloud2 cloud;
+  sensor_msgs::PointCloud2Modifier modifier(cloud);
+  modifier.setPointCloud2Fields(
+    4, "x", 1, sensor_msgs::msg::PointField::FLOAT32, "y", 1,
+    sensor_msgs::msg::PointField::FLOAT32, "z", 1, sensor_msgs::msg::PointField::FLOAT32,
+    "intensity", 1, sensor_msgs::msg::PointField::FLOAT32);
+  modifier.resize(num_points);
+  sensor_msgs::PointCloud2Iterator<float> it(cloud, "x");
+  for (size_t i = 0; i < num_points; ++i, ++it) {
+    const float range = std::min(range_dist(engine), 200.0f);
+    const float angle = angle_dist(engine);
+    it[0] = range * std::cos(angle);
+    it[1] = range * std::sin(angle);
+    it[2] = z_dist(engine);
+    it[3] = 0.0f;
+  }
+  return cloud;
+}
+
+// Output points sorted so that the results can be compared regardless of the voxel order
+std::vector<std::array<float, 3>> sorted_points(const PointCloud2 & cloud)
+{
+  std::vector<std::array<float, 3>> points;
+  points.reserve(cloud.width * cloud.height);
+  for (sensor_msgs::PointCloud2ConstIterator<float> it(cloud, "x"); it != it.end(); ++it) {
+    points.push_back({it[0], it[1], it[2]});
+  }
+  std::sort(points.begin(), points.end());
+  return points;
+}
+
+double run(
+  FasterVoxelGridDownsampleFilter & filter, const PointCloud2 & input, PointCloud2 & output,
+  const int iterations)
+{
+  const auto logger = rclcpp::get_logger("voxel_grid_downsample_benchmark");
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; ++i) {
+    filter.filter(input, output, TransformInfo(), logger);
+  }
+  const auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count() / iterations;
+}
+
+int main(int argc, char * argv[])
+{
+  int num_threads = static_cast<int>(std::max(std::thread::hardware_concurrency(), 2u));
+  std::vector<std::string> pcd_files;
+  for (int i = 1; i < argc; ++i) {
+    const auto arg = std::string(argv[i]);
+    if ((arg == "-t" || arg == "--threads") && i + 1 < argc) {
+      num_threads = std::stoi(argv[++i]);
+    } else {
+      pcd_files.push_back(arg);
+    }
+  }
+
+  std::vector<std::pair<std::string, PointCloud2>> clouds;
+  for (const auto & file : pcd_files) {
+    pcl::PCLPointCloud2 pcl_cloud;
+    if (pcl::io::loadPCDFile(file, pcl_cloud) != 0) {
+      std::fprintf(stderr, "failed to load %s\n", file.c_str());
+      return 1;
+    }
+    PointCloud2 cloud;
+    pcl_conversions::fromPCL(pcl_cloud, cloud);
+    clouds.emplace_back(file, cloud);
+  }
+  if (clouds.empty()) {
+    for (const size_t num_points : {100000lu, 300000lu, 600000lu, 1000000lu}) {
+      clouds.emplace_back("random_" + std::to_string(num_points), random_cloud(num_points));
+    }
+  }
+
+  constexpr auto iterations = 20;
+  std::printf("#Cloud Points VoxelSize Threads OutputPoints SerialMs ShardedMs Identical\n");
+  for (const auto & [name, cloud] : clouds) {
+    for (const float voxel_size : {0.1f, 0.3f, 1.0f}) {
+      FasterVoxelGridDownsampleFilter serial_filter;
+      serial_filter.set_voxel_size(voxel_size, voxel_size, voxel_size);
+      FasterVoxelGridDownsampleFilter sharded_filter;
+      sharded_filter.set_voxel_size(voxel_size, voxel_size, voxel_size);
+      sharded_filter.set_num_threads(num_threads);
+
+      PointCloud2 serial_output;
+      PointCloud2 sharded_output;
+      const double serial_ms = run(serial_filter, cloud, serial_output, iterations);
+      const double sharded_ms = run(sharded_filter, cloud, sharded_output, iterations);
+      const bool identical = sorted_points(serial_output) == sorted_points(sharded_output);
+      std::printf(
+        "%s %u %.2f %d %u %.3f %.3f %s\n", name.c_str(), cloud.width * cloud.height, voxel_size,
+        num_threads, serial_output.width, serial_ms, sharded_ms, identical ? "yes" : "no");
+    }
+  }
+  return 0;
+}
@@ -127,12 +127,15 @@ private:
 
   bool publish_synchronized_pointcloud_;
   bool keep_input_frame_in_synchronized_pointcloud_;
+  /** \brief Transform each cloud to the output frame in its own callback instead of at publish. */
+  bool concatenate_on_arrival_;
   std::string synchronized_pointcloud_postfix_;
 
   std::set<std::string> not_subscribed_topic_names_;
 
   /** \brief A vector of subscriber. */
   std::vector<rclcpp::Subscription<PointCloud2>::SharedPtr> filters_;
+  rclcpp::CallbackGroup::SharedPtr cloud_callback_group_;
 
   rclcpp::Subscription<geometry_msgs::msg::TwistWithCovarianceStamped>::SharedPtr sub_twist_;
   rclcpp::Subscription<nav_msgs::msg::Odometry>::SharedPtr sub_odom_;
@@ -157,6 +160,11 @@ private:
 
   std::map<std::string, sensor_msgs::msg::PointCloud2::ConstSharedPtr> cloud_stdmap_;
   std::map<std::string, sensor_msgs::msg::PointCloud2::ConstSharedPtr> cloud_stdmap_tmp_;
+  std::map<std::string, rclcpp::Time> arrival_time_map_;
+  std::map<std::string, rclcpp::Time> arrival_time_map_tmp_;
+  /** \brief Transform from the output frame back to the input frame of each cached cloud. */
+  std::map<std::string, Eigen::Matrix4f> output_to_input_transform_map_;
+  std::map<std::string, Eigen::Matrix4f> output_to_input_transform_map_tmp_;
   std::mutex mutex_;
 
   std::vector<double> input_offset_;
@@ -167,6 +175,13 @@ private:
     const rclcpp::Time & old_stamp, const rclcpp::Time & new_stamp);
   std::map<std::string, sensor_msgs::msg::PointCloud2::SharedPtr> combineClouds(
     sensor_msgs::msg::PointCloud2::SharedPtr & concat_cloud_ptr);
+  std::map<std::string, sensor_msgs::msg::PointCloud2::SharedPtr> combineTransformedClouds(
+    sensor_msgs::msg::PointCloud2::SharedPtr & concat_cloud_ptr);
+  bool getTransformMatrix(
+    const std::string & target_frame, const std_msgs::msg::Header & header,
+    Eigen::Matrix4f & eigen_transform);
+  void transformXYZICloud(
+    const Eigen::Matrix4f & transform, const PointCloud2 & input, uint8_t * output_data);
   void publish();
 
   void convertToXYZICloud(
@@ -0,0 +1,48 @@
+// Copyright 2024 TIER IV, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef POINTCLOUD_PREPROCESSOR__CROP_BOX_FILTER__CROP_BOX_HPP_
+#define POINTCLOUD_PREPROCESSOR__CROP_BOX_FILTER__CROP_BOX_HPP_
+
+#include "pointcloud_preprocessor/transform_info.hpp"
+
+#include <sensor_msgs/msg/point_cloud2.hpp>
+
+namespace pointcloud_preprocessor
+{
+struct CropBoxParam
+{
+  float min_x;
+  float max_x;
+  float min_y;
+  float max_y;
+  float min_z;
+  float max_z;
+  bool negative{false};
+};
+
+/** \brief Keep the points inside the box (or outside it if `param.negative`), after transforming
+ * them with `transform_info`. Points with non-finite coordinates are dropped.
+ *
+ * `input` and `output` may refer to the same cloud, in which case the kept points are compacted
+ * to the front of its buffer. The header of `output` is left untouched.
+ * \return the number of points dropped for non-finite coordinates
+ */
+int cropBox(
+  const sensor_msgs::msg::PointCloud2 & input, sensor_msgs::msg::PointCloud2 & output,
+  const CropBoxParam & param, const TransformInfo & transform_info);
+}  // namespace pointcloud_preprocessor
+
+#endif  // POINTCLOUD_PREPROCESSOR__CROP_BOX_FILTER__CROP_BOX_HPP_
@@ -42,6 +42,7 @@
 #include <deque>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace pointcloud_preprocessor
 {
@@ -63,6 +64,9 @@ private:
     tf2::Transform * tf2_transform_ptr);
 
   bool undistortPointCloud(const tf2::Transform & tf2_base_link_to_sensor, PointCloud2 & points);
+  bool undistortPointCloudWithTimeSlices(
+    const tf2::Transform & tf2_base_link_to_sensor, PointCloud2 & points);
+  void getVelocity(double stamp, float & v, float & w);
 
   rclcpp::Subscription<PointCloud2>::SharedPtr input_points_sub_;
   rclcpp::Subscription<sensor_msgs::msg::Imu>::SharedPtr imu_sub_;
@@ -81,6 +85,16 @@ private:
   std::string base_link_frame_ = "base_link";
   std::string time_stamp_field_name_;
   bool use_imu_;
+  double time_slice_sec_;
+
+  // Working buffers of the time slice mode, kept across frames to avoid reallocation
+  std::vector<float> xs_;
+  std::vector<float> ys_;
+  std::vector<float> zs_;
+  std::vector<int> slice_indices_;
+  std::vector<tf2::Transform> slice_transforms_;
+
+  friend class DistortionCorrectorTest;  // for test code
 };
 
 }  // namespace pointcloud_preprocessor
@@ -34,10 +34,20 @@ class FasterVoxelGridDownsampleFilter
 public:
   FasterVoxelGridDownsampleFilter();
   void set_voxel_size(float voxel_size_x, float voxel_size_y, float voxel_size_z);
+  // With more than one thread, voxels are sharded by id across threads. Each voxel is still
+  // accumulated by a single thread in input order, so the centroids are identical to the
+  // single-threaded result; only the order of the output points differs.
+  void set_num_threads(int num_threads);
   void set_field_offsets(const PointCloud2ConstPtr & input);
+  void set_field_offsets(const PointCloud2 & input);
   void filter(
     const PointCloud2ConstPtr & input, PointCloud2 & output, const TransformInfo & transform_info,
     const rclcpp::Logger & logger);
+  // `input` and `output` may refer to the same cloud: the centroids are written only after every
+  // input point has been accumulated.
+  void filter(
+    const PointCloud2 & input, PointCloud2 & output, const TransformInfo & transform_info,
+    const rclcpp::Logger & logger);
 
 private:
   struct Centroid
@@ -74,20 +84,33 @@ private:
   int z_offset_;
   int intensity_offset_;
   bool offset_initialized_;
+  int num_threads_;
+
+  // Scratch buffers of the sharded path, kept across frames to avoid reallocation
+  std::vector<uint32_t> voxel_ids_;
+  std::vector<size_t> shard_counts_;
+  std::vector<size_t> shard_offsets_;
+  std::vector<uint32_t> shard_point_indices_;
+  std::vector<std::unordered_map<uint32_t, Centroid>> shard_centroid_maps_;
 
-  Eigen::Vector3f get_point_from_global_offset(
-    const PointCloud2ConstPtr & input, size_t global_offset);
+  Eigen::Vector3f get_point_from_global_offset(const PointCloud2 & input, size_t global_offset);
 
   bool get_min_max_voxel(
-    const PointCloud2ConstPtr & input, Eigen::Vector3i & min_voxel, Eigen::Vector3i & max_voxel);
+    const PointCloud2 & input, Eigen::Vector3i & min_voxel, Eigen::Vector3i & max_voxel);
 
   std::unordered_map<uint32_t, Centroid> calc_centroids_each_voxel(
-    const PointCloud2ConstPtr & input, const Eigen::Vector3i & max_voxel,
+    const PointCloud2 & input, const Eigen::Vector3i & max_voxel,
     const Eigen::Vector3i & min_voxel);
 
+  void calc_centroids_each_voxel_sharded(
+    const PointCloud2 & input, const Eigen::Vector3i & max_voxel,
+    const Eigen::Vector3i & min_voxel);
+
+  void initialize_output(const PointCloud2 & input, size_t num_points, PointCloud2 & output);
+
   void copy_centroids_to_output(
     std::unordered_map<uint32_t, Centroid> & voxel_centroid_map, PointCloud2 & output,
-    const TransformInfo & transform_info);
+    const TransformInfo & transform_info, size_t output_data_offset = 0);
 };
 
 }  // namespace pointcloud_preprocessor
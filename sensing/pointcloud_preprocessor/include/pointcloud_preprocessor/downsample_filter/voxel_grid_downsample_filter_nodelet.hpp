@@ -51,6 +51,7 @@
 #ifndef POINTCLOUD_PREPROCESSOR__DOWNSAMPLE_FILTER__VOXEL_GRID_DOWNSAMPLE_FILTER_NODELET_HPP_
 #define POINTCLOUD_PREPROCESSOR__DOWNSAMPLE_FILTER__VOXEL_GRID_DOWNSAMPLE_FILTER_NODELET_HPP_
 
+#include "pointcloud_preprocessor/downsample_filter/faster_voxel_grid_downsample_filter.hpp"
 #include "pointcloud_preprocessor/filter.hpp"
 #include "pointcloud_preprocessor/transform_info.hpp"
 
@@ -77,6 +78,10 @@ private:
   float voxel_size_x_;
   float voxel_size_y_;
   float voxel_size_z_;
+  int num_threads_;
+
+  // Kept across frames so that the scratch buffers of the sharded path are reused
+  FasterVoxelGridDownsampleFilter faster_voxel_filter_;
 
   /** \brief Parameter service callback result : needed to be hold */
   OnSetParametersCallbackHandle::SharedPtr set_param_res_;
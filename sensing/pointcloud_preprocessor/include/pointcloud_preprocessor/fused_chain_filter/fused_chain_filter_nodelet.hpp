@@ -0,0 +1,94 @@
+// Copyright 2024 TIER IV, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef POINTCLOUD_PREPROCESSOR__FUSED_CHAIN_FILTER__FUSED_CHAIN_FILTER_NODELET_HPP_
+#define POINTCLOUD_PREPROCESSOR__FUSED_CHAIN_FILTER__FUSED_CHAIN_FILTER_NODELET_HPP_
+
+#include "pointcloud_preprocessor/crop_box_filter/crop_box.hpp"
+#include "pointcloud_preprocessor/downsample_filter/faster_voxel_grid_downsample_filter.hpp"
+#include "pointcloud_preprocessor/filter.hpp"
+#include "pointcloud_preprocessor/outlier_filter/ring_outlier.hpp"
+#include "pointcloud_preprocessor/transform_info.hpp"
+
+#include <string>
+#include <vector>
+
+namespace pointcloud_preprocessor
+{
+/** \brief Runs several preprocessing kernels in a single node over one output buffer.
+ *
+ * The input cloud is copied (and transformed to `input_frame` if needed) exactly once into the
+ * output message, then each configured stage compacts the buffer in place. No intermediate
+ * PointCloud2 is allocated or published between stages.
+ */
+class FusedChainFilterComponent : public pointcloud_preprocessor::Filter
+{
+protected:
+  virtual void filter(
+    const PointCloud2ConstPtr & input, const IndicesPtr & indices, PointCloud2 & output);
+
+  // TODO(sykwer): Temporary Implementation: Remove this interface when all the filter nodes conform
+  // to new API
+  virtual void faster_filter(
+    const PointCloud2ConstPtr & input, const IndicesPtr & indices, PointCloud2 & output,
+    const TransformInfo & transform_info);
+
+private:
+  enum class StageType { CROP_BOX, RING_OUTLIER, VOXEL_GRID_DOWNSAMPLE };
+
+  struct Stage
+  {
+    StageType type;
+    std::string name;
+  };
+
+  CropBoxParam crop_box_param_;
+  RingOutlierParam ring_outlier_param_;
+  int ring_outlier_num_threads_;
+
+  struct VoxelGridParam
+  {
+    float voxel_size_x;
+    float voxel_size_y;
+    float voxel_size_z;
+    int num_threads;
+  } voxel_grid_param_;
+
+  std::vector<Stage> stages_;
+
+  // Scratch buffers kept across frames so that the steady state does not allocate
+  RingOutlierFilter ring_outlier_filter_;
+  FasterVoxelGridDownsampleFilter voxel_grid_filter_;
+
+  /** \brief Parameter service callback result : needed to be hold */
+  OnSetParametersCallbackHandle::SharedPtr set_param_res_;
+
+  /** \brief Parameter service callback */
+  rcl_interfaces::msg::SetParametersResult paramCallback(const std::vector<rclcpp::Parameter> & p);
+
+  static StageType toStageType(const std::string & name);
+
+  void copyInput(
+    const PointCloud2 & input, PointCloud2 & output, const TransformInfo & transform_info);
+  void cropBox(PointCloud2 & cloud);
+  void ringOutlier(PointCloud2 & cloud);
+  void voxelGridDownsample(PointCloud2 & cloud);
+
+public:
+  PCL_MAKE_ALIGNED_OPERATOR_NEW
+  explicit FusedChainFilterComponent(const rclcpp::NodeOptions & options);
+};
+}  // namespace pointcloud_preprocessor
+
+#endif  // POINTCLOUD_PREPROCESSOR__FUSED_CHAIN_FILTER__FUSED_CHAIN_FILTER_NODELET_HPP_
@@ -0,0 +1,106 @@
+// Copyright 2024 TIER IV, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef POINTCLOUD_PREPROCESSOR__OUTLIER_FILTER__RING_OUTLIER_HPP_
+#define POINTCLOUD_PREPROCESSOR__OUTLIER_FILTER__RING_OUTLIER_HPP_
+
+#include "autoware_point_types/types.hpp"
+#include "pointcloud_preprocessor/transform_info.hpp"
+
+#include <sensor_msgs/msg/point_cloud2.hpp>
+
+#include <vector>
+
+namespace pointcloud_preprocessor
+{
+struct RingOutlierParam
+{
+  double distance_ratio;
+  double object_length_threshold;
+  int num_points_threshold;
+  uint16_t max_rings_num;
+  size_t max_points_num_per_ring;
+};
+
+/** \brief Ring outlier kernel shared by the ring outlier filter and the fused chain filter.
+ *
+ * The points are grouped by ring and each ring is split into walks of neighboring points. Walks
+ * which are too short are removed. The output is `PointXYZI`, grouped by ring in ring order.
+ */
+class RingOutlierFilter
+{
+  using PointCloud2 = sensor_msgs::msg::PointCloud2;
+  using PointXYZI = autoware_point_types::PointXYZI;
+
+public:
+  void set_param(const RingOutlierParam & param);
+  // Rings are independent of each other, so they are distributed over the threads. The output
+  // does not depend on the number of threads.
+  void set_num_threads(int num_threads);
+  // `input` and `output` may refer to the same cloud: the output is written only after every input
+  // point has been read. The removed points are written to `outlier_points` unless it is null.
+  // The headers of the output clouds are left untouched.
+  void filter(
+    const PointCloud2 & input, PointCloud2 & output, const TransformInfo & transform_info,
+    PointCloud2 * outlier_points = nullptr);
+
+private:
+  /** \brief Per-ring working buffers, kept across frames to avoid reallocation. **/
+  struct RingBuffer
+  {
+    std::vector<size_t> indices;
+    std::vector<float> azimuths;
+    std::vector<float> distances;
+    std::vector<uint8_t> is_walk_end;
+    std::vector<PointXYZI> inliers;
+    std::vector<PointXYZI> outliers;
+
+    void reserve(size_t size)
+    {
+      indices.reserve(size);
+      azimuths.reserve(size);
+      distances.reserve(size);
+      is_walk_end.reserve(size);
+      inliers.reserve(size);
+    }
+
+    void clear()
+    {
+      indices.clear();
+      azimuths.clear();
+      distances.clear();
+      inliers.clear();
+      outliers.clear();
+    }
+  };
+
+  RingOutlierParam param_{};
+  int num_threads_{1};
+  std::vector<RingBuffer> rings_;
+
+  bool isCluster(
+    const PointCloud2 & input, size_t first_data_idx, size_t last_data_idx, int walk_size) const;
+
+  /** \brief Concatenate one buffer of every ring into `merged_points`, in ring order.
+   * \return the merged data size in bytes
+   */
+  size_t mergeRingBuffers(std::vector<PointXYZI> RingBuffer::*buffer, PointCloud2 & merged_points);
+
+  static void setUpPointCloudFormat(
+    const PointCloud2 & input, PointCloud2 & formatted_points, size_t points_size);
+};
+}  // namespace pointcloud_preprocessor
+
+#endif  // POINTCLOUD_PREPROCESSOR__OUTLIER_FILTER__RING_OUTLIER_HPP_
@@ -17,6 +17,7 @@
 
 #include "autoware_point_types/types.hpp"
 #include "pointcloud_preprocessor/filter.hpp"
+#include "pointcloud_preprocessor/outlier_filter/ring_outlier.hpp"
 #include "pointcloud_preprocessor/transform_info.hpp"
 
 #include <point_cloud_msg_wrapper/point_cloud_msg_wrapper.hpp>
@@ -46,12 +47,11 @@ private:
   /** \brief publisher of excluded pointcloud for debug reason. **/
   rclcpp::Publisher<PointCloud2>::SharedPtr outlier_pointcloud_publisher_;
 
-  double distance_ratio_;
-  double object_length_threshold_;
-  int num_points_threshold_;
-  uint16_t max_rings_num_;
-  size_t max_points_num_per_ring_;
+  RingOutlierParam param_;
   bool publish_outlier_pointcloud_;
+  int num_threads_;
+
+  RingOutlierFilter ring_outlier_filter_;
 
   /** \brief Parameter service callback result : needed to be hold */
   OnSetParametersCallbackHandle::SharedPtr set_param_res_;
@@ -59,25 +59,6 @@ private:
   /** \brief Parameter service callback */
   rcl_interfaces::msg::SetParametersResult paramCallback(const std::vector<rclcpp::Parameter> & p);
 
-  bool isCluster(
-    const PointCloud2ConstPtr & input, std::pair<int, int> data_idx_both_ends, int walk_size)
-  {
-    if (walk_size > num_points_threshold_) return true;
-
-    auto first_point = reinterpret_cast<const PointXYZI *>(&input->data[data_idx_both_ends.first]);
-    auto last_point = reinterpret_cast<const PointXYZI *>(&input->data[data_idx_both_ends.second]);
-
-    const auto x = first_point->x - last_point->x;
-    const auto y = first_point->y - last_point->y;
-    const auto z = first_point->z - last_point->z;
-
-    return x * x + y * y + z * z >= object_length_threshold_ * object_length_threshold_;
-  }
-
-  void setUpPointCloudFormat(
-    const PointCloud2ConstPtr & input, PointCloud2 & formatted_points, size_t points_size,
-    size_t num_fields);
-
 public:
   PCL_MAKE_ALIGNED_OPERATOR_NEW
   explicit RingOutlierFilterComponent(const rclcpp::NodeOptions & options);
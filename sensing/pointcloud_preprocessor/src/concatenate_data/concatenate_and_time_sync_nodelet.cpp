@@ -68,6 +68,16 @@
 
 namespace pointcloud_preprocessor
 {
+namespace
+{
+// Name of the debug topic of an input topic, whether the input topic is absolute or relative
+std::string get_input_debug_topic(const std::string & input_topic, const std::string & name)
+{
+  const auto relative_topic = input_topic.rfind('/', 0) == 0 ? input_topic.substr(1) : input_topic;
+  return "debug/" + relative_topic + "/" + name;
+}
+}  // namespace
+
 PointCloudConcatenateDataSynchronizerComponent::PointCloudConcatenateDataSynchronizerComponent(
   const rclcpp::NodeOptions & node_options)
 : Node("point_cloud_concatenator_component", node_options),
@@ -117,6 +127,7 @@ PointCloudConcatenateDataSynchronizerComponent::PointCloudConcatenateDataSynchro
       declare_parameter("keep_input_frame_in_synchronized_pointcloud", true);
     synchronized_pointcloud_postfix_ =
       declare_parameter("synchronized_pointcloud_postfix", "pointcloud");
+    concatenate_on_arrival_ = declare_parameter("concatenate_on_arrival", false);
   }
 
   // Initialize not_subscribed_topic_names_
@@ -156,6 +167,14 @@ PointCloudConcatenateDataSynchronizerComponent::PointCloudConcatenateDataSynchro
     // Subscribe to the filters
     filters_.resize(input_topics_.size());
 
+    // Clouds are transformed in their own callbacks in the on-arrival mode, so let them run
+    // concurrently when the node is spun by a multi-threaded executor.
+    rclcpp::SubscriptionOptions cloud_subscription_options;
+    if (concatenate_on_arrival_) {
+      cloud_callback_group_ = create_callback_group(rclcpp::CallbackGroupType::Reentrant);
+      cloud_subscription_options.callback_group = cloud_callback_group_;
+    }
+
     // First input_topics_.size () filters are valid
     for (size_t d = 0; d < input_topics_.size(); ++d) {
       cloud_stdmap_.insert(std::make_pair(input_topics_[d], nullptr));
@@ -168,7 +187,8 @@ PointCloudConcatenateDataSynchronizerComponent::PointCloudConcatenateDataSynchro
 
       filters_[d].reset();
       filters_[d] = this->create_subscription<sensor_msgs::msg::PointCloud2>(
-        input_topics_[d], rclcpp::SensorDataQoS().keep_last(maximum_queue_size_), cb);
+        input_topics_[d], rclcpp::SensorDataQoS().keep_last(maximum_queue_size_), cb,
+        cloud_subscription_options);
     }
 
     if (input_twist_topic_type_ == "twist") {
@@ -424,18 +444,157 @@ PointCloudConcatenateDataSynchronizerComponent::combineClouds(
   return transformed_clouds;
 }
 
+bool PointCloudConcatenateDataSynchronizerComponent::getTransformMatrix(
+  const std::string & target_frame, const std_msgs::msg::Header & header,
+  Eigen::Matrix4f & eigen_transform)
+{
+  if (header.frame_id == target_frame) {
+    eigen_transform = Eigen::Matrix4f::Identity();
+    return true;
+  }
+
+  try {
+    const auto transform =
+      tf2_buffer_->lookupTransform(target_frame, header.frame_id, tf2_ros::fromMsg(header.stamp));
+    pcl_ros::transformAsMatrix(transform, eigen_transform);
+  } catch (const tf2::TransformException & e) {
+    RCLCPP_ERROR(this->get_logger(), "%s", e.what());
+    return false;
+  }
+  return true;
+}
+
+// `input` must be a PointXYZI cloud. `output_data` must have room for all of its points and may
+// point to the data of `input` itself.
+void PointCloudConcatenateDataSynchronizerComponent::transformXYZICloud(
+  const Eigen::Matrix4f & transform, const PointCloud2 & input, uint8_t * output_data)
+{
+  const size_t num_points = input.data.size() / sizeof(PointXYZI);
+  const auto * input_points = reinterpret_cast<const PointXYZI *>(input.data.data());
+  auto * output_points = reinterpret_cast<PointXYZI *>(output_data);
+  for (size_t i = 0; i < num_points; ++i) {
+    const PointXYZI & p = input_points[i];
+    const float x = transform(0, 0) * p.x + transform(0, 1) * p.y + transform(0, 2) * p.z +
+                    transform(0, 3);
+    const float y = transform(1, 0) * p.x + transform(1, 1) * p.y + transform(1, 2) * p.z +
+                    transform(1, 3);
+    const float z = transform(2, 0) * p.x + transform(2, 1) * p.y + transform(2, 2) * p.z +
+                    transform(2, 3);
+    output_points[i].x = x;
+    output_points[i].y = y;
+    output_points[i].z = z;
+    output_points[i].intensity = p.intensity;
+  }
+}
+
+// Counterpart of combineClouds() for the on-arrival mode. The clouds in cloud_stdmap_ are already
+// XYZI and in the output frame, so only the delay compensation is left: it is applied while copying
+// each cloud into the concatenated cloud, which is allocated once with its final size.
+std::map<std::string, sensor_msgs::msg::PointCloud2::SharedPtr>
+PointCloudConcatenateDataSynchronizerComponent::combineTransformedClouds(
+  sensor_msgs::msg::PointCloud2::SharedPtr & concat_cloud_ptr)
+{
+  // map for storing the transformed point clouds
+  std::map<std::string, sensor_msgs::msg::PointCloud2::SharedPtr> transformed_clouds;
+
+  // Step1. gather stamps and sort it
+  std::vector<rclcpp::Time> pc_stamps;
+  size_t concat_data_size = 0;
+  sensor_msgs::msg::PointCloud2::ConstSharedPtr template_cloud_ptr = nullptr;
+  for (const auto & e : cloud_stdmap_) {
+    transformed_clouds[e.first] = nullptr;
+    if (e.second != nullptr) {
+      if (e.second->data.size() == 0) {
+        continue;
+      }
+      pc_stamps.push_back(rclcpp::Time(e.second->header.stamp));
+      concat_data_size += e.second->data.size();
+      template_cloud_ptr = e.second;
+    }
+  }
+  if (pc_stamps.empty()) {
+    return transformed_clouds;
+  }
+  // sort stamps and get oldest stamp
+  std::sort(pc_stamps.begin(), pc_stamps.end());
+  std::reverse(pc_stamps.begin(), pc_stamps.end());
+  const auto oldest_stamp = pc_stamps.back();
+
+  concat_cloud_ptr = std::make_shared<sensor_msgs::msg::PointCloud2>();
+  concat_cloud_ptr->header.frame_id = output_frame_;
+  concat_cloud_ptr->fields = template_cloud_ptr->fields;
+  concat_cloud_ptr->is_bigendian = template_cloud_ptr->is_bigendian;
+  concat_cloud_ptr->is_dense = template_cloud_ptr->is_dense;
+  concat_cloud_ptr->point_step = sizeof(PointXYZI);
+  concat_cloud_ptr->height = 1;
+  concat_cloud_ptr->data.resize(concat_data_size);
+  concat_cloud_ptr->width = static_cast<uint32_t>(concat_data_size / sizeof(PointXYZI));
+  concat_cloud_ptr->row_step = static_cast<uint32_t>(concat_data_size);
+
+  // Step2. Calculate compensation transform and concatenate with the oldest stamp
+  size_t concat_data_offset = 0;
+  for (const auto & e : cloud_stdmap_) {
+    if (e.second != nullptr) {
+      if (e.second->data.size() == 0) {
+        continue;
+      }
+
+      // calculate transforms to oldest stamp
+      Eigen::Matrix4f adjust_to_old_data_transform = Eigen::Matrix4f::Identity();
+      rclcpp::Time transformed_stamp = rclcpp::Time(e.second->header.stamp);
+      for (const auto & stamp : pc_stamps) {
+        const auto new_to_old_transform =
+          computeTransformToAdjustForOldTimestamp(stamp, transformed_stamp);
+        adjust_to_old_data_transform = new_to_old_transform * adjust_to_old_data_transform;
+        transformed_stamp = std::min(transformed_stamp, stamp);
+      }
+
+      // concatenate
+      transformXYZICloud(
+        adjust_to_old_data_transform, *e.second, &concat_cloud_ptr->data[concat_data_offset]);
+      concat_data_offset += e.second->data.size();
+
+      if (!publish_synchronized_pointcloud_) {
+        continue;
+      }
+
+      // convert to original sensor frame if necessary
+      auto synchronized_cloud_ptr = std::make_shared<sensor_msgs::msg::PointCloud2>(*e.second);
+      bool need_transform_to_sensor_frame = (e.second->header.frame_id != output_frame_);
+      if (keep_input_frame_in_synchronized_pointcloud_ && need_transform_to_sensor_frame) {
+        transformXYZICloud(
+          output_to_input_transform_map_[e.first] * adjust_to_old_data_transform, *e.second,
+          synchronized_cloud_ptr->data.data());
+      } else {
+        transformXYZICloud(
+          adjust_to_old_data_transform, *e.second, synchronized_cloud_ptr->data.data());
+        synchronized_cloud_ptr->header.frame_id = output_frame_;
+      }
+      synchronized_cloud_ptr->header.stamp = oldest_stamp;
+      transformed_clouds[e.first] = synchronized_cloud_ptr;
+
+    } else {
+      not_subscribed_topic_names_.insert(e.first);
+    }
+  }
+  concat_cloud_ptr->header.stamp = oldest_stamp;
+  return transformed_clouds;
+}
+
 void PointCloudConcatenateDataSynchronizerComponent::publish()
 {
   stop_watch_ptr_->toc("processing_time", true);
   sensor_msgs::msg::PointCloud2::SharedPtr concat_cloud_ptr = nullptr;
   not_subscribed_topic_names_.clear();
 
-  const auto & transformed_raw_points =
-    PointCloudConcatenateDataSynchronizerComponent::combineClouds(concat_cloud_ptr);
+  const auto & transformed_raw_points = concatenate_on_arrival_
+                                          ? combineTransformedClouds(concat_cloud_ptr)
+                                          : combineClouds(concat_cloud_ptr);
 
   // publish concatenated pointcloud
   if (concat_cloud_ptr) {
-    auto output = std::make_unique<sensor_msgs::msg::PointCloud2>(*concat_cloud_ptr);
+    // concat_cloud_ptr is not used after this, so the point data is moved rather than copied
+    auto output = std::make_unique<sensor_msgs::msg::PointCloud2>(std::move(*concat_cloud_ptr));
     pub_output_->publish(std::move(output));
   } else {
     RCLCPP_WARN(this->get_logger(), "concat_cloud_ptr is nullptr, skipping pointcloud publish.");
@@ -457,7 +616,23 @@ void PointCloudConcatenateDataSynchronizerComponent::publish()
 
   updater_.force_update();
 
+  // Publish how late each input arrived compared to the first input of this cycle
+  if (debug_publisher_ && !arrival_time_map_.empty()) {
+    const auto first_arrival_time = std::min_element(
+      std::begin(arrival_time_map_), std::end(arrival_time_map_),
+      [](const auto & a, const auto & b) { return a.second < b.second; });
+    for (const auto & e : arrival_time_map_) {
+      const double arrival_skew_ms = (e.second - first_arrival_time->second).seconds() * 1000.0;
+      debug_publisher_->publish<tier4_debug_msgs::msg::Float64Stamped>(
+        get_input_debug_topic(e.first, "arrival_skew_ms"), arrival_skew_ms);
+    }
+  }
+
   cloud_stdmap_ = cloud_stdmap_tmp_;
+  arrival_time_map_ = arrival_time_map_tmp_;
+  arrival_time_map_tmp_.clear();
+  output_to_input_transform_map_ = output_to_input_transform_map_tmp_;
+  output_to_input_transform_map_tmp_.clear();
   std::for_each(std::begin(cloud_stdmap_tmp_), std::end(cloud_stdmap_tmp_), [](auto & e) {
     e.second = nullptr;
   });
@@ -479,7 +654,7 @@ void PointCloudConcatenateDataSynchronizerComponent::publish()
               (this->get_clock()->now() - e.second->header.stamp).nanoseconds()))
             .count();
         debug_publisher_->publish<tier4_debug_msgs::msg::Float64Stamped>(
-          "debug" + e.first + "/pipeline_latency_ms", pipeline_latency_ms);
+          get_input_debug_topic(e.first, "pipeline_latency_ms"), pipeline_latency_ms);
       }
     }
   }
@@ -544,7 +719,10 @@ void PointCloudConcatenateDataSynchronizerComponent::setPeriod(const int64_t new
 void PointCloudConcatenateDataSynchronizerComponent::cloud_callback(
   const sensor_msgs::msg::PointCloud2::ConstSharedPtr & input_ptr, const std::string & topic_name)
 {
-  std::lock_guard<std::mutex> lock(mutex_);
+  const auto arrival_time = this->now();
+
+  // The conversion below only touches this input, so it is done before taking the lock. This lets
+  // the inputs be converted concurrently in the on-arrival mode.
   sensor_msgs::msg::PointCloud2::SharedPtr xyzi_input_ptr(new sensor_msgs::msg::PointCloud2());
   auto input = std::make_shared<sensor_msgs::msg::PointCloud2>(*input_ptr);
   if (input->data.empty()) {
@@ -555,6 +733,22 @@ void PointCloudConcatenateDataSynchronizerComponent::cloud_callback(
     convertToXYZICloud(input, xyzi_input_ptr);
   }
 
+  Eigen::Matrix4f input_to_output_transform = Eigen::Matrix4f::Identity();
+  if (concatenate_on_arrival_ && !xyzi_input_ptr->data.empty()) {
+    if (!getTransformMatrix(output_frame_, input_ptr->header, input_to_output_transform)) {
+      RCLCPP_ERROR(
+        this->get_logger(), "[cloud_callback] Error converting input dataset from %s to %s.",
+        input_ptr->header.frame_id.c_str(), output_frame_.c_str());
+      return;
+    }
+    // Transform in place. The frame_id is kept as the input frame, see combineTransformedClouds().
+    transformXYZICloud(input_to_output_transform, *xyzi_input_ptr, xyzi_input_ptr->data.data());
+  }
+  // Cached with the cloud, since the transform may change before the cloud is published
+  const Eigen::Matrix4f output_to_input_transform = input_to_output_transform.inverse();
+
+  std::lock_guard<std::mutex> lock(mutex_);
+
   const bool is_already_subscribed_this = (cloud_stdmap_[topic_name] != nullptr);
   const bool is_already_subscribed_tmp = std::any_of(
     std::begin(cloud_stdmap_tmp_), std::end(cloud_stdmap_tmp_),
@@ -562,6 +756,8 @@ void PointCloudConcatenateDataSynchronizerComponent::cloud_callback(
 
   if (is_already_subscribed_this) {
     cloud_stdmap_tmp_[topic_name] = xyzi_input_ptr;
+    arrival_time_map_tmp_[topic_name] = arrival_time;
+    output_to_input_transform_map_tmp_[topic_name] = output_to_input_transform;
 
     if (!is_already_subscribed_tmp) {
       auto period = std::chrono::duration_cast<std::chrono::nanoseconds>(
@@ -575,6 +771,8 @@ void PointCloudConcatenateDataSynchronizerComponent::cloud_callback(
     }
   } else {
     cloud_stdmap_[topic_name] = xyzi_input_ptr;
+    arrival_time_map_[topic_name] = arrival_time;
+    output_to_input_transform_map_[topic_name] = output_to_input_transform;
 
     const bool is_subscribed_all = std::all_of(
       std::begin(cloud_stdmap_), std::end(cloud_stdmap_),
@@ -584,8 +782,12 @@ void PointCloudConcatenateDataSynchronizerComponent::cloud_callback(
       for (const auto & e : cloud_stdmap_tmp_) {
         if (e.second != nullptr) {
           cloud_stdmap_[e.first] = e.second;
+          arrival_time_map_[e.first] = arrival_time_map_tmp_[e.first];
+          output_to_input_transform_map_[e.first] = output_to_input_transform_map_tmp_[e.first];
         }
       }
+      arrival_time_map_tmp_.clear();
+      output_to_input_transform_map_tmp_.clear();
       std::for_each(std::begin(cloud_stdmap_tmp_), std::end(cloud_stdmap_tmp_), [](auto & e) {
         e.second = nullptr;
       });
@@ -627,6 +829,9 @@ void PointCloudConcatenateDataSynchronizerComponent::timer_callback()
 void PointCloudConcatenateDataSynchronizerComponent::twist_callback(
   const geometry_msgs::msg::TwistWithCovarianceStamped::ConstSharedPtr input)
 {
+  // twist_ptr_queue_ is read by publish(), which may run on another thread in the on-arrival mode
+  std::lock_guard<std::mutex> lock(mutex_);
+
   // if rosbag restart, clear buffer
   if (!twist_ptr_queue_.empty()) {
     if (rclcpp::Time(twist_ptr_queue_.front()->header.stamp) > rclcpp::Time(input->header.stamp)) {
@@ -653,6 +858,9 @@ void PointCloudConcatenateDataSynchronizerComponent::twist_callback(
 void PointCloudConcatenateDataSynchronizerComponent::odom_callback(
   const nav_msgs::msg::Odometry::ConstSharedPtr input)
 {
+  // twist_ptr_queue_ is read by publish(), which may run on another thread in the on-arrival mode
+  std::lock_guard<std::mutex> lock(mutex_);
+
   // if rosbag restart, clear buffer
   if (!twist_ptr_queue_.empty()) {
     if (rclcpp::Time(twist_ptr_queue_.front()->header.stamp) > rclcpp::Time(input->header.stamp)) {
@@ -0,0 +1,89 @@
+// Copyright 2024 TIER IV, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "pointcloud_preprocessor/crop_box_filter/crop_box.hpp"
+
+#include <pcl/PCLPointField.h>
+#include <pcl_conversions/pcl_conversions.h>
+
+#include <cmath>
+#include <cstring>
+
+namespace pointcloud_preprocessor
+{
+int cropBox(
+  const sensor_msgs::msg::PointCloud2 & input, sensor_msgs::msg::PointCloud2 & output,
+  const CropBoxParam & param, const TransformInfo & transform_info)
+{
+  const int x_offset = input.fields[pcl::getFieldIndex(input, "x")].offset;
+  const int y_offset = input.fields[pcl::getFieldIndex(input, "y")].offset;
+  const int z_offset = input.fields[pcl::getFieldIndex(input, "z")].offset;
+  const uint32_t point_step = input.point_step;
+  const size_t input_size = input.data.size();
+
+  // A point is never written ahead of the one being read, so this also works in place.
+  output.data.resize(input_size);
+  size_t output_size = 0;
+
+  int skipped_count = 0;
+
+  for (size_t global_offset = 0; global_offset + point_step <= input_size;
+       global_offset += point_step) {
+    Eigen::Vector4f point;
+    std::memcpy(&point[0], &input.data[global_offset + x_offset], sizeof(float));
+    std::memcpy(&point[1], &input.data[global_offset + y_offset], sizeof(float));
+    std::memcpy(&point[2], &input.data[global_offset + z_offset], sizeof(float));
+    point[3] = 1;
+
+    if (!std::isfinite(point[0]) || !std::isfinite(point[1]) || !std::isfinite(point[2])) {
+      skipped_count++;
+      continue;
+    }
+
+    if (transform_info.need_transform) {
+      point = transform_info.eigen_transform * point;
+    }
+
+    bool point_is_inside = point[2] > param.min_z && point[2] < param.max_z &&
+                           point[1] > param.min_y && point[1] < param.max_y &&
+                           point[0] > param.min_x && point[0] < param.max_x;
+    if ((!param.negative && point_is_inside) || (param.negative && !point_is_inside)) {
+      if (&output.data[output_size] != &input.data[global_offset]) {
+        std::memmove(&output.data[output_size], &input.data[global_offset], point_step);
+      }
+
+      if (transform_info.need_transform) {
+        std::memcpy(&output.data[output_size + x_offset], &point[0], sizeof(float));
+        std::memcpy(&output.data[output_size + y_offset], &point[1], sizeof(float));
+        std::memcpy(&output.data[output_size + z_offset], &point[2], sizeof(float));
+      }
+
+      output_size += point_step;
+    }
+  }
+
+  output.data.resize(output_size);
+
+  output.height = 1;
+  output.fields = input.fields;
+  output.is_bigendian = input.is_bigendian;
+  output.point_step = point_step;
+  output.is_dense = input.is_dense;
+  output.width = static_cast<uint32_t>(output.data.size() / output.height / output.point_step);
+  output.row_step = static_cast<uint32_t>(output.data.size() / output.height);
+
+  return skipped_count;
+}
+}  // namespace pointcloud_preprocessor
@@ -123,47 +123,7 @@ void CropBoxFilterComponent::faster_filter(
       get_logger(), *get_clock(), 1000, "Indices are not supported and will be ignored");
   }
 
-  int x_offset = input->fields[pcl::getFieldIndex(*input, "x")].offset;
-  int y_offset = input->fields[pcl::getFieldIndex(*input, "y")].offset;
-  int z_offset = input->fields[pcl::getFieldIndex(*input, "z")].offset;
-
-  output.data.resize(input->data.size());
-  size_t output_size = 0;
-
-  int skipped_count = 0;
-
-  for (size_t global_offset = 0; global_offset + input->point_step <= input->data.size();
-       global_offset += input->point_step) {
-    Eigen::Vector4f point;
-    std::memcpy(&point[0], &input->data[global_offset + x_offset], sizeof(float));
-    std::memcpy(&point[1], &input->data[global_offset + y_offset], sizeof(float));
-    std::memcpy(&point[2], &input->data[global_offset + z_offset], sizeof(float));
-    point[3] = 1;
-
-    if (!std::isfinite(point[0]) || !std::isfinite(point[1]) || !std::isfinite(point[2])) {
-      skipped_count++;
-      continue;
-    }
-
-    if (transform_info.need_transform) {
-      point = transform_info.eigen_transform * point;
-    }
-
-    bool point_is_inside = point[2] > param_.min_z && point[2] < param_.max_z &&
-                           point[1] > param_.min_y && point[1] < param_.max_y &&
-                           point[0] > param_.min_x && point[0] < param_.max_x;
-    if ((!param_.negative && point_is_inside) || (param_.negative && !point_is_inside)) {
-      memcpy(&output.data[output_size], &input->data[global_offset], input->point_step);
-
-      if (transform_info.need_transform) {
-        std::memcpy(&output.data[output_size + x_offset], &point[0], sizeof(float));
-        std::memcpy(&output.data[output_size + y_offset], &point[1], sizeof(float));
-        std::memcpy(&output.data[output_size + z_offset], &point[2], sizeof(float));
-      }
-
-      output_size += input->point_step;
-    }
-  }
+  const int skipped_count = cropBox(*input, output, param_, transform_info);
 
   if (skipped_count > 0) {
     RCLCPP_WARN_THROTTLE(
@@ -171,20 +131,10 @@ void CropBoxFilterComponent::faster_filter(
       skipped_count);
   }
 
-  output.data.resize(output_size);
-
   // Note that tf_input_orig_frame_ is the input frame, while tf_input_frame_ is the frame of the
   // crop box
   output.header.frame_id = tf_input_frame_;
 
-  output.height = 1;
-  output.fields = input->fields;
-  output.is_bigendian = input->is_bigendian;
-  output.point_step = input->point_step;
-  output.is_dense = input->is_dense;
-  output.width = static_cast<uint32_t>(output.data.size() / output.height / output.point_step);
-  output.row_step = static_cast<uint32_t>(output.data.size() / output.height);
-
   publishCropBoxPolygon();
 
   // add processing time for debug
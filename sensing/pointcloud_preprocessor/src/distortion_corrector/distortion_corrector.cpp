@@ -16,6 +16,9 @@
 
 #include "tier4_autoware_utils/math/trigonometry.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <deque>
 #include <string>
 #include <utility>
@@ -39,6 +42,7 @@ DistortionCorrectorComponent::DistortionCorrectorComponent(const rclcpp::NodeOpt
   // Parameter
   time_stamp_field_name_ = declare_parameter("time_stamp_field_name", "time_stamp");
   use_imu_ = declare_parameter("use_imu", true);
+  time_slice_sec_ = declare_parameter("time_slice_sec", 0.0);
 
   // Publisher
   undistorted_points_pub_ =
@@ -199,6 +203,10 @@ bool DistortionCorrectorComponent::undistortPointCloud(
     return false;
   }
 
+  if (time_slice_sec_ > 0.0) {
+    return undistortPointCloudWithTimeSlices(tf2_base_link_to_sensor, points);
+  }
+
   sensor_msgs::PointCloud2Iterator<float> it_x(points, "x");
   sensor_msgs::PointCloud2Iterator<float> it_y(points, "y");
   sensor_msgs::PointCloud2Iterator<float> it_z(points, "z");
@@ -317,6 +325,175 @@ bool DistortionCorrectorComponent::undistortPointCloud(
   return true;
 }
 
+void DistortionCorrectorComponent::getVelocity(const double stamp, float & v, float & w)
+{
+  auto twist_it = std::lower_bound(
+    std::begin(twist_queue_), std::end(twist_queue_), stamp,
+    [](const geometry_msgs::msg::TwistStamped & x, const double t) {
+      return rclcpp::Time(x.header.stamp).seconds() < t;
+    });
+  twist_it = twist_it == std::end(twist_queue_) ? std::end(twist_queue_) - 1 : twist_it;
+
+  v = static_cast<float>(twist_it->twist.linear.x);
+  w = static_cast<float>(twist_it->twist.angular.z);
+
+  if (std::abs(stamp - rclcpp::Time(twist_it->header.stamp).seconds()) > 0.1) {
+    RCLCPP_WARN_STREAM_THROTTLE(
+      get_logger(), *get_clock(), 10000 /* ms */,
+      "twist time_stamp is too late. Could not interpolate.");
+    v = 0.0f;
+    w = 0.0f;
+  }
+
+  if (!use_imu_ || angular_velocity_queue_.empty()) {
+    return;
+  }
+
+  auto imu_it = std::lower_bound(
+    std::begin(angular_velocity_queue_), std::end(angular_velocity_queue_), stamp,
+    [](const geometry_msgs::msg::Vector3Stamped & x, const double t) {
+      return rclcpp::Time(x.header.stamp).seconds() < t;
+    });
+  imu_it =
+    imu_it == std::end(angular_velocity_queue_) ? std::end(angular_velocity_queue_) - 1 : imu_it;
+
+  if (std::abs(stamp - rclcpp::Time(imu_it->header.stamp).seconds()) > 0.1) {
+    RCLCPP_WARN_STREAM_THROTTLE(
+      get_logger(), *get_clock(), 10000 /* ms */,
+      "imu time_stamp is too late. Could not interpolate.");
+  } else {
+    w = static_cast<float>(imu_it->vector.z);
+  }
+}
+
+// Instead of integrating the ego motion at every point, the scan is cut into slices of
+// `time_slice_sec_` and one transform is computed per slice. Each point is snapped to the nearest
+// slice boundary, so the position error is bounded by the distance travelled in half a slice.
+bool DistortionCorrectorComponent::undistortPointCloudWithTimeSlices(
+  const tf2::Transform & tf2_base_link_to_sensor, PointCloud2 & points)
+{
+  const auto get_field_offset = [&points](const std::string & name) {
+    const auto field_it = std::find_if(
+      std::cbegin(points.fields), std::cend(points.fields),
+      [&name](const sensor_msgs::msg::PointField & field) { return field.name == name; });
+    return field_it->offset;
+  };
+  const auto x_offset = get_field_offset("x");
+  const auto y_offset = get_field_offset("y");
+  const auto z_offset = get_field_offset("z");
+  const auto time_stamp_offset = get_field_offset(time_stamp_field_name_);
+
+  const size_t num_points = points.data.size() / points.point_step;
+
+  // Gather x/y/z into contiguous arrays and assign each point to its time slice
+  xs_.resize(num_points);
+  ys_.resize(num_points);
+  zs_.resize(num_points);
+  slice_indices_.resize(num_points);
+
+  double first_point_time_stamp_sec{};
+  std::memcpy(&first_point_time_stamp_sec, &points.data[time_stamp_offset], sizeof(double));
+
+  int min_slice = 0;
+  int max_slice = 0;
+  for (size_t i = 0; i < num_points; ++i) {
+    const size_t data_idx = i * points.point_step;
+    double time_stamp_sec{};
+    std::memcpy(&xs_[i], &points.data[data_idx + x_offset], sizeof(float));
+    std::memcpy(&ys_[i], &points.data[data_idx + y_offset], sizeof(float));
+    std::memcpy(&zs_[i], &points.data[data_idx + z_offset], sizeof(float));
+    std::memcpy(&time_stamp_sec, &points.data[data_idx + time_stamp_offset], sizeof(double));
+
+    const int slice = static_cast<int>(
+      std::floor((time_stamp_sec - first_point_time_stamp_sec) / time_slice_sec_ + 0.5));
+    slice_indices_[i] = slice;
+    min_slice = std::min(min_slice, slice);
+    max_slice = std::max(max_slice, slice);
+  }
+
+  // Integrate the ego motion at every slice boundary, starting from the first point's pose in
+  // both directions. Same integration scheme as undistortPointCloud().
+  const int num_slices = max_slice - min_slice + 1;
+  slice_transforms_.resize(num_slices);
+
+  const bool need_transform = points.header.frame_id != base_link_frame_;
+  const tf2::Transform tf2_base_link_to_sensor_inv{tf2_base_link_to_sensor.inverse()};
+
+  const auto set_slice_transform = [&](const int slice, const float theta, const float x,
+                                       const float y) {
+    tf2::Transform baselink_tf_odom{};
+    baselink_tf_odom.setOrigin(tf2::Vector3(x, y, 0.0));
+    baselink_tf_odom.setRotation(tf2::Quaternion(
+      0, 0, tier4_autoware_utils::sin(theta * 0.5f), tier4_autoware_utils::cos(theta * 0.5f)));
+    slice_transforms_[slice - min_slice] =
+      need_transform ? tf2_base_link_to_sensor * baselink_tf_odom * tf2_base_link_to_sensor_inv
+                     : baselink_tf_odom;
+  };
+
+  const auto integrate = [&](const int first_slice, const int last_slice, const int step) {
+    float theta{0.0f};
+    float x{0.0f};
+    float y{0.0f};
+    const auto time_offset = static_cast<float>(step * time_slice_sec_);
+    for (int slice = first_slice; slice != last_slice + step; slice += step) {
+      float v{};
+      float w{};
+      getVelocity(first_point_time_stamp_sec + slice * time_slice_sec_, v, w);
+      theta += w * time_offset;
+      const float dis = v * time_offset;
+      x += dis * tier4_autoware_utils::cos(theta);
+      y += dis * tier4_autoware_utils::sin(theta);
+      set_slice_transform(slice, theta, x, y);
+    }
+  };
+
+  set_slice_transform(0, 0.0f, 0.0f, 0.0f);
+  if (max_slice > 0) integrate(1, max_slice, 1);
+  if (min_slice < 0) integrate(-1, min_slice, -1);
+
+  // Points are stored in scan order, so consecutive points mostly share a slice. Apply each slice
+  // transform to its run of points with a plain loop over the x/y/z arrays.
+  float * xs = xs_.data();
+  float * ys = ys_.data();
+  float * zs = zs_.data();
+  size_t run_begin = 0;
+  while (run_begin < num_points) {
+    const int slice = slice_indices_[run_begin];
+    size_t run_end = run_begin + 1;
+    while (run_end < num_points && slice_indices_[run_end] == slice) {
+      ++run_end;
+    }
+
+    const auto & transform = slice_transforms_[slice - min_slice];
+    const auto & basis = transform.getBasis();
+    const auto & origin = transform.getOrigin();
+    const float r00 = basis[0][0], r01 = basis[0][1], r02 = basis[0][2];
+    const float r10 = basis[1][0], r11 = basis[1][1], r12 = basis[1][2];
+    const float r20 = basis[2][0], r21 = basis[2][1], r22 = basis[2][2];
+    const float t0 = origin.x(), t1 = origin.y(), t2 = origin.z();
+
+    for (size_t i = run_begin; i < run_end; ++i) {
+      const float x = xs[i];
+      const float y = ys[i];
+      const float z = zs[i];
+      xs[i] = r00 * x + r01 * y + r02 * z + t0;
+      ys[i] = r10 * x + r11 * y + r12 * z + t1;
+      zs[i] = r20 * x + r21 * y + r22 * z + t2;
+    }
+
+    run_begin = run_end;
+  }
+
+  for (size_t i = 0; i < num_points; ++i) {
+    const size_t data_idx = i * points.point_step;
+    std::memcpy(&points.data[data_idx + x_offset], &xs_[i], sizeof(float));
+    std::memcpy(&points.data[data_idx + y_offset], &ys_[i], sizeof(float));
+    std::memcpy(&points.data[data_idx + z_offset], &zs_[i], sizeof(float));
+  }
+
+  return true;
+}
+
 }  // namespace pointcloud_preprocessor
 
 #include <rclcpp_components/register_node_macro.hpp>
@@ -14,6 +14,9 @@
 
 #include "pointcloud_preprocessor/downsample_filter/faster_voxel_grid_downsample_filter.hpp"
 
+#include <algorithm>
+#include <limits>
+
 namespace pointcloud_preprocessor
 {
 
@@ -22,6 +25,7 @@ FasterVoxelGridDownsampleFilter::FasterVoxelGridDownsampleFilter()
   pcl::for_each_type<typename pcl::traits::fieldList<pcl::PointXYZ>::type>(
     pcl::detail::FieldAdder<pcl::PointXYZ>(xyz_fields_));
   offset_initialized_ = false;
+  num_threads_ = 1;
 }
 
 void FasterVoxelGridDownsampleFilter::set_voxel_size(
@@ -31,14 +35,24 @@ void FasterVoxelGridDownsampleFilter::set_voxel_size(
     Eigen::Array3f::Ones() / Eigen::Array3f(voxel_size_x, voxel_size_y, voxel_size_z);
 }
 
+void FasterVoxelGridDownsampleFilter::set_num_threads(int num_threads)
+{
+  num_threads_ = std::max(num_threads, 1);
+}
+
 void FasterVoxelGridDownsampleFilter::set_field_offsets(const PointCloud2ConstPtr & input)
 {
-  x_offset_ = input->fields[pcl::getFieldIndex(*input, "x")].offset;
-  y_offset_ = input->fields[pcl::getFieldIndex(*input, "y")].offset;
-  z_offset_ = input->fields[pcl::getFieldIndex(*input, "z")].offset;
-  int intensity_index = pcl::getFieldIndex(*input, "intensity");
+  set_field_offsets(*input);
+}
+
+void FasterVoxelGridDownsampleFilter::set_field_offsets(const PointCloud2 & input)
+{
+  x_offset_ = input.fields[pcl::getFieldIndex(input, "x")].offset;
+  y_offset_ = input.fields[pcl::getFieldIndex(input, "y")].offset;
+  z_offset_ = input.fields[pcl::getFieldIndex(input, "z")].offset;
+  int intensity_index = pcl::getFieldIndex(input, "intensity");
   if (intensity_index != -1) {
-    intensity_offset_ = input->fields[intensity_index].offset;
+    intensity_offset_ = input.fields[intensity_index].offset;
   } else {
     intensity_offset_ = z_offset_ + sizeof(float);
   }
@@ -48,6 +62,13 @@ void FasterVoxelGridDownsampleFilter::set_field_offsets(const PointCloud2ConstPt
 void FasterVoxelGridDownsampleFilter::filter(
   const PointCloud2ConstPtr & input, PointCloud2 & output, const TransformInfo & transform_info,
   const rclcpp::Logger & logger)
+{
+  filter(*input, output, transform_info, logger);
+}
+
+void FasterVoxelGridDownsampleFilter::filter(
+  const PointCloud2 & input, PointCloud2 & output, const TransformInfo & transform_info,
+  const rclcpp::Logger & logger)
 {
   // Check if the field offset has been set
   if (!offset_initialized_) {
@@ -61,7 +82,28 @@ void FasterVoxelGridDownsampleFilter::filter(
       logger,
       "Voxel size is too small for the input dataset. "
       "Integer indices would overflow.");
-    output = *input;
+    if (&output != &input) {
+      output = input;
+    }
+    return;
+  }
+
+  if (num_threads_ > 1) {
+    calc_centroids_each_voxel_sharded(input, max_voxel, min_voxel);
+
+    // Each shard gets a contiguous range of the output
+    std::vector<size_t> shard_offsets(shard_centroid_maps_.size() + 1, 0);
+    for (size_t shard = 0; shard < shard_centroid_maps_.size(); ++shard) {
+      shard_offsets[shard + 1] = shard_offsets[shard] + shard_centroid_maps_[shard].size();
+    }
+    initialize_output(input, shard_offsets.back(), output);
+
+#pragma omp parallel for num_threads(num_threads_) schedule(static, 1)
+    for (size_t shard = 0; shard < shard_centroid_maps_.size(); ++shard) {
+      copy_centroids_to_output(
+        shard_centroid_maps_[shard], output, transform_info,
+        shard_offsets[shard] * output.point_step);
+    }
     return;
   }
 
@@ -69,43 +111,63 @@ void FasterVoxelGridDownsampleFilter::filter(
   auto voxel_centroid_map = calc_centroids_each_voxel(input, max_voxel, min_voxel);
 
   // Initialize the output
-  output.row_step = voxel_centroid_map.size() * input->point_step;
-  output.data.resize(output.row_step);
-  output.width = voxel_centroid_map.size();
-  pcl_conversions::fromPCL(xyz_fields_, output.fields);
-  output.is_dense = true;  // we filter out invalid points
-  output.height = input->height;
-  output.is_bigendian = input->is_bigendian;
-  output.point_step = input->point_step;
-  output.header = input->header;
+  initialize_output(input, voxel_centroid_map.size(), output);
 
   // Copy the centroids to the output
   copy_centroids_to_output(voxel_centroid_map, output, transform_info);
 }
 
+void FasterVoxelGridDownsampleFilter::initialize_output(
+  const PointCloud2 & input, size_t num_points, PointCloud2 & output)
+{
+  // `point_step` is read before `output` is modified since `input` may alias it
+  const auto point_step = input.point_step;
+  output.row_step = num_points * point_step;
+  output.data.resize(output.row_step);
+  output.width = num_points;
+  pcl_conversions::fromPCL(xyz_fields_, output.fields);
+  output.is_dense = true;  // we filter out invalid points
+  output.height = input.height;
+  output.is_bigendian = input.is_bigendian;
+  output.point_step = point_step;
+  output.header = input.header;
+}
+
 Eigen::Vector3f FasterVoxelGridDownsampleFilter::get_point_from_global_offset(
-  const PointCloud2ConstPtr & input, size_t global_offset)
+  const PointCloud2 & input, size_t global_offset)
 {
   Eigen::Vector3f point(
-    *reinterpret_cast<const float *>(&input->data[global_offset + x_offset_]),
-    *reinterpret_cast<const float *>(&input->data[global_offset + y_offset_]),
-    *reinterpret_cast<const float *>(&input->data[global_offset + z_offset_]));
+    *reinterpret_cast<const float *>(&input.data[global_offset + x_offset_]),
+    *reinterpret_cast<const float *>(&input.data[global_offset + y_offset_]),
+    *reinterpret_cast<const float *>(&input.data[global_offset + z_offset_]));
   return point;
 }
 
 bool FasterVoxelGridDownsampleFilter::get_min_max_voxel(
-  const PointCloud2ConstPtr & input, Eigen::Vector3i & min_voxel, Eigen::Vector3i & max_voxel)
+  const PointCloud2 & input, Eigen::Vector3i & min_voxel, Eigen::Vector3i & max_voxel)
 {
   // Compute the minimum and maximum point coordinates
   Eigen::Vector3f min_point, max_point;
   min_point.setConstant(FLT_MAX);
   max_point.setConstant(-FLT_MAX);
-  for (size_t global_offset = 0; global_offset + input->point_step <= input->data.size();
-       global_offset += input->point_step) {
-    Eigen::Vector3f point = get_point_from_global_offset(input, global_offset);
-    if (std::isfinite(point[0]) && std::isfinite(point[1]), std::isfinite(point[2])) {
-      min_point = min_point.cwiseMin(point);
-      max_point = max_point.cwiseMax(point);
+  const size_t num_points = input.point_step > 0 ? input.data.size() / input.point_step : 0;
+#pragma omp parallel num_threads(num_threads_) if (num_threads_ > 1)
+  {
+    Eigen::Vector3f local_min_point, local_max_point;
+    local_min_point.setConstant(FLT_MAX);
+    local_max_point.setConstant(-FLT_MAX);
+#pragma omp for nowait
+    for (size_t i = 0; i < num_points; ++i) {
+      Eigen::Vector3f point = get_point_from_global_offset(input, i * input.point_step);
+      if (std::isfinite(point[0]) && std::isfinite(point[1]) && std::isfinite(point[2])) {
+        local_min_point = local_min_point.cwiseMin(point);
+        local_max_point = local_max_point.cwiseMax(point);
+      }
+    }
+#pragma omp critical
+    {
+      min_point = min_point.cwiseMin(local_min_point);
+      max_point = max_point.cwiseMax(local_max_point);
     }
   }
 
@@ -131,7 +193,7 @@ bool FasterVoxelGridDownsampleFilter::get_min_max_voxel(
 
 std::unordered_map<uint32_t, FasterVoxelGridDownsampleFilter::Centroid>
 FasterVoxelGridDownsampleFilter::calc_centroids_each_voxel(
-  const PointCloud2ConstPtr & input, const Eigen::Vector3i & max_voxel,
+  const PointCloud2 & input, const Eigen::Vector3i & max_voxel,
   const Eigen::Vector3i & min_voxel)
 {
   std::unordered_map<uint32_t, Centroid> voxel_centroid_map;
@@ -140,10 +202,10 @@ FasterVoxelGridDownsampleFilter::calc_centroids_each_voxel(
   // Set up the division multiplier
   Eigen::Vector3i div_b_mul(1, div_b[0], div_b[0] * div_b[1]);
 
-  for (size_t global_offset = 0; global_offset + input->point_step <= input->data.size();
-       global_offset += input->point_step) {
+  for (size_t global_offset = 0; global_offset + input.point_step <= input.data.size();
+       global_offset += input.point_step) {
     Eigen::Vector3f point = get_point_from_global_offset(input, global_offset);
-    if (std::isfinite(point[0]) && std::isfinite(point[1]), std::isfinite(point[2])) {
+    if (std::isfinite(point[0]) && std::isfinite(point[1]) && std::isfinite(point[2])) {
       // Calculate the voxel index to which the point belongs
       int ijk0 = static_cast<int>(std::floor(point[0] * inverse_voxel_size_[0]) - min_voxel[0]);
       int ijk1 = static_cast<int>(std::floor(point[1] * inverse_voxel_size_[1]) - min_voxel[1]);
@@ -162,11 +224,98 @@ FasterVoxelGridDownsampleFilter::calc_centroids_each_voxel(
   return voxel_centroid_map;
 }
 
+void FasterVoxelGridDownsampleFilter::calc_centroids_each_voxel_sharded(
+  const PointCloud2 & input, const Eigen::Vector3i & max_voxel,
+  const Eigen::Vector3i & min_voxel)
+{
+  // Voxel id that no valid point can have, since the voxel count is checked to fit in int32
+  constexpr uint32_t invalid_voxel_id = std::numeric_limits<uint32_t>::max();
+
+  // Compute the number of divisions needed along all axis
+  Eigen::Vector3i div_b = max_voxel - min_voxel + Eigen::Vector3i::Ones();
+  // Set up the division multiplier
+  Eigen::Vector3i div_b_mul(1, div_b[0], div_b[0] * div_b[1]);
+
+  // The points are split into one contiguous chunk per thread. Each chunk computes the voxel ids of
+  // its points and counts them by shard.
+  const size_t num_points = input.data.size() / input.point_step;
+  const size_t num_shards = static_cast<size_t>(num_threads_);
+  const size_t num_chunks = num_shards;
+  const size_t chunk_size = (num_points + num_chunks - 1) / num_chunks;
+  voxel_ids_.resize(num_points);
+  shard_counts_.assign(num_chunks * num_shards, 0);
+#pragma omp parallel for num_threads(num_threads_) schedule(static, 1)
+  for (size_t chunk = 0; chunk < num_chunks; ++chunk) {
+    size_t * counts = &shard_counts_[chunk * num_shards];
+    const size_t end = std::min(num_points, (chunk + 1) * chunk_size);
+    for (size_t i = chunk * chunk_size; i < end; ++i) {
+      Eigen::Vector3f point = get_point_from_global_offset(input, i * input.point_step);
+      if (std::isfinite(point[0]) && std::isfinite(point[1]) && std::isfinite(point[2])) {
+        int ijk0 = static_cast<int>(std::floor(point[0] * inverse_voxel_size_[0]) - min_voxel[0]);
+        int ijk1 = static_cast<int>(std::floor(point[1] * inverse_voxel_size_[1]) - min_voxel[1]);
+        int ijk2 = static_cast<int>(std::floor(point[2] * inverse_voxel_size_[2]) - min_voxel[2]);
+        const uint32_t voxel_id = ijk0 * div_b_mul[0] + ijk1 * div_b_mul[1] + ijk2 * div_b_mul[2];
+        voxel_ids_[i] = voxel_id;
+        ++counts[voxel_id % num_shards];
+      } else {
+        voxel_ids_[i] = invalid_voxel_id;
+      }
+    }
+  }
+
+  // Prefix sum over (shard, chunk), so that the points of a shard are contiguous and stay in input
+  // order. shard_counts_ now holds the first slot of each chunk in each shard.
+  shard_offsets_.resize(num_shards + 1);
+  size_t offset = 0;
+  for (size_t shard = 0; shard < num_shards; ++shard) {
+    shard_offsets_[shard] = offset;
+    for (size_t chunk = 0; chunk < num_chunks; ++chunk) {
+      const size_t count = shard_counts_[chunk * num_shards + shard];
+      shard_counts_[chunk * num_shards + shard] = offset;
+      offset += count;
+    }
+  }
+  shard_offsets_[num_shards] = offset;
+
+  // Scatter the point indices to their shards
+  shard_point_indices_.resize(offset);
+#pragma omp parallel for num_threads(num_threads_) schedule(static, 1)
+  for (size_t chunk = 0; chunk < num_chunks; ++chunk) {
+    size_t * slots = &shard_counts_[chunk * num_shards];
+    const size_t end = std::min(num_points, (chunk + 1) * chunk_size);
+    for (size_t i = chunk * chunk_size; i < end; ++i) {
+      const uint32_t voxel_id = voxel_ids_[i];
+      if (voxel_id == invalid_voxel_id) continue;
+      shard_point_indices_[slots[voxel_id % num_shards]++] = i;
+    }
+  }
+
+  // Each shard owns the voxels whose id maps to it and walks only its own points in input order,
+  // so the sums of every voxel are accumulated in the same order as in calc_centroids_each_voxel
+  shard_centroid_maps_.resize(num_shards);
+#pragma omp parallel for num_threads(num_threads_) schedule(static, 1)
+  for (size_t shard = 0; shard < num_shards; ++shard) {
+    auto & voxel_centroid_map = shard_centroid_maps_[shard];
+    voxel_centroid_map.clear();
+    for (size_t j = shard_offsets_[shard]; j < shard_offsets_[shard + 1]; ++j) {
+      const size_t i = shard_point_indices_[j];
+      const uint32_t voxel_id = voxel_ids_[i];
+      Eigen::Vector3f point = get_point_from_global_offset(input, i * input.point_step);
+      auto it = voxel_centroid_map.find(voxel_id);
+      if (it == voxel_centroid_map.end()) {
+        voxel_centroid_map.emplace(voxel_id, Centroid(point[0], point[1], point[2]));
+      } else {
+        it->second.add_point(point[0], point[1], point[2]);
+      }
+    }
+  }
+}
+
 void FasterVoxelGridDownsampleFilter::copy_centroids_to_output(
   std::unordered_map<uint32_t, Centroid> & voxel_centroid_map, PointCloud2 & output,
-  const TransformInfo & transform_info)
+  const TransformInfo & transform_info, size_t output_data_offset)
 {
-  size_t output_data_size = 0;
+  size_t output_data_size = output_data_offset;
   for (const auto & pair : voxel_centroid_map) {
     Eigen::Vector4f centroid = pair.second.calc_centroid();
     if (transform_info.need_transform) {
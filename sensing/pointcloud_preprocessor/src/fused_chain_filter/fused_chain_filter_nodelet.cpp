@@ -0,0 +1,307 @@
+// Copyright 2024 TIER IV, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "pointcloud_preprocessor/fused_chain_filter/fused_chain_filter_nodelet.hpp"
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace pointcloud_preprocessor
+{
+FusedChainFilterComponent::FusedChainFilterComponent(const rclcpp::NodeOptions & options)
+: Filter("FusedChainFilter", options)
+{
+  // initialize debug tool
+  {
+    using tier4_autoware_utils::DebugPublisher;
+    using tier4_autoware_utils::StopWatch;
+    stop_watch_ptr_ = std::make_unique<StopWatch<std::chrono::milliseconds>>();
+    debug_publisher_ = std::make_unique<DebugPublisher>(this, "fused_chain_filter");
+    stop_watch_ptr_->tic("cyclic_time");
+    stop_watch_ptr_->tic("processing_time");
+    stop_watch_ptr_->tic("stage_time");
+  }
+
+  // set initial parameters
+  {
+    const auto stage_names = declare_parameter<std::vector<std::string>>(
+      "stages", std::vector<std::string>{"crop_box", "ring_outlier"});
+
+    // The ring outlier kernel reads ring/azimuth/distance fields, which are dropped by the ring
+    // outlier and voxel grid stages themselves.
+    bool keeps_ring_fields = true;
+    for (const auto & name : stage_names) {
+      const auto type = toStageType(name);
+      if (type == StageType::RING_OUTLIER && !keeps_ring_fields) {
+        throw std::invalid_argument(
+          "ring_outlier stage must not follow ring_outlier or voxel_grid_downsample stages");
+      }
+      if (type != StageType::CROP_BOX) {
+        keeps_ring_fields = false;
+      }
+      stages_.push_back(Stage{type, name});
+    }
+
+    auto & crop_box = crop_box_param_;
+    crop_box.min_x = static_cast<float>(declare_parameter("crop_box.min_x", -1.0));
+    crop_box.min_y = static_cast<float>(declare_parameter("crop_box.min_y", -1.0));
+    crop_box.min_z = static_cast<float>(declare_parameter("crop_box.min_z", -1.0));
+    crop_box.max_x = static_cast<float>(declare_parameter("crop_box.max_x", 1.0));
+    crop_box.max_y = static_cast<float>(declare_parameter("crop_box.max_y", 1.0));
+    crop_box.max_z = static_cast<float>(declare_parameter("crop_box.max_z", 1.0));
+    crop_box.negative = static_cast<bool>(declare_parameter("crop_box.negative", false));
+
+    auto & ring_outlier = ring_outlier_param_;
+    ring_outlier.distance_ratio =
+      static_cast<double>(declare_parameter("ring_outlier.distance_ratio", 1.03));
+    ring_outlier.object_length_threshold =
+      static_cast<double>(declare_parameter("ring_outlier.object_length_threshold", 0.1));
+    ring_outlier.num_points_threshold =
+      static_cast<int>(declare_parameter("ring_outlier.num_points_threshold", 4));
+    ring_outlier.max_rings_num =
+      static_cast<uint16_t>(declare_parameter("ring_outlier.max_rings_num", 128));
+    ring_outlier.max_points_num_per_ring =
+      static_cast<size_t>(declare_parameter("ring_outlier.max_points_num_per_ring", 4000));
+    ring_outlier_num_threads_ =
+      static_cast<int>(declare_parameter("ring_outlier.num_threads", 1));
+
+    auto & voxel_grid = voxel_grid_param_;
+    voxel_grid.voxel_size_x =
+      static_cast<float>(declare_parameter("voxel_grid_downsample.voxel_size_x", 0.3));
+    voxel_grid.voxel_size_y =
+      static_cast<float>(declare_parameter("voxel_grid_downsample.voxel_size_y", 0.3));
+    voxel_grid.voxel_size_z =
+      static_cast<float>(declare_parameter("voxel_grid_downsample.voxel_size_z", 0.1));
+    voxel_grid.num_threads =
+      static_cast<int>(declare_parameter("voxel_grid_downsample.num_threads", 1));
+  }
+
+  ring_outlier_filter_.set_param(ring_outlier_param_);
+
+  using std::placeholders::_1;
+  set_param_res_ = this->add_on_set_parameters_callback(
+    std::bind(&FusedChainFilterComponent::paramCallback, this, _1));
+}
+
+FusedChainFilterComponent::StageType FusedChainFilterComponent::toStageType(
+  const std::string & name)
+{
+  if (name == "crop_box") return StageType::CROP_BOX;
+  if (name == "ring_outlier") return StageType::RING_OUTLIER;
+  if (name == "voxel_grid_downsample") return StageType::VOXEL_GRID_DOWNSAMPLE;
+  throw std::invalid_argument("Unknown fused chain stage: " + name);
+}
+
+// TODO(sykwer): Temporary Implementation: Delete this function definition when all the filter nodes
+// conform to new API.
+void FusedChainFilterComponent::filter(
+  const PointCloud2ConstPtr & input, const IndicesPtr & indices, PointCloud2 & output)
+{
+  (void)input;
+  (void)indices;
+  (void)output;
+}
+
+// TODO(sykwer): Temporary Implementation: Rename this function to `filter()` when all the filter
+// nodes conform to new API. Then delete the old `filter()` defined above.
+void FusedChainFilterComponent::faster_filter(
+  const PointCloud2ConstPtr & input, const IndicesPtr & indices, PointCloud2 & output,
+  const TransformInfo & transform_info)
+{
+  std::scoped_lock lock(mutex_);
+  stop_watch_ptr_->toc("processing_time", true);
+
+  if (indices) {
+    RCLCPP_WARN_THROTTLE(
+      get_logger(), *get_clock(), 1000, "Indices are not supported and will be ignored");
+  }
+
+  // This is the only copy of the point data in the whole chain. Every stage below works in place.
+  stop_watch_ptr_->toc("stage_time", true);
+  copyInput(*input, output, transform_info);
+  if (debug_publisher_) {
+    debug_publisher_->publish<tier4_debug_msgs::msg::Float64Stamped>(
+      "debug/copy_input/processing_time_ms", stop_watch_ptr_->toc("stage_time", true));
+  }
+
+  for (const auto & stage : stages_) {
+    switch (stage.type) {
+      case StageType::CROP_BOX:
+        cropBox(output);
+        break;
+      case StageType::RING_OUTLIER:
+        ringOutlier(output);
+        break;
+      case StageType::VOXEL_GRID_DOWNSAMPLE:
+        voxelGridDownsample(output);
+        break;
+    }
+
+    if (debug_publisher_) {
+      debug_publisher_->publish<tier4_debug_msgs::msg::Float64Stamped>(
+        "debug/" + stage.name + "/processing_time_ms", stop_watch_ptr_->toc("stage_time", true));
+    }
+  }
+
+  // add processing time for debug
+  if (debug_publisher_) {
+    const double cyclic_time_ms = stop_watch_ptr_->toc("cyclic_time", true);
+    const double processing_time_ms = stop_watch_ptr_->toc("processing_time", true);
+    debug_publisher_->publish<tier4_debug_msgs::msg::Float64Stamped>(
+      "debug/cyclic_time_ms", cyclic_time_ms);
+    debug_publisher_->publish<tier4_debug_msgs::msg::Float64Stamped>(
+      "debug/processing_time_ms", processing_time_ms);
+
+    auto pipeline_latency_ms =
+      std::chrono::duration<double, std::milli>(
+        std::chrono::nanoseconds((this->get_clock()->now() - input->header.stamp).nanoseconds()))
+        .count();
+
+    debug_publisher_->publish<tier4_debug_msgs::msg::Float64Stamped>(
+      "debug/pipeline_latency_ms", pipeline_latency_ms);
+  }
+}
+
+void FusedChainFilterComponent::copyInput(
+  const PointCloud2 & input, PointCloud2 & output, const TransformInfo & transform_info)
+{
+  output.header = input.header;
+  // Note that `input.header.frame_id` is data before converted when `transform_info.need_transform
+  // == true`
+  output.header.frame_id = !tf_input_frame_.empty() ? tf_input_frame_ : tf_input_orig_frame_;
+  output.height = 1;
+  output.fields = input.fields;
+  output.is_bigendian = input.is_bigendian;
+  output.point_step = input.point_step;
+  output.is_dense = input.is_dense;
+  output.data = input.data;
+  output.width = static_cast<uint32_t>(output.data.size() / output.point_step);
+  output.row_step = static_cast<uint32_t>(output.data.size());
+
+  if (!transform_info.need_transform) return;
+
+  const int x_offset = output.fields[pcl::getFieldIndex(output, "x")].offset;
+  const int y_offset = output.fields[pcl::getFieldIndex(output, "y")].offset;
+  const int z_offset = output.fields[pcl::getFieldIndex(output, "z")].offset;
+
+  for (size_t global_offset = 0; global_offset + output.point_step <= output.data.size();
+       global_offset += output.point_step) {
+    Eigen::Vector4f point;
+    std::memcpy(&point[0], &output.data[global_offset + x_offset], sizeof(float));
+    std::memcpy(&point[1], &output.data[global_offset + y_offset], sizeof(float));
+    std::memcpy(&point[2], &output.data[global_offset + z_offset], sizeof(float));
+    point[3] = 1;
+
+    point = transform_info.eigen_transform * point;
+
+    std::memcpy(&output.data[global_offset + x_offset], &point[0], sizeof(float));
+    std::memcpy(&output.data[global_offset + y_offset], &point[1], sizeof(float));
+    std::memcpy(&output.data[global_offset + z_offset], &point[2], sizeof(float));
+  }
+}
+
+void FusedChainFilterComponent::cropBox(PointCloud2 & cloud)
+{
+  // The points are already in the target frame, see copyInput().
+  const int skipped_count =
+    pointcloud_preprocessor::cropBox(cloud, cloud, crop_box_param_, TransformInfo());
+
+  if (skipped_count > 0) {
+    RCLCPP_WARN_THROTTLE(
+      get_logger(), *get_clock(), 1000, "%d points contained NaN values and have been ignored",
+      skipped_count);
+  }
+}
+
+void FusedChainFilterComponent::ringOutlier(PointCloud2 & cloud)
+{
+  ring_outlier_filter_.set_num_threads(ring_outlier_num_threads_);
+  // The points are already in the target frame, see copyInput().
+  ring_outlier_filter_.filter(cloud, cloud, TransformInfo());
+}
+
+void FusedChainFilterComponent::voxelGridDownsample(PointCloud2 & cloud)
+{
+  const auto & p = voxel_grid_param_;
+  voxel_grid_filter_.set_voxel_size(p.voxel_size_x, p.voxel_size_y, p.voxel_size_z);
+  voxel_grid_filter_.set_num_threads(p.num_threads);
+  // The field layout depends on the preceding stages, so it is refreshed every frame.
+  voxel_grid_filter_.set_field_offsets(cloud);
+  // The points are already in the target frame, see copyInput().
+  voxel_grid_filter_.filter(cloud, cloud, TransformInfo(), get_logger());
+}
+
+rcl_interfaces::msg::SetParametersResult FusedChainFilterComponent::paramCallback(
+  const std::vector<rclcpp::Parameter> & p)
+{
+  std::scoped_lock lock(mutex_);
+
+  CropBoxParam new_crop_box_param{};
+  if (
+    get_param(p, "crop_box.min_x", new_crop_box_param.min_x) &&
+    get_param(p, "crop_box.min_y", new_crop_box_param.min_y) &&
+    get_param(p, "crop_box.min_z", new_crop_box_param.min_z) &&
+    get_param(p, "crop_box.max_x", new_crop_box_param.max_x) &&
+    get_param(p, "crop_box.max_y", new_crop_box_param.max_y) &&
+    get_param(p, "crop_box.max_z", new_crop_box_param.max_z) &&
+    get_param(p, "crop_box.negative", new_crop_box_param.negative)) {
+    crop_box_param_ = new_crop_box_param;
+    RCLCPP_DEBUG(get_logger(), "Setting new crop box parameters.");
+  }
+
+  auto & ring_outlier = ring_outlier_param_;
+  if (get_param(p, "ring_outlier.distance_ratio", ring_outlier.distance_ratio)) {
+    RCLCPP_DEBUG(get_logger(), "Setting new distance ratio to: %f.", ring_outlier.distance_ratio);
+  }
+  if (get_param(p, "ring_outlier.object_length_threshold", ring_outlier.object_length_threshold)) {
+    RCLCPP_DEBUG(
+      get_logger(), "Setting new object length threshold to: %f.",
+      ring_outlier.object_length_threshold);
+  }
+  if (get_param(p, "ring_outlier.num_points_threshold", ring_outlier.num_points_threshold)) {
+    RCLCPP_DEBUG(
+      get_logger(), "Setting new num_points_threshold to: %d.", ring_outlier.num_points_threshold);
+  }
+  if (get_param(p, "ring_outlier.num_threads", ring_outlier_num_threads_)) {
+    RCLCPP_DEBUG(get_logger(), "Setting new num_threads to: %d.", ring_outlier_num_threads_);
+  }
+  ring_outlier_filter_.set_param(ring_outlier);
+
+  auto & voxel_grid = voxel_grid_param_;
+  if (get_param(p, "voxel_grid_downsample.voxel_size_x", voxel_grid.voxel_size_x)) {
+    RCLCPP_DEBUG(get_logger(), "Setting new voxel_size_x to: %f.", voxel_grid.voxel_size_x);
+  }
+  if (get_param(p, "voxel_grid_downsample.voxel_size_y", voxel_grid.voxel_size_y)) {
+    RCLCPP_DEBUG(get_logger(), "Setting new voxel_size_y to: %f.", voxel_grid.voxel_size_y);
+  }
+  if (get_param(p, "voxel_grid_downsample.voxel_size_z", voxel_grid.voxel_size_z)) {
+    RCLCPP_DEBUG(get_logger(), "Setting new voxel_size_z to: %f.", voxel_grid.voxel_size_z);
+  }
+  if (get_param(p, "voxel_grid_downsample.num_threads", voxel_grid.num_threads)) {
+    RCLCPP_DEBUG(get_logger(), "Setting new num_threads to: %d.", voxel_grid.num_threads);
+  }
+
+  rcl_interfaces::msg::SetParametersResult result;
+  result.successful = true;
+  result.reason = "success";
+
+  return result;
+}
+
+}  // namespace pointcloud_preprocessor
+
+#include <rclcpp_components/register_node_macro.hpp>
+RCLCPP_COMPONENTS_REGISTER_NODE(pointcloud_preprocessor::FusedChainFilterComponent)
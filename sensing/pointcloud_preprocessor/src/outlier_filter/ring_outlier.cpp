@@ -0,0 +1,198 @@
+// Copyright 2024 TIER IV, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "pointcloud_preprocessor/outlier_filter/ring_outlier.hpp"
+
+#include <sensor_msgs/point_cloud2_iterator.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace pointcloud_preprocessor
+{
+void RingOutlierFilter::set_param(const RingOutlierParam & param)
+{
+  param_ = param;
+  rings_.resize(param_.max_rings_num);
+  for (auto & ring : rings_) {
+    ring.reserve(param_.max_points_num_per_ring);
+  }
+}
+
+void RingOutlierFilter::set_num_threads(int num_threads)
+{
+  num_threads_ = std::max(num_threads, 1);
+}
+
+void RingOutlierFilter::filter(
+  const PointCloud2 & input, PointCloud2 & output, const TransformInfo & transform_info,
+  PointCloud2 * outlier_points)
+{
+  const auto ring_offset =
+    input.fields.at(static_cast<size_t>(autoware_point_types::PointIndex::Ring)).offset;
+  const auto azimuth_offset =
+    input.fields.at(static_cast<size_t>(autoware_point_types::PointIndex::Azimuth)).offset;
+  const auto distance_offset =
+    input.fields.at(static_cast<size_t>(autoware_point_types::PointIndex::Distance)).offset;
+  const auto intensity_offset =
+    input.fields.at(static_cast<size_t>(autoware_point_types::PointIndex::Intensity)).offset;
+
+  // Bucket the points by ring. Azimuth and distance are gathered into contiguous per-ring arrays
+  // here so that the walk detection below runs over plain float arrays.
+  for (auto & ring : rings_) {
+    ring.clear();
+  }
+  for (size_t data_idx = 0; data_idx < input.data.size(); data_idx += input.point_step) {
+    const uint16_t ring = *reinterpret_cast<const uint16_t *>(&input.data[data_idx + ring_offset]);
+    if (ring >= rings_.size()) continue;
+    auto & ring_data = rings_[ring];
+    ring_data.indices.push_back(data_idx);
+    ring_data.azimuths.push_back(
+      *reinterpret_cast<const float *>(&input.data[data_idx + azimuth_offset]));
+    ring_data.distances.push_back(
+      *reinterpret_cast<const float *>(&input.data[data_idx + distance_offset]));
+  }
+
+  const auto to_output_point = [&](const size_t data_idx) {
+    PointXYZI point = *reinterpret_cast<const PointXYZI *>(&input.data[data_idx]);
+    if (transform_info.need_transform) {
+      const auto & m = transform_info.eigen_transform;
+      const float x = point.x;
+      const float y = point.y;
+      const float z = point.z;
+      point.x = m(0, 0) * x + m(0, 1) * y + m(0, 2) * z + m(0, 3);
+      point.y = m(1, 0) * x + m(1, 1) * y + m(1, 2) * z + m(1, 3);
+      point.z = m(2, 0) * x + m(2, 1) * y + m(2, 2) * z + m(2, 3);
+    }
+    point.intensity = *reinterpret_cast<const float *>(&input.data[data_idx + intensity_offset]);
+    return point;
+  };
+
+  // Rings are independent of each other, so each one is processed by a single thread and writes
+  // only to its own buffers.
+  const int rings_num = static_cast<int>(rings_.size());
+#pragma omp parallel for num_threads(num_threads_) schedule(dynamic)
+  for (int ring_idx = 0; ring_idx < rings_num; ++ring_idx) {
+    auto & ring = rings_[ring_idx];
+    const auto & indices = ring.indices;
+    if (indices.size() < 2) continue;
+
+    // is_walk_end[i] is true when points i and i + 1 do not belong to the same walk
+    const size_t num_pairs = indices.size() - 1;
+    ring.is_walk_end.resize(num_pairs);
+    const float * azimuths = ring.azimuths.data();
+    const float * distances = ring.distances.data();
+    for (size_t idx = 0U; idx < num_pairs; ++idx) {
+      float azimuth_diff = azimuths[idx + 1] - azimuths[idx];
+      azimuth_diff = azimuth_diff < 0.f ? azimuth_diff + 36000.f : azimuth_diff;
+      const float max_distance = std::max(distances[idx], distances[idx + 1]);
+      const float min_distance = std::min(distances[idx], distances[idx + 1]);
+      ring.is_walk_end[idx] =
+        !(max_distance < min_distance * param_.distance_ratio && azimuth_diff < 100.f);
+    }
+
+    const auto flush_walk = [&](const int walk_first_idx, const int walk_last_idx) {
+      if (isCluster(
+            input, indices[walk_first_idx], indices[walk_last_idx],
+            walk_last_idx - walk_first_idx + 1)) {
+        for (int i = walk_first_idx; i <= walk_last_idx; i++) {
+          ring.inliers.push_back(to_output_point(indices[i]));
+        }
+      } else if (outlier_points) {
+        for (int i = walk_first_idx; i <= walk_last_idx; i++) {
+          ring.outliers.push_back(to_output_point(indices[i]));
+        }
+      }
+    };
+
+    // walk range: [walk_first_idx, walk_last_idx]
+    int walk_first_idx = 0;
+    const int walk_last_idx = static_cast<int>(num_pairs) - 1;
+    for (int idx = 0; idx <= walk_last_idx; ++idx) {
+      if (!ring.is_walk_end[idx]) continue;  // Determined to be included in the same walk
+      flush_walk(walk_first_idx, idx);
+      walk_first_idx = idx + 1;
+    }
+
+    if (walk_first_idx > walk_last_idx) continue;
+
+    flush_walk(walk_first_idx, walk_last_idx);
+  }
+
+  // Every input point has been copied to the ring buffers, so `output` may now overwrite `input`.
+  const size_t output_size = mergeRingBuffers(&RingBuffer::inliers, output);
+  setUpPointCloudFormat(input, output, output_size);
+
+  if (outlier_points) {
+    const size_t outlier_points_size = mergeRingBuffers(&RingBuffer::outliers, *outlier_points);
+    setUpPointCloudFormat(input, *outlier_points, outlier_points_size);
+  }
+}
+
+bool RingOutlierFilter::isCluster(
+  const PointCloud2 & input, size_t first_data_idx, size_t last_data_idx, int walk_size) const
+{
+  if (walk_size > param_.num_points_threshold) return true;
+
+  auto first_point = reinterpret_cast<const PointXYZI *>(&input.data[first_data_idx]);
+  auto last_point = reinterpret_cast<const PointXYZI *>(&input.data[last_data_idx]);
+
+  const auto x = first_point->x - last_point->x;
+  const auto y = first_point->y - last_point->y;
+  const auto z = first_point->z - last_point->z;
+
+  return x * x + y * y + z * z >= param_.object_length_threshold * param_.object_length_threshold;
+}
+
+size_t RingOutlierFilter::mergeRingBuffers(
+  std::vector<PointXYZI> RingBuffer::*buffer, PointCloud2 & merged_points)
+{
+  std::vector<size_t> ring_offsets(rings_.size() + 1, 0);
+  for (size_t i = 0; i < rings_.size(); ++i) {
+    ring_offsets[i + 1] = ring_offsets[i] + (rings_[i].*buffer).size() * sizeof(PointXYZI);
+  }
+  merged_points.point_step = sizeof(PointXYZI);
+  merged_points.data.resize(ring_offsets.back());
+
+  const int rings_num = static_cast<int>(rings_.size());
+#pragma omp parallel for num_threads(num_threads_)
+  for (int i = 0; i < rings_num; ++i) {
+    const auto & points = rings_[i].*buffer;
+    if (points.empty()) continue;
+    std::memcpy(
+      &merged_points.data[ring_offsets[i]], points.data(), points.size() * sizeof(PointXYZI));
+  }
+
+  return ring_offsets.back();
+}
+
+void RingOutlierFilter::setUpPointCloudFormat(
+  const PointCloud2 & input, PointCloud2 & formatted_points, size_t points_size)
+{
+  formatted_points.data.resize(points_size);
+  formatted_points.height = 1;
+  formatted_points.width =
+    static_cast<uint32_t>(formatted_points.data.size() / formatted_points.point_step);
+  formatted_points.is_bigendian = input.is_bigendian;
+  formatted_points.is_dense = input.is_dense;
+
+  sensor_msgs::PointCloud2Modifier pcd_modifier(formatted_points);
+  pcd_modifier.setPointCloud2Fields(
+    4, "x", 1, sensor_msgs::msg::PointField::FLOAT32, "y", 1,
+    sensor_msgs::msg::PointField::FLOAT32, "z", 1, sensor_msgs::msg::PointField::FLOAT32,
+    "intensity", 1, sensor_msgs::msg::PointField::FLOAT32);
+}
+}  // namespace pointcloud_preprocessor
@@ -14,14 +14,8 @@
 
 #include "pointcloud_preprocessor/outlier_filter/ring_outlier_filter_nodelet.hpp"
 
-#include "autoware_auto_geometry/common_3d.hpp"
-
-#include <sensor_msgs/point_cloud2_iterator.hpp>
-
-#include <pcl/search/pcl_search.h>
-
-#include <algorithm>
 #include <vector>
+
 namespace pointcloud_preprocessor
 {
 RingOutlierFilterComponent::RingOutlierFilterComponent(const rclcpp::NodeOptions & options)
@@ -41,17 +35,22 @@ RingOutlierFilterComponent::RingOutlierFilterComponent(const rclcpp::NodeOptions
 
   // set initial parameters
   {
-    distance_ratio_ = static_cast<double>(declare_parameter("distance_ratio", 1.03));
-    object_length_threshold_ =
+    auto & p = param_;
+    p.distance_ratio = static_cast<double>(declare_parameter("distance_ratio", 1.03));
+    p.object_length_threshold =
       static_cast<double>(declare_parameter("object_length_threshold", 0.1));
-    num_points_threshold_ = static_cast<int>(declare_parameter("num_points_threshold", 4));
-    max_rings_num_ = static_cast<uint16_t>(declare_parameter("max_rings_num", 128));
-    max_points_num_per_ring_ =
+    p.num_points_threshold = static_cast<int>(declare_parameter("num_points_threshold", 4));
+    p.max_rings_num = static_cast<uint16_t>(declare_parameter("max_rings_num", 128));
+    p.max_points_num_per_ring =
       static_cast<size_t>(declare_parameter("max_points_num_per_ring", 4000));
     publish_outlier_pointcloud_ =
       static_cast<bool>(declare_parameter("publish_outlier_pointcloud", false));
+    num_threads_ = static_cast<int>(declare_parameter("num_threads", 1));
   }
 
+  ring_outlier_filter_.set_param(param_);
+  ring_outlier_filter_.set_num_threads(num_threads_);
+
   using std::placeholders::_1;
   set_param_res_ = this->add_on_set_parameters_callback(
     std::bind(&RingOutlierFilterComponent::paramCallback, this, _1));
@@ -69,175 +68,19 @@ void RingOutlierFilterComponent::faster_filter(
   }
   stop_watch_ptr_->toc("processing_time", true);
 
-  output.point_step = sizeof(PointXYZI);
-  output.data.resize(output.point_step * input->width);
-  size_t output_size = 0;
-
-  // Set up the noise points cloud, if noise points are to be published.
-  PointCloud2 outlier_points;
-  size_t outlier_points_size = 0;
-  if (publish_outlier_pointcloud_) {
-    outlier_points.point_step = sizeof(PointXYZI);
-    outlier_points.data.resize(outlier_points.point_step * input->width);
-  }
-
-  const auto ring_offset =
-    input->fields.at(static_cast<size_t>(autoware_point_types::PointIndex::Ring)).offset;
-  const auto azimuth_offset =
-    input->fields.at(static_cast<size_t>(autoware_point_types::PointIndex::Azimuth)).offset;
-  const auto distance_offset =
-    input->fields.at(static_cast<size_t>(autoware_point_types::PointIndex::Distance)).offset;
-  const auto intensity_offset =
-    input->fields.at(static_cast<size_t>(autoware_point_types::PointIndex::Intensity)).offset;
-
-  std::vector<std::vector<size_t>> ring2indices;
-  ring2indices.reserve(max_rings_num_);
-
-  for (uint16_t i = 0; i < max_rings_num_; i++) {
-    ring2indices.push_back(std::vector<size_t>());
-    ring2indices.back().reserve(max_points_num_per_ring_);
-  }
-
-  for (size_t data_idx = 0; data_idx < input->data.size(); data_idx += input->point_step) {
-    const uint16_t ring = *reinterpret_cast<const uint16_t *>(&input->data[data_idx + ring_offset]);
-    ring2indices[ring].push_back(data_idx);
-  }
-
-  // walk range: [walk_first_idx, walk_last_idx]
-  int walk_first_idx = 0;
-  int walk_last_idx = -1;
-
-  for (const auto & indices : ring2indices) {
-    if (indices.size() < 2) continue;
-
-    walk_first_idx = 0;
-    walk_last_idx = -1;
-
-    for (size_t idx = 0U; idx < indices.size() - 1; ++idx) {
-      const size_t & current_data_idx = indices[idx];
-      const size_t & next_data_idx = indices[idx + 1];
-      walk_last_idx = idx;
-
-      // if(std::abs(iter->distance - (iter+1)->distance) <= std::sqrt(iter->distance) * 0.08)
-
-      const float & current_azimuth =
-        *reinterpret_cast<const float *>(&input->data[current_data_idx + azimuth_offset]);
-      const float & next_azimuth =
-        *reinterpret_cast<const float *>(&input->data[next_data_idx + azimuth_offset]);
-      float azimuth_diff = next_azimuth - current_azimuth;
-      azimuth_diff = azimuth_diff < 0.f ? azimuth_diff + 36000.f : azimuth_diff;
-
-      const float & current_distance =
-        *reinterpret_cast<const float *>(&input->data[current_data_idx + distance_offset]);
-      const float & next_distance =
-        *reinterpret_cast<const float *>(&input->data[next_data_idx + distance_offset]);
-
-      if (
-        std::max(current_distance, next_distance) <
-          std::min(current_distance, next_distance) * distance_ratio_ &&
-        azimuth_diff < 100.f) {
-        continue;  // Determined to be included in the same walk
-      }
-
-      if (isCluster(
-            input, std::make_pair(indices[walk_first_idx], indices[walk_last_idx]),
-            walk_last_idx - walk_first_idx + 1)) {
-        for (int i = walk_first_idx; i <= walk_last_idx; i++) {
-          auto output_ptr = reinterpret_cast<PointXYZI *>(&output.data[output_size]);
-          auto input_ptr = reinterpret_cast<const PointXYZI *>(&input->data[indices[i]]);
-
-          if (transform_info.need_transform) {
-            Eigen::Vector4f p(input_ptr->x, input_ptr->y, input_ptr->z, 1);
-            p = transform_info.eigen_transform * p;
-            output_ptr->x = p[0];
-            output_ptr->y = p[1];
-            output_ptr->z = p[2];
-          } else {
-            *output_ptr = *input_ptr;
-          }
-          const float & intensity =
-            *reinterpret_cast<const float *>(&input->data[indices[i] + intensity_offset]);
-          output_ptr->intensity = intensity;
-
-          output_size += output.point_step;
-        }
-      } else if (publish_outlier_pointcloud_) {
-        for (int i = walk_first_idx; i <= walk_last_idx; i++) {
-          auto outlier_ptr =
-            reinterpret_cast<PointXYZI *>(&outlier_points.data[outlier_points_size]);
-          auto input_ptr =
-            reinterpret_cast<const PointXYZI *>(&input->data[indices[walk_first_idx]]);
-          if (transform_info.need_transform) {
-            Eigen::Vector4f p(input_ptr->x, input_ptr->y, input_ptr->z, 1);
-            p = transform_info.eigen_transform * p;
-            outlier_ptr->x = p[0];
-            outlier_ptr->y = p[1];
-            outlier_ptr->z = p[2];
-          } else {
-            *outlier_ptr = *input_ptr;
-          }
-          const float & intensity = *reinterpret_cast<const float *>(
-            &input->data[indices[walk_first_idx] + intensity_offset]);
-          outlier_ptr->intensity = intensity;
-
-          outlier_points_size += outlier_points.point_step;
-        }
-      }
-
-      walk_first_idx = idx + 1;
-    }
-
-    if (walk_first_idx > walk_last_idx) continue;
-
-    if (isCluster(
-          input, std::make_pair(indices[walk_first_idx], indices[walk_last_idx]),
-          walk_last_idx - walk_first_idx + 1)) {
-      for (int i = walk_first_idx; i <= walk_last_idx; i++) {
-        auto output_ptr = reinterpret_cast<PointXYZI *>(&output.data[output_size]);
-        auto input_ptr = reinterpret_cast<const PointXYZI *>(&input->data[indices[i]]);
-
-        if (transform_info.need_transform) {
-          Eigen::Vector4f p(input_ptr->x, input_ptr->y, input_ptr->z, 1);
-          p = transform_info.eigen_transform * p;
-          output_ptr->x = p[0];
-          output_ptr->y = p[1];
-          output_ptr->z = p[2];
-        } else {
-          *output_ptr = *input_ptr;
-        }
-        const float & intensity =
-          *reinterpret_cast<const float *>(&input->data[indices[i] + intensity_offset]);
-        output_ptr->intensity = intensity;
-
-        output_size += output.point_step;
-      }
-    } else if (publish_outlier_pointcloud_) {
-      for (int i = walk_first_idx; i < walk_last_idx; i++) {
-        auto outlier_ptr = reinterpret_cast<PointXYZI *>(&outlier_points.data[outlier_points_size]);
-        auto input_ptr = reinterpret_cast<const PointXYZI *>(&input->data[indices[i]]);
-        if (transform_info.need_transform) {
-          Eigen::Vector4f p(input_ptr->x, input_ptr->y, input_ptr->z, 1);
-          p = transform_info.eigen_transform * p;
-          outlier_ptr->x = p[0];
-          outlier_ptr->y = p[1];
-          outlier_ptr->z = p[2];
-        } else {
-          *outlier_ptr = *input_ptr;
-        }
-        const float & intensity =
-          *reinterpret_cast<const float *>(&input->data[indices[i] + intensity_offset]);
-        outlier_ptr->intensity = intensity;
-        outlier_points_size += outlier_points.point_step;
-      }
-    }
-  }
-
-  setUpPointCloudFormat(input, output, output_size, /*num_fields=*/4);
+  // Note that `input->header.frame_id` is data before converted when `transform_info.need_transform
+  // == true`
+  const auto & frame_id = !tf_input_frame_.empty() ? tf_input_frame_ : tf_input_orig_frame_;
 
   if (publish_outlier_pointcloud_) {
-    setUpPointCloudFormat(input, outlier_points, outlier_points_size, /*num_fields=*/4);
+    PointCloud2 outlier_points;
+    ring_outlier_filter_.filter(*input, output, transform_info, &outlier_points);
+    outlier_points.header.frame_id = frame_id;
     outlier_pointcloud_publisher_->publish(outlier_points);
+  } else {
+    ring_outlier_filter_.filter(*input, output, transform_info);
   }
+  output.header.frame_id = frame_id;
 
   // add processing time for debug
   if (debug_publisher_) {
@@ -274,16 +117,19 @@ rcl_interfaces::msg::SetParametersResult RingOutlierFilterComponent::paramCallba
 {
   std::scoped_lock lock(mutex_);
 
-  if (get_param(p, "distance_ratio", distance_ratio_)) {
-    RCLCPP_DEBUG(get_logger(), "Setting new distance ratio to: %f.", distance_ratio_);
+  if (get_param(p, "distance_ratio", param_.distance_ratio)) {
+    RCLCPP_DEBUG(get_logger(), "Setting new distance ratio to: %f.", param_.distance_ratio);
   }
-  if (get_param(p, "object_length_threshold", object_length_threshold_)) {
+  if (get_param(p, "object_length_threshold", param_.object_length_threshold)) {
     RCLCPP_DEBUG(
-      get_logger(), "Setting new object length threshold to: %f.", object_length_threshold_);
+      get_logger(), "Setting new object length threshold to: %f.",
+      param_.object_length_threshold);
   }
-  if (get_param(p, "num_points_threshold", num_points_threshold_)) {
-    RCLCPP_DEBUG(get_logger(), "Setting new num_points_threshold to: %d.", num_points_threshold_);
+  if (get_param(p, "num_points_threshold", param_.num_points_threshold)) {
+    RCLCPP_DEBUG(
+      get_logger(), "Setting new num_points_threshold to: %d.", param_.num_points_threshold);
   }
+  ring_outlier_filter_.set_param(param_);
   if (get_param(p, "publish_outlier_pointcloud", publish_outlier_pointcloud_)) {
     RCLCPP_DEBUG(
       get_logger(), "Setting new publish_outlier_pointcloud to: %d.", publish_outlier_pointcloud_);
@@ -296,29 +142,6 @@ rcl_interfaces::msg::SetParametersResult RingOutlierFilterComponent::paramCallba
   return result;
 }
 
-void RingOutlierFilterComponent::setUpPointCloudFormat(
-  const PointCloud2ConstPtr & input, PointCloud2 & formatted_points, size_t points_size,
-  size_t num_fields)
-{
-  formatted_points.data.resize(points_size);
-  // Note that `input->header.frame_id` is data before converted when `transform_info.need_transform
-  // == true`
-  formatted_points.header.frame_id =
-    !tf_input_frame_.empty() ? tf_input_frame_ : tf_input_orig_frame_;
-  formatted_points.data.resize(formatted_points.point_step * input->width);
-  formatted_points.height = 1;
-  formatted_points.width =
-    static_cast<uint32_t>(formatted_points.data.size() / formatted_points.point_step);
-  formatted_points.is_bigendian = input->is_bigendian;
-  formatted_points.is_dense = input->is_dense;
-
-  sensor_msgs::PointCloud2Modifier pcd_modifier(formatted_points);
-  pcd_modifier.setPointCloud2Fields(
-    num_fields, "x", 1, sensor_msgs::msg::PointField::FLOAT32, "y", 1,
-    sensor_msgs::msg::PointField::FLOAT32, "z", 1, sensor_msgs::msg::PointField::FLOAT32,
-    "intensity", 1, sensor_msgs::msg::PointField::FLOAT32);
-}
-
 }  // namespace pointcloud_preprocessor
 
 #include <rclcpp_components/register_node_macro.hpp>
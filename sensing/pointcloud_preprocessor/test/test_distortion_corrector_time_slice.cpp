@@ -0,0 +1,165 @@
+// Copyright 2024 TIER IV, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "pointcloud_preprocessor/distortion_corrector/distortion_corrector.hpp"
+
+#include <sensor_msgs/point_cloud2_iterator.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <memory>
+#include <string>
+
+namespace pointcloud_preprocessor
+{
+
+constexpr double velocity = 10.0;            // [m/s]
+constexpr double angular_velocity = 0.5;     // [rad/s]
+constexpr double first_point_stamp = 100.0;  // [s]
+constexpr double point_interval = 0.001;     // [s]
+constexpr double max_point_range = 20.0;     // [m]
+constexpr size_t point_num = 100;
+
+class DistortionCorrectorTest : public ::testing::Test
+{
+protected:
+  void SetUp() override { rclcpp::init(0, nullptr); }
+
+  void TearDown() override { rclcpp::shutdown(); }
+
+  // Points around the sensor, one every point_interval, in scan order
+  static PointCloud2 make_points(const std::string & frame_id)
+  {
+    PointCloud2 points;
+    points.header.frame_id = frame_id;
+    points.header.stamp = rclcpp::Time(static_cast<int64_t>(first_point_stamp * 1e9));
+    sensor_msgs::PointCloud2Modifier modifier(points);
+    modifier.setPointCloud2Fields(
+      4, "x", 1, sensor_msgs::msg::PointField::FLOAT32, "y", 1,
+      sensor_msgs::msg::PointField::FLOAT32, "z", 1, sensor_msgs::msg::PointField::FLOAT32,
+      "time_stamp", 1, sensor_msgs::msg::PointField::FLOAT64);
+    modifier.resize(point_num);
+
+    sensor_msgs::PointCloud2Iterator<float> it_x(points, "x");
+    sensor_msgs::PointCloud2Iterator<float> it_y(points, "y");
+    sensor_msgs::PointCloud2Iterator<float> it_z(points, "z");
+    sensor_msgs::PointCloud2Iterator<double> it_time_stamp(points, "time_stamp");
+    for (size_t i = 0; i < point_num; ++i, ++it_x, ++it_y, ++it_z, ++it_time_stamp) {
+      const double azimuth = 2.0 * M_PI * i / point_num;
+      const double range = max_point_range * (0.25 + 0.75 * (i % 7) / 6.0);
+      *it_x = static_cast<float>(range * std::cos(azimuth));
+      *it_y = static_cast<float>(range * std::sin(azimuth));
+      *it_z = static_cast<float>(0.1 * (i % 5));
+      *it_time_stamp = first_point_stamp + point_interval * i;
+    }
+    return points;
+  }
+
+  // Undistort the points with the time slice mode, or with the per-point correction for 0.0
+  static PointCloud2 undistort(
+    const PointCloud2 & points, const tf2::Transform & tf2_base_link_to_sensor,
+    const double time_slice_sec)
+  {
+    rclcpp::NodeOptions node_options;
+    node_options.append_parameter_override("use_imu", false);
+    node_options.append_parameter_override("time_slice_sec", time_slice_sec);
+    DistortionCorrectorComponent distortion_corrector(node_options);
+
+    // constant twist covering the scan
+    for (int i = -5; i <= 15; ++i) {
+      auto twist_msg = std::make_shared<geometry_msgs::msg::TwistWithCovarianceStamped>();
+      twist_msg->header.frame_id = "base_link";
+      twist_msg->header.stamp =
+        rclcpp::Time(static_cast<int64_t>((first_point_stamp + 0.01 * i) * 1e9));
+      twist_msg->twist.twist.linear.x = velocity;
+      twist_msg->twist.twist.angular.z = angular_velocity;
+      distortion_corrector.onTwistWithCovarianceStamped(twist_msg);
+    }
+
+    PointCloud2 undistorted_points = points;
+    EXPECT_TRUE(
+      distortion_corrector.undistortPointCloud(tf2_base_link_to_sensor, undistorted_points));
+    return undistorted_points;
+  }
+
+  static void expect_near_points(
+    const PointCloud2 & points, const PointCloud2 & expected_points, const double tolerance)
+  {
+    sensor_msgs::PointCloud2ConstIterator<float> it_x(points, "x");
+    sensor_msgs::PointCloud2ConstIterator<float> it_y(points, "y");
+    sensor_msgs::PointCloud2ConstIterator<float> it_z(points, "z");
+    sensor_msgs::PointCloud2ConstIterator<float> it_expected_x(expected_points, "x");
+    sensor_msgs::PointCloud2ConstIterator<float> it_expected_y(expected_points, "y");
+    sensor_msgs::PointCloud2ConstIterator<float> it_expected_z(expected_points, "z");
+    for (; it_x != it_x.end();
+         ++it_x, ++it_y, ++it_z, ++it_expected_x, ++it_expected_y, ++it_expected_z) {
+      EXPECT_NEAR(*it_x, *it_expected_x, tolerance);
+      EXPECT_NEAR(*it_y, *it_expected_y, tolerance);
+      EXPECT_NEAR(*it_z, *it_expected_z, tolerance);
+    }
+  }
+
+  static tf2::Transform make_base_link_to_sensor()
+  {
+    tf2::Transform tf2_base_link_to_sensor;
+    tf2_base_link_to_sensor.setOrigin(tf2::Vector3(-1.0, 0.2, -2.0));
+    tf2::Quaternion rotation;
+    rotation.setRPY(0.0, 0.0, 0.3);
+    tf2_base_link_to_sensor.setRotation(rotation);
+    return tf2_base_link_to_sensor;
+  }
+};
+
+TEST_F(DistortionCorrectorTest, TimeSlicesOfPointIntervalMatchPerPointCorrection)
+{
+  // With one slice per point, the ego motion is integrated at the same times as per point
+  const auto points = make_points("base_link");
+  const auto expected_points = undistort(points, tf2::Transform::getIdentity(), 0.0);
+  const auto undistorted_points = undistort(points, tf2::Transform::getIdentity(), point_interval);
+  expect_near_points(undistorted_points, expected_points, 1e-4);
+}
+
+TEST_F(DistortionCorrectorTest, TimeSlicesInSensorFrameMatchPerPointCorrection)
+{
+  const auto points = make_points("sensor");
+  const auto tf2_base_link_to_sensor = make_base_link_to_sensor();
+  const auto expected_points = undistort(points, tf2_base_link_to_sensor, 0.0);
+  const auto undistorted_points = undistort(points, tf2_base_link_to_sensor, point_interval);
+  expect_near_points(undistorted_points, expected_points, 1e-4);
+}
+
+TEST_F(DistortionCorrectorTest, TimeSliceErrorIsBoundedByHalfASlice)
+{
+  // The points are snapped to the nearest slice boundary, so they are off by at most the motion
+  // of half a slice
+  const double time_slice_sec = 10 * point_interval;
+  const auto points = make_points("sensor");
+  const auto tf2_base_link_to_sensor = make_base_link_to_sensor();
+  const auto expected_points = undistort(points, tf2_base_link_to_sensor, 0.0);
+  const auto undistorted_points = undistort(points, tf2_base_link_to_sensor, time_slice_sec);
+
+  const double sensor_range = max_point_range + 3.0;
+  const double max_error =
+    0.5 * time_slice_sec * (velocity + angular_velocity * sensor_range) + 1e-4;
+  expect_near_points(undistorted_points, expected_points, max_error);
+}
+
+}  // namespace pointcloud_preprocessor
+
+int main(int argc, char ** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
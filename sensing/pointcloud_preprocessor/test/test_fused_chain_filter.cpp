@@ -0,0 +1,165 @@
+// Copyright 2024 TIER IV, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "pointcloud_preprocessor/crop_box_filter/crop_box_filter_nodelet.hpp"
+#include "pointcloud_preprocessor/fused_chain_filter/fused_chain_filter_nodelet.hpp"
+#include "pointcloud_preprocessor/outlier_filter/ring_outlier_filter_nodelet.hpp"
+
+#include <pcl_conversions/pcl_conversions.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace pointcloud_preprocessor
+{
+
+constexpr uint16_t rings_num = 16;
+constexpr int points_num_per_ring = 900;
+
+// expose the filter functions for test code
+class CropBoxFilterTestComponent : public CropBoxFilterComponent
+{
+public:
+  using CropBoxFilterComponent::CropBoxFilterComponent;
+  using CropBoxFilterComponent::faster_filter;
+};
+
+class RingOutlierFilterTestComponent : public RingOutlierFilterComponent
+{
+public:
+  using RingOutlierFilterComponent::faster_filter;
+  using RingOutlierFilterComponent::RingOutlierFilterComponent;
+};
+
+class FusedChainFilterTestComponent : public FusedChainFilterComponent
+{
+public:
+  using FusedChainFilterComponent::FusedChainFilterComponent;
+  using FusedChainFilterComponent::faster_filter;
+};
+
+class FusedChainFilterTest : public ::testing::Test
+{
+protected:
+  void SetUp() override { rclcpp::init(0, nullptr); }
+
+  void TearDown() override { rclcpp::shutdown(); }
+
+  // A scan in firing order, ring after ring at each azimuth. The range alternates between walls
+  // and objects of a few points, with isolated noise points and points without a return.
+  static PointCloud2::ConstSharedPtr make_points()
+  {
+    pcl::PointCloud<autoware_point_types::PointXYZIRADRT> points;
+    for (int i = 0; i < points_num_per_ring; ++i) {
+      for (uint16_t ring = 0; ring < rings_num; ++ring) {
+        autoware_point_types::PointXYZIRADRT point;
+        const float azimuth = 40.0f * i;  // [0.01 deg]
+        float distance = 8.0f + 4.0f * ((i / 60 + ring / 4) % 4);
+        if ((i * 7 + ring * 3) % 97 == 0) {
+          distance *= 1.5f;  // isolated noise
+        } else if ((i / 5 + ring) % 11 == 0) {
+          distance = 6.0f;  // short object
+        }
+        const float elevation = (static_cast<float>(ring) - 8.0f) * 0.02f;
+        const float azimuth_rad = azimuth * static_cast<float>(M_PI) / 18000.0f;
+        point.x = distance * std::cos(elevation) * std::cos(azimuth_rad);
+        point.y = distance * std::cos(elevation) * std::sin(azimuth_rad);
+        point.z = distance * std::sin(elevation);
+        if ((i + ring) % 53 == 0) {
+          point.x = std::numeric_limits<float>::quiet_NaN();
+        }
+        point.intensity = static_cast<float>((i + ring) % 256);
+        point.ring = ring;
+        point.azimuth = azimuth;
+        point.distance = distance;
+        point.return_type = autoware_point_types::ReturnType::SINGLE_STRONGEST;
+        point.time_stamp = 1e-5 * (i * rings_num + ring);
+        points.push_back(point);
+      }
+    }
+    auto points_msg = std::make_shared<PointCloud2>();
+    pcl::toROSMsg(points, *points_msg);
+    points_msg->header.frame_id = "lidar";
+    return points_msg;
+  }
+
+  static rclcpp::NodeOptions make_node_options(const std::string & prefix)
+  {
+    rclcpp::NodeOptions node_options;
+    node_options.append_parameter_override("input_frame", "base_link");
+    node_options.append_parameter_override(prefix + "min_x", -14.0);
+    node_options.append_parameter_override(prefix + "max_x", 18.0);
+    node_options.append_parameter_override(prefix + "min_y", -15.0);
+    node_options.append_parameter_override(prefix + "max_y", 13.0);
+    node_options.append_parameter_override(prefix + "min_z", -3.0);
+    node_options.append_parameter_override(prefix + "max_z", 3.0);
+    return node_options;
+  }
+
+  static TransformInfo make_transform_info()
+  {
+    TransformInfo transform_info;
+    transform_info.eigen_transform.block<3, 3>(0, 0) =
+      Eigen::AngleAxisf(0.3f, Eigen::Vector3f::UnitZ()).toRotationMatrix();
+    transform_info.eigen_transform.block<3, 1>(0, 3) = Eigen::Vector3f(1.2f, -0.4f, 1.8f);
+    transform_info.need_transform = true;
+    return transform_info;
+  }
+};
+
+TEST_F(FusedChainFilterTest, CropBoxAndRingOutlierMatchStandaloneFilters)
+{
+  const auto input = make_points();
+
+  CropBoxFilterTestComponent crop_box_filter(make_node_options(""));
+  rclcpp::NodeOptions ring_outlier_node_options;
+  ring_outlier_node_options.append_parameter_override("input_frame", "base_link");
+  // the output does not depend on the number of threads
+  ring_outlier_node_options.append_parameter_override("num_threads", 4);
+  RingOutlierFilterTestComponent ring_outlier_filter(ring_outlier_node_options);
+  FusedChainFilterTestComponent fused_chain_filter(make_node_options("crop_box."));
+
+  for (const auto & transform_info : {TransformInfo(), make_transform_info()}) {
+    auto cropped = std::make_shared<PointCloud2>();
+    crop_box_filter.faster_filter(input, nullptr, *cropped, transform_info);
+    // the cropped points are already in the input frame of the ring outlier filter
+    PointCloud2 expected;
+    ring_outlier_filter.faster_filter(cropped, nullptr, expected, TransformInfo());
+
+    PointCloud2 output;
+    fused_chain_filter.faster_filter(input, nullptr, output, transform_info);
+
+    // both stages remove some points
+    EXPECT_LT(cropped->width, input->width);
+    EXPECT_GT(expected.width, 0u);
+    EXPECT_LT(expected.width, cropped->width);
+
+    EXPECT_EQ(output.header.frame_id, expected.header.frame_id);
+    EXPECT_EQ(output.height, expected.height);
+    EXPECT_EQ(output.width, expected.width);
+    EXPECT_EQ(output.fields, expected.fields);
+    EXPECT_EQ(output.point_step, expected.point_step);
+    EXPECT_EQ(output.row_step, expected.row_step);
+    EXPECT_EQ(output.is_dense, expected.is_dense);
+    EXPECT_EQ(output.data, expected.data);
+  }
+}
+
+}  // namespace pointcloud_preprocessor